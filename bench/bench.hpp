@@ -0,0 +1,241 @@
+#pragma once
+
+// A minimal microbenchmark harness in the style of test.hpp.  Each
+// BENCHMARK(name) body calls runner.measure(label, fn) for each
+// kernel it measures, where fn(i) performs one operation on input i
+// and returns its result (to keep the operation from being optimized
+// away).
+//
+// For stable numbers, each measurement:
+//   1. calibrates the number of operations per repetition so that a
+//      repetition takes at least --min-time,
+//   2. runs --warmup untimed repetitions, then
+//   3. runs --reps timed repetitions, and reports the median, minimum
+//      and median absolute deviation of the time per operation.
+// On Linux the process is pinned to a single CPU (--cpu) to avoid
+// migrations between cores.
+//
+// With --output=FILE, each measurement is appended to FILE as a line
+// of JSON containing the time per operation of every repetition, for
+// later comparison between builds.
+
+#include "json_writer.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+int main(int argc, char *argv[]);
+
+namespace bench {
+    using Clock = std::chrono::steady_clock;
+
+    // Forces the compiler to materialize value, without generating
+    // any code for it.
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    using mpt_bench::jsonEscape;
+
+    struct Options {
+        unsigned warmup{3};
+        unsigned repetitions{15};
+        std::chrono::milliseconds minTime{20};
+        int cpu{-2}; // -2 = current cpu, -1 = do not pin
+        std::string filter;
+        std::string output;
+        std::string label;
+    };
+
+    class Runner {
+        const Options& options_;
+        const std::string& benchmark_;
+        std::ofstream *json_;
+
+        template <typename Fn>
+        static double time(Fn& fn, std::size_t n) {
+            Clock::time_point start = Clock::now();
+            for (std::size_t i=0 ; i<n ; ++i)
+                doNotOptimize(fn(i));
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+
+        static std::string formatTime(double ns) {
+            static const char *units[] = { "ns", "us", "ms", "s" };
+            unsigned u = 0;
+            for ( ; u < 3 && ns >= 1000 ; ++u)
+                ns /= 1000;
+            std::ostringstream str;
+            str << std::fixed << std::setprecision(3) << ns << ' ' << units[u];
+            return str.str();
+        }
+
+        static double median(std::vector<double> v) {
+            std::nth_element(v.begin(), v.begin() + v.size()/2, v.end());
+            return v[v.size()/2];
+        }
+
+    public:
+        Runner(const Options& options, const std::string& benchmark, std::ofstream *json)
+            : options_(options)
+            , benchmark_(benchmark)
+            , json_(json)
+        {
+        }
+
+        template <typename Fn>
+        void measure(const std::string& label, Fn&& fn) {
+            std::string name = benchmark_ + "/" + label;
+            if (name.find(options_.filter) == std::string::npos)
+                return;
+
+            double minTime = std::chrono::duration<double, std::nano>(options_.minTime).count();
+            std::size_t n = 1;
+            while (time(fn, n) < minTime && n < (std::size_t(1) << 40))
+                n *= 2;
+
+            for (unsigned i=0 ; i<options_.warmup ; ++i)
+                time(fn, n);
+
+            std::vector<double> nsPerOp;
+            nsPerOp.reserve(options_.repetitions);
+            for (unsigned i=0 ; i<options_.repetitions ; ++i)
+                nsPerOp.push_back(time(fn, n) / n);
+
+            double med = median(nsPerOp);
+            std::vector<double> dev;
+            dev.reserve(nsPerOp.size());
+            for (double t : nsPerOp)
+                dev.push_back(std::abs(t - med));
+            double mad = median(dev);
+
+            std::ostringstream msg;
+            msg << std::left << std::setw(44) << name << std::right
+                << std::setw(14) << formatTime(med)
+                << std::setw(14) << formatTime(*std::min_element(nsPerOp.begin(), nsPerOp.end())) << " min"
+                << std::fixed << std::setprecision(1)
+                << std::setw(7) << 100 * mad / med << "% mad"
+                << std::setprecision(0)
+                << std::setw(14) << 1e9 / med << " ops/s\n";
+            std::cout << msg.str() << std::flush;
+
+            if (json_) {
+                *json_ << "{\"label\":\"" << jsonEscape(options_.label)
+                       << "\",\"name\":\"" << jsonEscape(name)
+                       << "\",\"ops_per_rep\":" << n
+                       << ",\"ns_per_op\":[";
+                for (std::size_t i=0 ; i<nsPerOp.size() ; ++i)
+                    *json_ << (i ? "," : "") << nsPerOp[i];
+                *json_ << "]}\n";
+            }
+        }
+    };
+
+    class Benchmark {
+        static auto& benchmarks() {
+            static std::vector<Benchmark*> list;
+            return list;
+        }
+
+        std::string name_;
+    public:
+        Benchmark(const std::string& name) : name_(name) {
+            benchmarks().push_back(this);
+        }
+        virtual ~Benchmark() {}
+        virtual void run_benchmark(Runner& runner) = 0;
+        friend int ::main(int, char*argv[]);
+    };
+
+    inline void pinCpu(int& cpu) {
+#ifdef __linux__
+        if (cpu == -2)
+            cpu = sched_getcpu();
+        if (cpu < 0)
+            return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "failed to pin to cpu " << cpu << ": " << std::strerror(errno) << std::endl;
+            cpu = -1;
+        }
+#else
+        cpu = -1;
+#endif
+    }
+}
+
+#define BENCHMARK(name)                                                 \
+    struct benchmark_ ## name : public ::bench::Benchmark {             \
+        benchmark_ ## name () : Benchmark(#name) {}                     \
+        virtual void run_benchmark(::bench::Runner& runner) override;   \
+    };                                                                  \
+    benchmark_ ## name benchmark_instance_ ## name;                     \
+    void benchmark_ ## name :: run_benchmark(::bench::Runner& runner)
+
+int main(int argc, char *argv[]) {
+    using namespace bench;
+
+    Options options;
+    for (int i=1 ; i<argc ; ++i) {
+        std::string arg(argv[i]);
+        std::size_t eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq+1);
+        if (key == "--warmup")
+            options.warmup = std::stoul(value);
+        else if (key == "--reps")
+            options.repetitions = std::max(1ul, std::stoul(value));
+        else if (key == "--min-time")
+            options.minTime = std::chrono::milliseconds(std::stoul(value));
+        else if (key == "--cpu")
+            options.cpu = std::stoi(value);
+        else if (key == "--filter")
+            options.filter = value;
+        else if (key == "--output")
+            options.output = value;
+        else if (key == "--label")
+            options.label = value;
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--warmup=N] [--reps=N] [--min-time=MS]"
+                " [--cpu=N] [--filter=SUBSTRING] [--output=FILE] [--label=LABEL]\n";
+            return 1;
+        }
+    }
+
+    pinCpu(options.cpu);
+    std::cout << "# " << options.repetitions << " reps of >= " << options.minTime.count()
+              << " ms after " << options.warmup << " warmup reps, "
+              << (options.cpu < 0 ? std::string("not pinned") : "pinned to cpu " + std::to_string(options.cpu))
+              << std::endl;
+
+    std::ofstream json;
+    if (!options.output.empty()) {
+        json.open(options.output, std::ios::app);
+        if (!json) {
+            std::cerr << "failed to open " << options.output << std::endl;
+            return 1;
+        }
+    }
+
+    for (Benchmark *benchmark : Benchmark::benchmarks()) {
+        Runner runner(options, benchmark->name_, json.is_open() ? &json : nullptr);
+        benchmark->run_benchmark(runner);
+    }
+
+    return 0;
+}
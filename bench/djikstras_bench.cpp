@@ -0,0 +1,120 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#include <mpt/impl/djikstras.hpp>
+#include <forward_list>
+#include <random>
+#include "bench.hpp"
+
+// Measures a full shortest path search on synthetic graphs: grids
+// (long paths, low degree), and random graphs with the degree of the
+// PRM graphs the planners build.
+
+namespace mpt_bench {
+    struct Vertex {
+        std::size_t id_;
+        std::forward_list<std::pair<double, Vertex*>> edges_;
+
+        explicit Vertex(std::size_t id) : id_(id) {}
+
+        void addEdge(double w, Vertex& v) {
+            edges_.emplace_front(w, &v);
+            v.edges_.emplace_front(w, this);
+        }
+    };
+
+    void benchGraph(bench::Runner& runner, const std::string& name, std::vector<Vertex>& graph) {
+        Vertex *start = &graph.front();
+        Vertex *goal = &graph.back();
+        runner.measure(name, [&] (std::size_t) {
+            return unc::robotics::mpt::impl::djikstras<Vertex*, double>(
+                start,
+                [&] (const Vertex *v) { return v == goal; },
+                [&] (const Vertex *v, auto callback) {
+                    for (auto [w, u] : v->edges_)
+                        callback(w, u);
+                },
+                [&] (std::size_t n, auto, auto) { return n; });
+        });
+    }
+
+    std::vector<Vertex> gridGraph(std::size_t n) {
+        std::mt19937_64 rng(1);
+        std::uniform_real_distribution<double> weight(1.0, 2.0);
+        std::vector<Vertex> graph;
+        graph.reserve(n*n);
+        for (std::size_t i=0 ; i<n*n ; ++i)
+            graph.emplace_back(i);
+        for (std::size_t y=0 ; y<n ; ++y) {
+            for (std::size_t x=0 ; x<n ; ++x) {
+                if (x+1 < n) graph[y*n + x].addEdge(weight(rng), graph[y*n + x + 1]);
+                if (y+1 < n) graph[y*n + x].addEdge(weight(rng), graph[(y+1)*n + x]);
+            }
+        }
+        return graph;
+    }
+
+    std::vector<Vertex> randomGraph(std::size_t n, std::size_t degree) {
+        std::mt19937_64 rng(1);
+        std::uniform_real_distribution<double> weight(1.0, 2.0);
+        std::uniform_int_distribution<std::size_t> vertex(0, n-1);
+        std::vector<Vertex> graph;
+        graph.reserve(n);
+        for (std::size_t i=0 ; i<n ; ++i)
+            graph.emplace_back(i);
+        // a path through all vertices ensures the goal is reachable
+        for (std::size_t i=1 ; i<n ; ++i)
+            graph[i-1].addEdge(n * 2.0, graph[i]);
+        for (std::size_t i=0 ; i<n*degree/2 ; ++i)
+            graph[vertex(rng)].addEdge(weight(rng), graph[vertex(rng)]);
+        return graph;
+    }
+}
+
+using namespace mpt_bench;
+
+BENCHMARK(djikstras_grid) {
+    for (std::size_t n : { 32, 256 }) {
+        std::vector<Vertex> graph = gridGraph(n);
+        benchGraph(runner, std::to_string(n) + "x" + std::to_string(n), graph);
+    }
+}
+
+BENCHMARK(djikstras_random) {
+    for (std::size_t n : { 1000, 100000 }) {
+        std::vector<Vertex> graph = randomGraph(n, 16);
+        benchGraph(runner, "n=" + std::to_string(n) + ",degree=16", graph);
+    }
+}
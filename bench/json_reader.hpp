@@ -0,0 +1,251 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_BENCH_JSON_READER_HPP
+#define MPT_BENCH_JSON_READER_HPP
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A minimal JSON reader for the benchmark results files.  It supports
+// all of JSON except unicode escapes outside the basic multilingual
+// plane (surrogate pairs), which the benchmarks do not produce.
+
+namespace mpt_bench::json {
+    class Value {
+    public:
+        enum Type { kNull, kBool, kNumber, kString, kArray, kObject };
+
+    private:
+        Type type_{kNull};
+        bool bool_{false};
+        double number_{0};
+        std::string string_;
+        std::vector<Value> array_;
+        std::map<std::string, Value> object_;
+
+        friend class Parser;
+
+    public:
+        Type type() const { return type_; }
+        bool isNull() const { return type_ == kNull; }
+        bool isNumber() const { return type_ == kNumber; }
+        bool isString() const { return type_ == kString; }
+        bool isArray() const { return type_ == kArray; }
+        bool isObject() const { return type_ == kObject; }
+
+        bool boolean() const { return bool_; }
+        double number() const { return number_; }
+        const std::string& string() const { return string_; }
+        const std::vector<Value>& array() const { return array_; }
+
+        bool has(const std::string& key) const {
+            return object_.count(key) != 0;
+        }
+
+        // Returns the member with the given key, or a null value if
+        // there is no such member.
+        const Value& operator[] (const std::string& key) const {
+            static const Value null;
+            auto it = object_.find(key);
+            return it == object_.end() ? null : it->second;
+        }
+    };
+
+    class Parser {
+        const std::string& text_;
+        std::size_t pos_{0};
+
+        [[noreturn]] void fail(const std::string& what) const {
+            throw std::invalid_argument(what + " at offset " + std::to_string(pos_));
+        }
+
+        void skipSpace() {
+            while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])))
+                ++pos_;
+        }
+
+        bool consume(char c) {
+            skipSpace();
+            if (pos_ < text_.size() && text_[pos_] == c) {
+                ++pos_;
+                return true;
+            }
+            return false;
+        }
+
+        void expect(char c) {
+            if (!consume(c))
+                fail(std::string("expected '") + c + "'");
+        }
+
+        bool consumeWord(const char *word) {
+            std::size_t n = std::char_traits<char>::length(word);
+            if (text_.compare(pos_, n, word) != 0)
+                return false;
+            pos_ += n;
+            return true;
+        }
+
+        // Appends the code point of a "\uXXXX" escape (following the
+        // 'u') to s in UTF-8.
+        void parseUnicodeEscape(std::string& s) {
+            if (pos_ + 4 > text_.size())
+                fail("unterminated unicode escape");
+            unsigned cp = 0;
+            for (int i = 0 ; i < 4 ; ++i) {
+                char c = text_[pos_++];
+                if (!std::isxdigit(static_cast<unsigned char>(c)))
+                    fail("invalid unicode escape");
+                cp = cp * 16 + (std::isdigit(static_cast<unsigned char>(c))
+                                ? c - '0' : (std::tolower(c) - 'a' + 10));
+            }
+            if (cp >= 0xd800 && cp < 0xe000)
+                fail("surrogate pairs are not supported");
+            if (cp < 0x80) {
+                s += static_cast<char>(cp);
+            } else if (cp < 0x800) {
+                s += static_cast<char>(0xc0 | (cp >> 6));
+                s += static_cast<char>(0x80 | (cp & 0x3f));
+            } else {
+                s += static_cast<char>(0xe0 | (cp >> 12));
+                s += static_cast<char>(0x80 | ((cp >> 6) & 0x3f));
+                s += static_cast<char>(0x80 | (cp & 0x3f));
+            }
+        }
+
+        std::string parseString() {
+            expect('"');
+            std::string s;
+            for (;;) {
+                if (pos_ >= text_.size())
+                    fail("unterminated string");
+                char c = text_[pos_++];
+                if (c == '"')
+                    return s;
+                if (c != '\\') {
+                    s += c;
+                    continue;
+                }
+                if (pos_ >= text_.size())
+                    fail("unterminated string");
+                switch (c = text_[pos_++]) {
+                case 'n': s += '\n'; break;
+                case 't': s += '\t'; break;
+                case 'r': s += '\r'; break;
+                case 'b': s += '\b'; break;
+                case 'f': s += '\f'; break;
+                case 'u': parseUnicodeEscape(s); break;
+                default: s += c; break;
+                }
+            }
+        }
+
+    public:
+        explicit Parser(const std::string& text) : text_(text) {}
+
+        Value parse() {
+            Value v;
+            skipSpace();
+            if (pos_ >= text_.size())
+                fail("unexpected end of input");
+
+            char c = text_[pos_];
+            if (c == '{') {
+                ++pos_;
+                v.type_ = Value::kObject;
+                if (!consume('}')) {
+                    do {
+                        skipSpace();
+                        std::string key = parseString();
+                        expect(':');
+                        v.object_[key] = parse();
+                    } while (consume(','));
+                    expect('}');
+                }
+            } else if (c == '[') {
+                ++pos_;
+                v.type_ = Value::kArray;
+                if (!consume(']')) {
+                    do {
+                        v.array_.push_back(parse());
+                    } while (consume(','));
+                    expect(']');
+                }
+            } else if (c == '"') {
+                v.type_ = Value::kString;
+                v.string_ = parseString();
+            } else if (consumeWord("null")) {
+                v.type_ = Value::kNull;
+            } else if (consumeWord("true")) {
+                v.type_ = Value::kBool;
+                v.bool_ = true;
+            } else if (consumeWord("false")) {
+                v.type_ = Value::kBool;
+                v.bool_ = false;
+            } else {
+                const char *begin = text_.c_str() + pos_;
+                char *end;
+                v.type_ = Value::kNumber;
+                v.number_ = std::strtod(begin, &end);
+                if (end == begin)
+                    fail("invalid value");
+                pos_ += end - begin;
+            }
+            return v;
+        }
+
+        bool atEnd() {
+            skipSpace();
+            return pos_ == text_.size();
+        }
+    };
+
+    inline Value parse(const std::string& text) {
+        Parser parser(text);
+        Value v = parser.parse();
+        if (!parser.atEnd())
+            throw std::invalid_argument("trailing characters after JSON value");
+        return v;
+    }
+}
+
+#endif
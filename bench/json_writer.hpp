@@ -0,0 +1,73 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_BENCH_JSON_WRITER_HPP
+#define MPT_BENCH_JSON_WRITER_HPP
+
+#include <ostream>
+#include <string>
+
+// Helpers for writing the benchmark results files, shared by the
+// microbenchmarks and the planner benchmarks in demo/.
+
+namespace mpt_bench {
+    // Stream manipulator that writes a string's contents escaped for
+    // use inside a JSON string literal, e.g.
+    //
+    //    out << "{\"name\":\"" << jsonEscape(name) << "\"}";
+    struct JsonEscaped {
+        const std::string& str;
+    };
+
+    inline JsonEscaped jsonEscape(const std::string& str) {
+        return JsonEscaped{str};
+    }
+
+    inline std::ostream& operator << (std::ostream& out, const JsonEscaped& e) {
+        static const char hex[] = "0123456789abcdef";
+        for (char c : e.str) {
+            if (c == '"' || c == '\\')
+                out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20)
+                out << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+            else
+                out << c;
+        }
+        return out;
+    }
+}
+
+#endif
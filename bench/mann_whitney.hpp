@@ -0,0 +1,128 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_BENCH_MANN_WHITNEY_HPP
+#define MPT_BENCH_MANN_WHITNEY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace mpt_bench {
+    struct MannWhitneyResult {
+        // U statistic of the second sample (the number of pairs in
+        // which the second sample's value is greater, counting ties
+        // as 1/2)
+        double u{0};
+
+        // normal approximation z-score of u, positive when the second
+        // sample tends to be greater
+        double z{0};
+
+        // one-sided p-value for the hypothesis that the second sample
+        // tends to be greater than the first.
+        double pGreater{1};
+
+        // one-sided p-value for the hypothesis that the second sample
+        // tends to be less than the first.
+        double pLess{1};
+    };
+
+    // Mann-Whitney U test (Wilcoxon rank-sum) of samples a and b,
+    // using the normal approximation with tie and continuity
+    // corrections.  The approximation is reasonable when both
+    // samples have at least ~8 values.  Values may be infinite (e.g.,
+    // the time to solve a run that did not solve), they rank as
+    // greater than all finite values.
+    inline MannWhitneyResult mannWhitney(const std::vector<double>& a, const std::vector<double>& b) {
+        MannWhitneyResult result;
+        const double n1 = a.size();
+        const double n2 = b.size();
+        if (a.empty() || b.empty())
+            return result;
+
+        std::vector<std::pair<double, int>> all;
+        all.reserve(a.size() + b.size());
+        for (double x : a) all.emplace_back(x, 0);
+        for (double x : b) all.emplace_back(x, 1);
+        std::sort(all.begin(), all.end(), [] (auto& x, auto& y) { return x.first < y.first; });
+
+        // assign average ranks to ties, and accumulate the tie
+        // correction term sum(t^3 - t).
+        double rankSumB = 0;
+        double tieTerm = 0;
+        for (std::size_t i = 0, j ; i < all.size() ; i = j) {
+            for (j = i+1 ; j < all.size() && all[j].first == all[i].first ; ++j)
+                ;
+            double rank = (i + 1 + j) / 2.0; // average of ranks i+1 .. j
+            double t = j - i;
+            tieTerm += t*t*t - t;
+            for (std::size_t k = i ; k < j ; ++k)
+                if (all[k].second)
+                    rankSumB += rank;
+        }
+
+        result.u = rankSumB - n2 * (n2 + 1) / 2;
+        double mean = n1 * n2 / 2;
+        double n = n1 + n2;
+        double variance = n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+        if (variance <= 0)
+            return result; // all values tied
+
+        double sd = std::sqrt(variance);
+        result.z = (result.u - mean) / sd;
+        // P(Z >= z) with continuity correction
+        result.pGreater = 0.5 * std::erfc((result.u - mean - 0.5) / sd / std::sqrt(2.0));
+        result.pLess = 0.5 * std::erfc((mean - result.u - 0.5) / sd / std::sqrt(2.0));
+        result.pGreater = std::min(1.0, result.pGreater);
+        result.pLess = std::min(1.0, result.pLess);
+        return result;
+    }
+
+    inline double median(std::vector<double> v) {
+        if (v.empty())
+            return std::nan("");
+        std::size_t mid = v.size() / 2;
+        std::nth_element(v.begin(), v.begin() + mid, v.end());
+        if (v.size() % 2)
+            return v[mid];
+        double hi = v[mid];
+        return (*std::max_element(v.begin(), v.begin() + mid) + hi) / 2;
+    }
+}
+
+#endif
@@ -0,0 +1,133 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#define MPT_LOG_LEVEL WARN
+// the spaces must be included first, as the validator finds their
+// interpolate() functions through unqualified lookup.
+#include <mpt/lp_space.hpp>
+#include <mpt/se3_space.hpp>
+#include <mpt/discrete_motion_validator.hpp>
+#include <random>
+#include "bench.hpp"
+
+// Measures DiscreteMotionValidator with a state validator that
+// accepts every state, thus the time is that of the bisection and
+// interpolation alone.  Each motion is checked in the given number
+// of steps, including lengths past the validator's fixed bisection
+// queue size.
+
+using namespace unc::robotics::mpt;
+
+namespace mpt_bench {
+    template <typename State>
+    struct AlwaysValid {
+        bool operator() (const State&) const {
+            return true;
+        }
+    };
+
+    static constexpr std::size_t kMotions = 256; // power of 2
+
+    template <typename Space>
+    void benchValidator(
+        bench::Runner& runner, const std::string& name, const Space& space,
+        const std::vector<std::pair<typename Space::Type, typename Space::Type>>& motions)
+    {
+        using State = typename Space::Type;
+        using Distance = typename Space::Distance;
+
+        for (std::size_t steps : { 8, 64, 512 }) {
+            // motions are all the same length (1), so the step size
+            // determines the number of steps per motion.
+            DiscreteMotionValidator<Space, AlwaysValid<State>> validator(space, Distance(1) / steps);
+            runner.measure(name + "/steps=" + std::to_string(steps), [&] (std::size_t i) {
+                auto& [a, b] = motions[i % kMotions];
+                return validator(a, b);
+            });
+        }
+    }
+
+    template <typename Scalar>
+    void benchL2(bench::Runner& runner, const std::string& name) {
+        using Space = L2Space<Scalar, 3>;
+        using Vec = Eigen::Matrix<Scalar, 3, 1>;
+        std::mt19937_64 rng(1);
+        std::normal_distribution<Scalar> dist;
+        std::vector<std::pair<Vec, Vec>> motions;
+        for (std::size_t i=0 ; i<kMotions ; ++i) {
+            Vec a(dist(rng), dist(rng), dist(rng));
+            Vec dir(dist(rng), dist(rng), dist(rng));
+            motions.emplace_back(a, a + dir.normalized() * Scalar(0.999));
+        }
+        benchValidator(runner, name, Space(), motions);
+    }
+
+    template <typename Scalar>
+    void benchSE3(bench::Runner& runner, const std::string& name) {
+        using Space = SE3Space<Scalar>;
+        using State = typename Space::Type;
+        using Quat = Eigen::Quaternion<Scalar>;
+        using Vec = Eigen::Matrix<Scalar, 3, 1>;
+        std::mt19937_64 rng(1);
+        std::normal_distribution<Scalar> dist;
+        std::vector<std::pair<State, State>> motions;
+        for (std::size_t i=0 ; i<kMotions ; ++i) {
+            // split the distance of 1 evenly between the rotation
+            // and the translation (the SO(3) distance is half the
+            // rotation angle).
+            Vec axis(dist(rng), dist(rng), dist(rng));
+            Vec dir(dist(rng), dist(rng), dist(rng));
+            State a, b;
+            std::get<Quat>(a) = Quat(Eigen::AngleAxis<Scalar>(dist(rng), axis.normalized()));
+            std::get<Quat>(b) = std::get<Quat>(a) * Quat(Eigen::AngleAxis<Scalar>(Scalar(0.999), axis.normalized()));
+            std::get<Vec>(a) = Vec(dist(rng), dist(rng), dist(rng));
+            std::get<Vec>(b) = std::get<Vec>(a) + dir.normalized() * Scalar(0.4995);
+            motions.emplace_back(a, b);
+        }
+        benchValidator(runner, name, Space(), motions);
+    }
+}
+
+using namespace mpt_bench;
+
+BENCHMARK(validate_l2) {
+    benchL2<float>(runner, "float/3");
+    benchL2<double>(runner, "double/3");
+}
+
+BENCHMARK(validate_se3) {
+    benchSE3<float>(runner, "float");
+    benchSE3<double>(runner, "double");
+}
@@ -0,0 +1,342 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+// Compares benchmark results against a baseline, and exits with a
+// non-zero status if any result is significantly worse.  Both files
+// are JSON Lines as written by the benchmarks:
+//
+//   * microbenchmarks (bench/*_bench --output=FILE): the time per
+//     operation of each repetition, grouped by measurement name.
+//
+//   * planner benchmarks (demo/planner_benchmark): the time to first
+//     solution and the sampling rate of each run, grouped by planner,
+//     scenario, and thread count.  Runs that did not solve count as
+//     an infinite time to solution.
+//
+// For each group in both files, a one-sided Mann-Whitney U test
+// checks whether the current results are worse than the baseline.  A
+// group is a regression when the test is significant (p < --alpha)
+// AND the median changed by more than --threshold, the latter to
+// avoid failing on statistically significant but negligible changes.
+// A group in the baseline that is missing from the current results
+// (e.g., a benchmark that crashed, timed out, or was renamed), or that
+// has fewer than --min-samples samples in the current results (e.g.,
+// a run cut short) while it has enough in the baseline, also fails
+// the gate.  Groups with too few samples in the baseline are skipped.
+//
+// Results from several builds may be appended to one file and told
+// apart by their "label".  --baseline-label and --current-label
+// select the records to compare from each file; without them, each
+// file must contain only one label, since otherwise runs of different
+// builds would be merged into one group.
+//
+// Usage:
+//
+//    regression_gate [--alpha=P] [--threshold=FRACTION] [--min-samples=N]
+//        [--baseline-label=LABEL] [--current-label=LABEL] baseline.jsonl current.jsonl
+//
+// Exit status is 0 with no regressions, 1 with regressions, missing
+// groups, or groups with too few current samples, and 2 on errors
+// (including when no group could be compared).
+
+#include "json_reader.hpp"
+#include "mann_whitney.hpp"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace mpt_bench {
+    struct Metric {
+        // true if smaller values are better (e.g., times), false if
+        // larger values are better (e.g., rates).
+        bool lowerIsBetter{true};
+        std::vector<double> samples;
+    };
+
+    // key is "group name/metric name"
+    using Results = std::map<std::string, Metric>;
+
+    void addSample(Results& results, const std::string& key, bool lowerIsBetter, double value) {
+        Metric& m = results[key];
+        m.lowerIsBetter = lowerIsBetter;
+        m.samples.push_back(value);
+    }
+
+    void addRecord(Results& results, const json::Value& r) {
+        if (r["ns_per_op"].isArray()) {
+            // microbenchmark
+            std::string key = r["name"].string() + "/ns_per_op";
+            for (const json::Value& v : r["ns_per_op"].array())
+                addSample(results, key, true, v.number());
+        } else if (r.has("first_solution_time") && r["planner"].isString()) {
+            // planner benchmark run
+            std::string group = r["planner"].string() + "/" + r["scenario"].string()
+                + "/threads=" + std::to_string(static_cast<int>(r["threads"].number()));
+            const json::Value& t = r["first_solution_time"];
+            addSample(results, group + "/time_to_solution", true,
+                      t.isNumber() ? t.number() : std::numeric_limits<double>::infinity());
+            if (r["samples_per_second"].isNumber())
+                addSample(results, group + "/samples_per_second", false, r["samples_per_second"].number());
+        }
+        // other records (e.g., scaling summaries) are not compared.
+    }
+
+    // Loads the records with the given label, or all records if
+    // label is null.  In the latter case, the records must all have
+    // the same label.
+    Results load(const std::string& file, const std::string *label, const char *labelOption) {
+        std::ifstream in(file);
+        if (!in)
+            throw std::runtime_error("failed to open " + file);
+        Results results;
+        std::set<std::string> labels;
+        std::string line;
+        for (unsigned lineNo = 1 ; std::getline(in, line) ; ++lineNo) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+            try {
+                json::Value r = json::parse(line);
+                const std::string& recordLabel = r["label"].string();
+                if (label && recordLabel != *label)
+                    continue;
+                labels.insert(recordLabel);
+                addRecord(results, r);
+            } catch (const std::exception& ex) {
+                throw std::runtime_error(file + ":" + std::to_string(lineNo) + ": " + ex.what());
+            }
+        }
+
+        if (label && labels.empty())
+            throw std::runtime_error(file + ": no results with label \"" + *label + "\"");
+
+        if (labels.size() > 1) {
+            std::string list;
+            for (const std::string& l : labels)
+                list += (list.empty() ? "\"" : ", \"") + l + "\"";
+            throw std::runtime_error(file + ": contains results for several labels (" + list
+                                     + "), select one with " + labelOption);
+        }
+        return results;
+    }
+
+    std::string formatValue(double v) {
+        std::ostringstream str;
+        if (std::isinf(v))
+            str << "inf";
+        else
+            str << std::setprecision(4) << v;
+        return str.str();
+    }
+
+    std::string formatChange(double base, double current) {
+        std::ostringstream str;
+        if (std::isinf(base) || std::isinf(current) || base == 0)
+            str << (base == current ? "0%" : "n/a");
+        else
+            str << std::showpos << std::fixed << std::setprecision(1) << 100 * (current / base - 1) << '%';
+        return str.str();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace mpt_bench;
+
+    double alpha = 0.01;
+    double threshold = 0.05;
+    unsigned minSamples = 5;
+    std::string baselineLabel;
+    std::string currentLabel;
+    bool hasBaselineLabel = false;
+    bool hasCurrentLabel = false;
+    std::vector<std::string> files;
+    bool usage = false;
+    for (int i=1 ; i<argc ; ++i) {
+        std::string arg(argv[i]);
+        if (arg.rfind("--alpha=", 0) == 0) {
+            alpha = std::stod(arg.substr(8));
+        } else if (arg.rfind("--threshold=", 0) == 0) {
+            threshold = std::stod(arg.substr(12));
+        } else if (arg.rfind("--min-samples=", 0) == 0) {
+            minSamples = std::stoul(arg.substr(14));
+        } else if (arg.rfind("--baseline-label=", 0) == 0) {
+            baselineLabel = arg.substr(17);
+            hasBaselineLabel = true;
+        } else if (arg.rfind("--current-label=", 0) == 0) {
+            currentLabel = arg.substr(16);
+            hasCurrentLabel = true;
+        } else if (arg.rfind("--", 0) != 0) {
+            files.push_back(arg);
+        } else {
+            usage = true;
+        }
+    }
+
+    if (usage || files.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " [--alpha=P] [--threshold=FRACTION] [--min-samples=N]"
+            " [--baseline-label=LABEL] [--current-label=LABEL] baseline.jsonl current.jsonl\n"
+            "  --alpha=P               significance level (default 0.01)\n"
+            "  --threshold=FRACTION    minimum change in the median to report (default 0.05)\n"
+            "  --min-samples=N         minimum samples in each group to compare (default 5)\n"
+            "  --baseline-label=LABEL  only compare baseline results with this label\n"
+            "  --current-label=LABEL   only compare current results with this label\n";
+        return 2;
+    }
+
+    try {
+        Results baseline = load(
+            files[0], hasBaselineLabel ? &baselineLabel : nullptr, "--baseline-label");
+        Results current = load(
+            files[1], hasCurrentLabel ? &currentLabel : nullptr, "--current-label");
+
+        std::vector<std::string> regressions;
+        std::vector<std::string> missing;
+        std::vector<std::string> incomplete;
+        std::size_t compared = 0;
+        std::size_t thinBaseline = 0;
+
+        std::cout << std::left << std::setw(56) << "benchmark" << std::right
+                  << std::setw(12) << "baseline"
+                  << std::setw(12) << "current"
+                  << std::setw(10) << "change"
+                  << std::setw(11) << "p"
+                  << "  status\n";
+
+        for (const auto& [key, base] : baseline) {
+            double baseMedian = median(base.samples);
+
+            auto it = current.find(key);
+            if (it == current.end()) {
+                missing.push_back(key);
+                std::cout << std::left << std::setw(56) << key << std::right
+                          << std::setw(12) << formatValue(baseMedian)
+                          << std::setw(12) << "-"
+                          << std::setw(10) << "-"
+                          << std::setw(11) << "-"
+                          << "  MISSING\n";
+                continue;
+            }
+            const Metric& cur = it->second;
+
+            double curMedian = median(cur.samples);
+
+            std::string status;
+            double p = std::nan("");
+            if (base.samples.size() < minSamples) {
+                ++thinBaseline;
+                status = "too few baseline samples";
+            } else if (cur.samples.size() < minSamples) {
+                status = "TOO FEW SAMPLES";
+                incomplete.push_back(key);
+            } else {
+                ++compared;
+                MannWhitneyResult mw = mannWhitney(base.samples, cur.samples);
+                double pWorse = base.lowerIsBetter ? mw.pGreater : mw.pLess;
+                double pBetter = base.lowerIsBetter ? mw.pLess : mw.pGreater;
+                double ratio = curMedian / baseMedian;
+                double worseBy = base.lowerIsBetter ? ratio - 1 : 1 / ratio - 1;
+                // an infinite median means at least half the runs
+                // failed, which is always a meaningful change.
+                bool meaningful = std::isnan(worseBy) || std::abs(worseBy) > threshold
+                    || std::isinf(baseMedian) != std::isinf(curMedian);
+
+                if (pWorse < alpha && meaningful) {
+                    p = pWorse;
+                    status = "REGRESSION";
+                    regressions.push_back(key);
+                } else if (pBetter < alpha && meaningful) {
+                    p = pBetter;
+                    status = "improved";
+                } else {
+                    p = std::min(pWorse, pBetter);
+                    status = "ok";
+                }
+            }
+
+            std::cout << std::left << std::setw(56) << key << std::right
+                      << std::setw(12) << formatValue(baseMedian)
+                      << std::setw(12) << formatValue(curMedian)
+                      << std::setw(10) << formatChange(baseMedian, curMedian)
+                      << std::setw(11) << (std::isnan(p) ? std::string("-") : formatValue(p))
+                      << "  " << status << "\n";
+        }
+
+        std::cout << "\ncompared " << compared << " benchmarks (alpha=" << alpha
+                  << ", threshold=" << threshold * 100 << "%)\n";
+        if (!missing.empty()) {
+            std::cout << missing.size() << " benchmark"
+                      << (missing.size() == 1 ? "" : "s") << " missing from the current results:\n";
+            for (const std::string& key : missing)
+                std::cout << "  " << key << "\n";
+        }
+
+        if (!incomplete.empty()) {
+            std::cout << incomplete.size() << " benchmark"
+                      << (incomplete.size() == 1 ? "" : "s") << " with fewer than " << minSamples
+                      << " samples in the current results:\n";
+            for (const std::string& key : incomplete)
+                std::cout << "  " << key << "\n";
+        }
+
+        if (!regressions.empty()) {
+            std::cout << regressions.size() << " significant regression"
+                      << (regressions.size() == 1 ? "" : "s") << ":\n";
+            for (const std::string& key : regressions)
+                std::cout << "  " << key << "\n";
+        }
+
+        if (!regressions.empty() || !missing.empty() || !incomplete.empty())
+            return 1;
+
+        if (compared == 0) {
+            if (baseline.empty())
+                std::cout << "no benchmarks in the baseline results\n";
+            else
+                std::cout << "no benchmark has at least " << minSamples
+                          << " samples in the baseline results (" << thinBaseline
+                          << " skipped, see --min-samples)\n";
+            return 2;
+        }
+
+        std::cout << "no significant regressions\n";
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << "error: " << ex.what() << std::endl;
+        return 2;
+    }
+}
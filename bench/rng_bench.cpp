@@ -0,0 +1,67 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#include <mpt/mersenne_twister.hpp>
+#include <random>
+#include "bench.hpp"
+
+// Compares MPT's MersenneTwister to the standard library's, both
+// for raw output and through a uniform real distribution (as used by
+// the samplers).
+
+using namespace unc::robotics::mpt;
+
+namespace mpt_bench {
+    template <typename RNG>
+    void benchRNG(bench::Runner& runner, const std::string& name) {
+        RNG rng(1);
+        runner.measure(name + "/raw", [&] (std::size_t) { return rng(); });
+
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        runner.measure(name + "/uniform_real", [&] (std::size_t) { return dist(rng); });
+    }
+}
+
+using namespace mpt_bench;
+
+BENCHMARK(mt19937) {
+    benchRNG<MersenneTwister19937_32>(runner, "mpt");
+    benchRNG<std::mt19937>(runner, "std");
+}
+
+BENCHMARK(mt19937_64) {
+    benchRNG<MersenneTwister19937_64>(runner, "mpt");
+    benchRNG<std::mt19937_64>(runner, "std");
+}
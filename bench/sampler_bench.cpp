@@ -0,0 +1,97 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#include <mpt/box_bounds.hpp>
+#include <mpt/lp_space.hpp>
+#include <mpt/mersenne_twister.hpp>
+#include <mpt/se3_space.hpp>
+#include <mpt/so2_space.hpp>
+#include <mpt/so3_space.hpp>
+#include <mpt/uniform_sampler.hpp>
+#include "bench.hpp"
+
+// Measures UniformSampler throughput for each space, using the RNG
+// the planners select for the space's scalar type.
+
+using namespace unc::robotics::mpt;
+
+namespace mpt_bench {
+    template <typename Space, typename Bounds>
+    void benchSampler(bench::Runner& runner, const std::string& name, const Space& space, const Bounds& bounds) {
+        using RNG = mersenne_twister_select<typename Space::Distance>;
+        UniformSampler<Space, Bounds> sampler(space, bounds);
+        RNG rng(1);
+        runner.measure(name, [&] (std::size_t) { return sampler(rng); });
+    }
+
+    template <typename Scalar, int dim>
+    void benchL2(bench::Runner& runner, const std::string& name) {
+        using Vec = Eigen::Matrix<Scalar, dim, 1>;
+        benchSampler(runner, name, L2Space<Scalar, dim>(),
+                     BoxBounds<Scalar, dim>(Vec::Constant(-1), Vec::Constant(1)));
+    }
+
+    template <typename Scalar>
+    void benchSE3(bench::Runner& runner, const std::string& name) {
+        using Vec = Eigen::Matrix<Scalar, 3, 1>;
+        using Bounds = std::tuple<Unbounded, BoxBounds<Scalar, 3>>;
+        benchSampler(runner, name, SE3Space<Scalar, 50>(),
+                     Bounds(Unbounded{}, BoxBounds<Scalar, 3>(Vec::Constant(-1), Vec::Constant(1))));
+    }
+}
+
+using namespace mpt_bench;
+
+BENCHMARK(sample_l2) {
+    benchL2<float, 3>(runner, "float/3");
+    benchL2<double, 3>(runner, "double/3");
+    benchL2<float, 10>(runner, "float/10");
+    benchL2<double, 10>(runner, "double/10");
+}
+
+BENCHMARK(sample_so2) {
+    benchSampler(runner, "float", SO2Space<float>(), Unbounded{});
+    benchSampler(runner, "double", SO2Space<double>(), Unbounded{});
+}
+
+BENCHMARK(sample_so3) {
+    benchSampler(runner, "float", SO3Space<float>(), Unbounded{});
+    benchSampler(runner, "double", SO3Space<double>(), Unbounded{});
+}
+
+BENCHMARK(sample_se3) {
+    benchSE3<float>(runner, "float");
+    benchSE3<double>(runner, "double");
+}
@@ -0,0 +1,156 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#include <mpt/box_bounds.hpp>
+#include <mpt/lp_space.hpp>
+#include <mpt/se2_space.hpp>
+#include <mpt/se3_space.hpp>
+#include <mpt/so2_space.hpp>
+#include <mpt/so3_space.hpp>
+#include <mpt/uniform_sampler.hpp>
+#include <random>
+#include "bench.hpp"
+
+// Measures distance and interpolate for each space and scalar type.
+// The inputs cycle through a small set of random states so that they
+// stay in L1 cache and the measurements are of the arithmetic alone.
+
+using namespace unc::robotics::mpt;
+
+namespace mpt_bench {
+    static constexpr std::size_t kStates = 1024; // power of 2
+
+    template <typename Space, typename Sampler>
+    void benchSpace(bench::Runner& runner, const std::string& name, const Space& space, const Sampler& sampler) {
+        using State = typename Space::Type;
+        using Distance = typename Space::Distance;
+
+        std::mt19937_64 rng(1);
+        std::vector<State> states;
+        states.reserve(kStates);
+        for (std::size_t i=0 ; i<kStates ; ++i)
+            states.push_back(sampler(rng));
+
+        runner.measure(name + "/distance", [&] (std::size_t i) {
+            return space.distance(states[i % kStates], states[(i+1) % kStates]);
+        });
+
+        runner.measure(name + "/interpolate", [&] (std::size_t i) {
+            return interpolate(space, states[i % kStates], states[(i+1) % kStates], Distance(0.375));
+        });
+    }
+
+    template <typename Scalar, int dim, int p>
+    void benchLP(bench::Runner& runner, const std::string& name) {
+        using Space = LPSpace<Scalar, dim, p>;
+        using Bounds = BoxBounds<Scalar, dim>;
+        using Vec = Eigen::Matrix<Scalar, dim, 1>;
+        Space space;
+        UniformSampler<Space, Bounds> sampler(space, Bounds(Vec::Constant(-1), Vec::Constant(1)));
+        benchSpace(runner, name, space, sampler);
+    }
+
+    template <typename Scalar>
+    void benchSO2(bench::Runner& runner, const std::string& name) {
+        using Space = SO2Space<Scalar>;
+        Space space;
+        UniformSampler<Space, Unbounded> sampler(space);
+        benchSpace(runner, name, space, sampler);
+    }
+
+    template <typename Scalar>
+    void benchSO3(bench::Runner& runner, const std::string& name) {
+        using Space = SO3Space<Scalar>;
+        Space space;
+        UniformSampler<Space, Unbounded> sampler(space);
+        benchSpace(runner, name, space, sampler);
+    }
+
+    template <typename Scalar>
+    void benchSE2(bench::Runner& runner, const std::string& name) {
+        using Space = SE2Space<Scalar, 1, 1>;
+        using Bounds = std::tuple<BoxBounds<Scalar, 2>, Unbounded>;
+        using Vec = Eigen::Matrix<Scalar, 2, 1>;
+        Space space;
+        UniformSampler<Space, Bounds> sampler(
+            space, Bounds(BoxBounds<Scalar, 2>(Vec::Constant(-1), Vec::Constant(1)), Unbounded{}));
+        benchSpace(runner, name, space, sampler);
+    }
+
+    template <typename Scalar>
+    void benchSE3(bench::Runner& runner, const std::string& name) {
+        using Space = SE3Space<Scalar, 50>;
+        using Bounds = std::tuple<Unbounded, BoxBounds<Scalar, 3>>;
+        using Vec = Eigen::Matrix<Scalar, 3, 1>;
+        Space space;
+        UniformSampler<Space, Bounds> sampler(
+            space, Bounds(Unbounded{}, BoxBounds<Scalar, 3>(Vec::Constant(-1), Vec::Constant(1))));
+        benchSpace(runner, name, space, sampler);
+    }
+}
+
+using namespace mpt_bench;
+
+BENCHMARK(l1) {
+    benchLP<float, 3, 1>(runner, "float/3");
+    benchLP<double, 3, 1>(runner, "double/3");
+}
+
+BENCHMARK(l2) {
+    benchLP<float, 3, 2>(runner, "float/3");
+    benchLP<double, 3, 2>(runner, "double/3");
+    benchLP<float, 10, 2>(runner, "float/10");
+    benchLP<double, 10, 2>(runner, "double/10");
+}
+
+BENCHMARK(so2) {
+    benchSO2<float>(runner, "float");
+    benchSO2<double>(runner, "double");
+}
+
+BENCHMARK(so3) {
+    benchSO3<float>(runner, "float");
+    benchSO3<double>(runner, "double");
+}
+
+BENCHMARK(se2) {
+    benchSE2<float>(runner, "float");
+    benchSE2<double>(runner, "double");
+}
+
+BENCHMARK(se3) {
+    benchSE3<float>(runner, "float");
+    benchSE3<double>(runner, "double");
+}
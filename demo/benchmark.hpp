@@ -0,0 +1,300 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_DEMO_BENCHMARK_HPP
+#define MPT_DEMO_BENCHMARK_HPP
+
+#include <mpt/log.hpp>
+#include <mpt/planner.hpp>
+#include "../bench/json_writer.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace mpt_demo {
+    // A deterministic seed sequence for the planners.  The planners
+    // seed each worker's RNG from the same seed object, thus each
+    // call to generate() mixes in a call counter to give each worker
+    // its own reproducible sequence.
+    class BenchmarkSeed {
+        std::uint32_t seed_;
+        mutable std::uint32_t calls_{0};
+
+    public:
+        using result_type = std::uint32_t;
+
+        explicit BenchmarkSeed(std::uint32_t seed) : seed_(seed) {}
+
+        template <class RandomIt>
+        void generate(RandomIt begin, RandomIt end) const {
+            std::seed_seq seq{seed_, calls_++};
+            seq.generate(begin, end);
+        }
+
+        std::size_t size() const {
+            return 2;
+        }
+    };
+
+    // Type tag for passing a planner algorithm to a generic lambda.
+    template <typename Algorithm>
+    struct PlannerType {
+        using type = Algorithm;
+    };
+
+    struct BenchmarkOptions {
+        // thread counts to run with
+        std::vector<unsigned> threads{1};
+
+        // runs with seeds firstSeed, firstSeed+1, ... firstSeed+seeds-1
+        unsigned seeds{10};
+        std::uint32_t firstSeed{1};
+
+        // each run is limited to this time
+        std::chrono::milliseconds timeLimit{1000};
+
+        // stop at the first solution instead of running for the full
+        // time limit.
+        bool untilSolved{false};
+
+        // stop after this many iterations of the first worker, 0
+        // for no limit.
+        std::size_t maxIterations{0};
+
+        // interval between samples of the solution cost, for planners
+        // that report progress (see runBenchmark)
+        std::chrono::milliseconds sampleInterval{10};
+
+        // free-form label to identify the build in the results
+        std::string label;
+    };
+
+    struct BenchmarkResult {
+        std::string planner;
+        std::string scenario;
+        unsigned threads{0};
+        std::uint32_t seed{0};
+
+        bool solved{false};
+
+        // seconds from the start of the solve to the first check of
+        // the done predicate that found a solution (NaN if unsolved)
+        double firstSolutionTime{std::numeric_limits<double>::quiet_NaN()};
+        double finalCost{std::numeric_limits<double>::infinity()};
+        double solveTime{0};
+
+        std::size_t size{0};
+
+        // iterations of the first worker (other workers do not
+        // report theirs), and graph growth rate
+        std::size_t iterations{0};
+        double samplesPerSecond{0};
+
+        std::size_t memoryBytes{0};
+
+        // (seconds, cost) pairs, recorded when the cost changes.
+        std::vector<std::pair<double, double>> costVsTime;
+    };
+
+    using mpt_bench::jsonEscape;
+
+    // Writes a result as a single line of JSON.  One result per line
+    // (JSON Lines) allows results to be appended across runs and
+    // builds, and loaded with most data analysis tools.
+    inline void writeJson(std::ostream& out, const BenchmarkResult& r, const std::string& label) {
+        auto num = [&] (double v) -> std::ostream& {
+            return std::isfinite(v) ? (out << v) : (out << "null");
+        };
+
+        out << "{\"label\":\"" << jsonEscape(label)
+            << "\",\"planner\":\"" << jsonEscape(r.planner)
+            << "\",\"scenario\":\"" << jsonEscape(r.scenario)
+            << "\",\"threads\":" << r.threads
+            << ",\"seed\":" << r.seed
+            << ",\"solved\":" << (r.solved ? "true" : "false")
+            << ",\"first_solution_time\":";
+        num(r.firstSolutionTime) << ",\"final_cost\":";
+        num(r.finalCost) << ",\"solve_time\":";
+        num(r.solveTime) << ",\"size\":" << r.size
+                         << ",\"iterations\":" << r.iterations
+                         << ",\"samples_per_second\":";
+        num(r.samplesPerSecond) << ",\"memory_bytes\":" << r.memoryBytes
+                                << ",\"cost_vs_time\":[";
+        for (std::size_t i = 0 ; i < r.costVsTime.size() ; ++i) {
+            out << (i ? ",[" : "[") << r.costVsTime[i].first << ',';
+            num(r.costVsTime[i].second) << ']';
+        }
+        out << "]}\n";
+    }
+
+    template <typename Space, typename State>
+    double pathCost(const Space& space, const std::vector<State>& path) {
+        double cost = 0;
+        for (std::size_t i = 1 ; i < path.size() ; ++i)
+            cost += space.distance(path[i-1], path[i]);
+        return path.empty() ? std::numeric_limits<double>::infinity() : cost;
+    }
+
+    namespace impl {
+        struct IgnoreProgress {
+            template <typename Progress>
+            void operator () (const Progress&) const {}
+        };
+
+        template <typename Planner, typename = void>
+        struct has_progress_callback : std::false_type {};
+
+        template <typename Planner>
+        struct has_progress_callback<Planner, std::void_t<decltype(
+            std::declval<Planner&>().setProgressCallback(
+                IgnoreProgress{}, std::chrono::milliseconds(1)))>>
+            : std::true_type {};
+    }
+
+    // Runs a single benchmark of Algorithm on the scenario.  The first
+    // worker checks whether the planner has solved on every iteration
+    // (through the done predicate), which only reads a flag, so the
+    // time to first solution is exact and the other workers run
+    // exactly as they do outside of the benchmark.  Intermediate
+    // costs come from the planner's progress callback at
+    // options.sampleInterval when it has one, as it reads the cost
+    // the planner already maintains.  The path is extracted once,
+    // after the solve, for the final cost.  After solving,
+    // inspect(planner, result) is called to allow the caller to
+    // collect additional data from the planner.
+    template <typename Algorithm, typename Scenario, typename State, typename Inspect>
+    BenchmarkResult runBenchmark(
+        const std::string& plannerName, const std::string& scenarioName,
+        const Scenario& scenario, const State& start,
+        unsigned threads, std::uint32_t seed,
+        const BenchmarkOptions& options,
+        Inspect&& inspect)
+    {
+        using namespace unc::robotics::mpt;
+        using Clock = std::chrono::steady_clock;
+
+#ifdef _OPENMP
+        omp_set_num_threads(static_cast<int>(threads));
+#endif
+
+        BenchmarkResult result;
+        result.planner = plannerName;
+        result.scenario = scenarioName;
+        result.threads = threads;
+        result.seed = seed;
+
+        Planner<Scenario, Algorithm> planner(scenario, BenchmarkSeed(seed));
+        planner.addStart(start);
+
+        auto addCost = [&] (double t, double cost) {
+            if (result.costVsTime.empty() || cost != result.costVsTime.back().second)
+                result.costVsTime.emplace_back(t, cost);
+        };
+
+        addCost(0, std::numeric_limits<double>::infinity());
+
+        if constexpr (impl::has_progress_callback<decltype(planner)>::value) {
+            planner.setProgressCallback([&] (const auto& progress) {
+                addCost(std::chrono::duration<double>(progress.elapsed).count(), progress.bestCost);
+            }, options.sampleInterval);
+        }
+
+        Clock::time_point startTime = Clock::now();
+        planner.solveFor([&] {
+            if (!result.solved && planner.solved()) {
+                result.solved = true;
+                result.firstSolutionTime = std::chrono::duration<double>(
+                    Clock::now() - startTime).count();
+            }
+            if ((options.untilSolved && result.solved) ||
+                (options.maxIterations && result.iterations >= options.maxIterations))
+                return true;
+            // only count the iterations that run, so that a run
+            // limited to maxIterations repeats a timed run exactly.
+            ++result.iterations;
+            return false;
+        }, options.timeLimit);
+        Clock::time_point endTime = Clock::now();
+
+        result.solveTime = std::chrono::duration<double>(endTime - startTime).count();
+        if (planner.solved()) {
+            if (!result.solved) {
+                // solved on the last iteration, after its check
+                result.solved = true;
+                result.firstSolutionTime = result.solveTime;
+            }
+            addCost(result.solveTime, pathCost(scenario.space(), planner.solution()));
+        }
+
+        result.finalCost = result.costVsTime.back().second;
+        result.size = planner.size();
+        result.samplesPerSecond = result.size / result.solveTime;
+        result.memoryBytes = planner.memoryUsage().total();
+        inspect(planner, result);
+
+        MPT_LOG(INFO) << plannerName << " on " << scenarioName
+                      << " (" << result.threads << " threads, seed " << seed << "): "
+                      << (result.solved ? "solved" : "unsolved")
+                      << ", cost " << result.finalCost
+                      << ", " << result.size << " nodes";
+
+        return result;
+    }
+
+    template <typename Algorithm, typename Scenario, typename State>
+    BenchmarkResult runBenchmark(
+        const std::string& plannerName, const std::string& scenarioName,
+        const Scenario& scenario, const State& start,
+        unsigned threads, std::uint32_t seed,
+        const BenchmarkOptions& options)
+    {
+        return runBenchmark<Algorithm>(
+            plannerName, scenarioName, scenario, start, threads, seed, options,
+            [] (const auto&, const auto&) {});
+    }
+}
+
+#endif
@@ -0,0 +1,250 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_DEMO_BENCHMARK_SCENARIOS_HPP
+#define MPT_DEMO_BENCHMARK_SCENARIOS_HPP
+
+#include "holonomic_2d_point_scenario.hpp"
+#include "link_manipulator_scenario.hpp"
+#include "nao_cup_scenario.hpp"
+#include "png_2d_scenario.hpp"
+#include "synthetic_scenario.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef BENCHMARK_SE3
+#define BENCHMARK_SE3 1
+#endif
+
+#if BENCHMARK_SE3
+#include "scenario_config.hpp"
+#include "se3_rigid_body_scenario.hpp"
+#endif
+
+namespace mpt_demo {
+    template <typename List>
+    bool benchmarkSelected(const List& list, const std::string& name) {
+        return list.empty() || std::find(list.begin(), list.end(), name) != list.end();
+    }
+
+    struct BenchmarkScenarioOptions {
+        // scenarios to run, all when empty
+        std::vector<std::string> scenarios;
+
+        // OMPL.app configuration files for SE(3) scenarios
+        std::vector<std::string> se3Configs;
+
+        std::string pngFile{"png_planning_input.png"};
+
+        // dimensions of the synthetic scenarios to run, each must be
+        // one of kSyntheticDimensions.
+        std::vector<int> syntheticDimensions{8};
+        SyntheticScenarioParams synthetic;
+
+        bool scenarioSelected(const std::string& name) const {
+            return benchmarkSelected(scenarios, name);
+        }
+    };
+
+    // The synthetic scenario's dimension is a template parameter, so
+    // only these dimensions are compiled into the benchmarks.
+    template <int ... dims>
+    struct SyntheticDimensions {
+        static bool supported(int dim) {
+            return ((dim == dims) || ...);
+        }
+
+        template <typename Scalar, typename Fn>
+        static void forEach(const BenchmarkScenarioOptions& options, Fn& fn) {
+            (forEachDimension<Scalar, dims>(options, fn), ...);
+        }
+
+    private:
+        template <typename Scalar, int dim, typename Fn>
+        static void forEachDimension(const BenchmarkScenarioOptions& options, Fn& fn) {
+            const auto& selected = options.syntheticDimensions;
+            if (std::find(selected.begin(), selected.end(), dim) == selected.end())
+                return;
+            using Scenario = SyntheticScenario<Scalar, dim>;
+            fn("synthetic_" + std::to_string(dim) + "d", Scenario(options.synthetic), Scenario::startState());
+        }
+    };
+
+    using kSyntheticDimensions = SyntheticDimensions<2, 4, 8, 16, 32>;
+
+    // Calls fn(name, scenario, startState) for each selected
+    // scenario.  The scenarios match those in the demo executables,
+    // plus the synthetic scenarios.
+    template <typename Fn>
+    void forEachScenario(const BenchmarkScenarioOptions& options, Fn&& fn) {
+        using Scalar = double;
+
+        if (options.scenarioSelected("holonomic_2d")) {
+            using Scenario = Holonomic2DPointScenario<Scalar>;
+            const int width = 1024;
+            const int height = 512;
+            std::vector<Circle<Scalar>> circles;
+            std::vector<Rect<Scalar>> rects;
+            circles.push_back(Circle<Scalar>(170.0, 140.0, 80.0));
+            circles.push_back(Circle<Scalar>(800.0, 70.0, 50.0));
+            circles.push_back(Circle<Scalar>(900.0, 380.0, 70.0));
+            rects.push_back(Rect<Scalar>(375, 140, 520, 220));
+            rects.push_back(Rect<Scalar>(200, 320, 390, 390));
+            rects.push_back(Rect<Scalar>(600, 200, 680, 450));
+            Scenario::State start, goal;
+            start << 30, 30;
+            goal << width - 30, height - 30;
+            fn("holonomic_2d", Scenario(width, height, circles, rects, goal), start);
+        }
+
+        if (options.scenarioSelected("png_2d")) {
+            using Scenario = PNG2dScenario<Scalar>;
+            std::vector<FilterColor> filters;
+            filters.push_back(FilterColor(126, 106, 61, 15));
+            filters.push_back(FilterColor(61, 53, 6, 15));
+            filters.push_back(FilterColor(255, 255, 255, 5));
+            auto [obstacles, width, height] = readAndFilterPng(filters, options.pngFile);
+            Eigen::Matrix<Scalar, 2, 1> start, goal;
+            start << 430, 1300;
+            goal << 3150, 950;
+            fn("png_2d", Scenario(width, height, goal, obstacles), start);
+        }
+
+        if (options.scenarioSelected("link_manipulator")) {
+            using Scenario = LinkManipulatorScenario<Scalar, 5>;
+            std::vector<Scalar> armLengths = {10.0, 12.0, 8.0, 6.0, 4.0};
+            std::vector<Circle<Scalar>> circles;
+            circles.push_back(Circle<Scalar>(20, -20, 8));
+            circles.push_back(Circle<Scalar>(-20, -30, 5));
+            circles.push_back(Circle<Scalar>(0, 25, 10));
+            circles.push_back(Circle<Scalar>(30, 10, 10));
+            circles.push_back(Circle<Scalar>(-30, 10, 8));
+            Scenario::State start, goal;
+            start << -PI<Scalar> * 5 / 6, 0, 0, 0, 0;
+            goal.fill(0);
+            goal[0] = PI<Scalar> - Scalar(1e-10);
+            fn("link_manipulator", Scenario(goal, circles, armLengths, Scalar(0.5)), start);
+        }
+
+        if (options.scenarioSelected("nao_cup")) {
+            using Scenario = NaoCupScenario<Scalar>;
+            using Config = Scenario::Config;
+            fn("nao_cup", Scenario(), Config(Eigen::Map<const Config>(nao_cup::nao_init_config<Scalar>())));
+        }
+
+        if (options.scenarioSelected("synthetic"))
+            kSyntheticDimensions::forEach<Scalar>(options, fn);
+
+#if BENCHMARK_SE3
+        for (const std::string& configFile : options.se3Configs) {
+            using Scenario = SE3RigidBodyScenario<Scalar>;
+            using Config = Scenario::Space::Type;
+
+            std::size_t lastSlash = configFile.find_last_of("\\/");
+            std::string path = (lastSlash == std::string::npos) ? "" : configFile.substr(0, lastSlash+1);
+            std::string name = "se3:" + configFile.substr(path.size());
+            if (!options.scenarioSelected(name) && !options.scenarioSelected("se3"))
+                continue;
+
+            ScenarioConfig<> config(configFile);
+            Config start, goal;
+            config.load(goal, "problem", "goal");
+            config.load(start, "problem", "start");
+            std::string envMesh, robotMesh;
+            config.load(envMesh, "problem", "world");
+            config.load(robotMesh, "problem", "robot");
+            Eigen::Matrix<Scalar, 3, 1> volumeMin, volumeMax;
+            config.load(volumeMin, "problem", "volume.min");
+            config.load(volumeMax, "problem", "volume.max");
+
+            Scenario scenario(path + envMesh, {path + robotMesh}, goal, volumeMin, volumeMax, 0.01);
+            if (config.hasProp("problem", "motion_check")) {
+                std::string check;
+                config.load(check, "problem", "motion_check");
+                scenario.setMotionCheck(impl::parseMotionCheck(check));
+            }
+            fn(name, scenario, start);
+        }
+#endif
+    }
+
+    inline std::vector<unsigned> parseThreads(const std::string& arg) {
+        std::vector<unsigned> threads;
+        std::istringstream in(arg);
+        for (std::string item ; std::getline(in, item, ',') ; ) {
+            std::size_t pos;
+            int n = std::stoi(item, &pos);
+            if (pos != item.length() || n < 1)
+                throw std::invalid_argument("invalid thread count: " + item);
+            threads.push_back(static_cast<unsigned>(n));
+        }
+        return threads;
+    }
+
+    inline std::vector<int> parseSyntheticDimensions(const std::string& arg) {
+        std::vector<int> dims;
+        std::istringstream in(arg);
+        for (std::string item ; std::getline(in, item, ',') ; ) {
+            std::size_t pos;
+            int n = std::stoi(item, &pos);
+            if (pos != item.length() || !kSyntheticDimensions::supported(n))
+                throw std::invalid_argument("unsupported synthetic dimension: " + item);
+            dims.push_back(n);
+        }
+        return dims;
+    }
+
+    inline double parseDouble(const std::string& arg, const char *what) {
+        std::size_t pos;
+        double d = std::stod(arg, &pos);
+        if (pos != arg.length() || !(d >= 0))
+            throw std::invalid_argument(std::string("invalid ") + what + ": " + arg);
+        return d;
+    }
+
+    inline int parseNonNegative(const std::string& arg, const char *what) {
+        std::size_t pos;
+        int n = std::stoi(arg, &pos);
+        if (pos != arg.length() || n < 0)
+            throw std::invalid_argument(std::string("invalid ") + what + ": " + arg);
+        return n;
+    }
+}
+
+#endif
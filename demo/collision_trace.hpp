@@ -0,0 +1,375 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_COLLISION_TRACE_HPP
+#define MPT_DEMO_COLLISION_TRACE_HPP
+
+// Record/replay of collision checks, for profiling the planners
+// without the cost of the collision checker.  RecordingScenario
+// wraps a scenario and records the result of every valid(q) and
+// link(a,b) query to a CollisionTrace, which is saved to a compact
+// binary file.  ReplayScenario wraps the same scenario and answers
+// the queries from the loaded trace with a hash lookup, falling back
+// to the wrapped scenario (and counting a miss) for queries not in
+// the trace.
+//
+// The planners are deterministic given the seed when single-threaded,
+// thus replaying a trace with the same planner, seed, and iteration
+// count (the trace records the iterations of the run) reproduces the
+// recorded run exactly, with no misses, while taking only a fraction
+// of the time.  Changes to the planner that alter the sequence of
+// samples or queries show up as misses.  With multiple threads, the
+// queries depend on the thread interleaving and some misses are
+// expected.
+//
+// Queries are identified by a 64-bit hash of the bit patterns of the
+// states, thus the wrapped scenario's link() must return bool.
+
+#include <mpt/log.hpp>
+#include <Eigen/Dense>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace mpt_demo {
+    namespace trace {
+        // FNV-1a style mixing of the bit patterns of the states'
+        // coefficients.  This avoids hashing the padding bytes of
+        // composite states.
+        class Hasher {
+            std::uint64_t h_{0xcbf29ce484222325ull};
+
+        public:
+            explicit Hasher(std::uint8_t kind) {
+                add(kind);
+            }
+
+            template <typename T>
+            std::enable_if_t<std::is_arithmetic_v<T>> add(T value) {
+                unsigned char bytes[sizeof(T)];
+                std::memcpy(bytes, &value, sizeof(T));
+                for (unsigned char b : bytes) {
+                    h_ ^= b;
+                    h_ *= 0x100000001b3ull;
+                }
+            }
+
+            template <typename Derived>
+            void add(const Eigen::DenseBase<Derived>& m) {
+                for (Eigen::Index i = 0 ; i < m.size() ; ++i)
+                    add(m.derived().coeff(i));
+            }
+
+            template <typename Derived>
+            void add(const Eigen::QuaternionBase<Derived>& q) {
+                add(q.coeffs());
+            }
+
+            template <typename ... T>
+            void add(const std::tuple<T...>& t) {
+                std::apply([&] (const auto& ... e) { (add(e), ...); }, t);
+            }
+
+            std::uint64_t value() const {
+                return h_;
+            }
+        };
+
+        enum : std::uint8_t { kValid = 1, kLink = 2 };
+
+        template <typename State>
+        std::uint64_t validKey(const State& q) {
+            Hasher h(kValid);
+            h.add(q);
+            return h.value();
+        }
+
+        template <typename State>
+        std::uint64_t linkKey(const State& a, const State& b) {
+            Hasher h(kLink);
+            h.add(a);
+            h.add(b);
+            return h.value();
+        }
+    }
+
+    // The recorded queries of a run.  A trace is shared between the
+    // copies of the scenario that each worker of a planner makes.
+    // While recording, each copy appends to its own Recorder, without
+    // synchronization, and save() merges the recorders.
+    class CollisionTrace {
+        static constexpr char kMagic[8] = { 'M', 'P', 'T', 'C', 'T', 'R', 'C', '1' };
+
+        // 9 bytes per query in the file: the key and the result.
+        struct Record {
+            std::uint64_t key;
+            bool result;
+        };
+
+    public:
+        // The queries recorded by one copy of the scenario, which
+        // must only be used by one thread at a time.
+        class Recorder {
+            std::vector<Record> records_;
+            friend class CollisionTrace;
+
+        public:
+            void record(std::uint64_t key, bool result) {
+                records_.push_back({key, result});
+            }
+        };
+
+    private:
+        // guards recorders_, which grows as the scenario is copied
+        std::mutex mutex_;
+        std::vector<std::shared_ptr<Recorder>> recorders_;
+
+        // the queries of a loaded trace
+        std::vector<Record> records_;
+        std::unordered_map<std::uint64_t, bool> results_;
+        std::uint64_t iterations_{0};
+        std::atomic<std::size_t> hits_{0};
+        std::atomic<std::size_t> misses_{0};
+
+        template <typename Fn>
+        void forEachRecord(Fn&& fn) const {
+            for (const Record& r : records_)
+                fn(r);
+            for (const auto& recorder : recorders_)
+                for (const Record& r : recorder->records_)
+                    fn(r);
+        }
+
+    public:
+        // Returns a new recorder whose queries are part of this
+        // trace.  This may be called concurrently.
+        std::shared_ptr<Recorder> recorder() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            recorders_.push_back(std::make_shared<Recorder>());
+            return recorders_.back();
+        }
+
+        // Returns 1 or 0 for a recorded valid or invalid query, and
+        // -1 for a query not in the trace.  This must only be called
+        // on a loaded trace, and may be called concurrently.
+        int lookup(std::uint64_t key) const {
+            auto it = results_.find(key);
+            return it == results_.end() ? -1 : int(it->second);
+        }
+
+        void countHit() { hits_.fetch_add(1, std::memory_order_relaxed); }
+        void countMiss() { misses_.fetch_add(1, std::memory_order_relaxed); }
+
+        // The number of queries.  Like save(), this must not be
+        // called concurrently with recording.
+        std::size_t size() const {
+            std::size_t n = records_.size();
+            for (const auto& recorder : recorders_)
+                n += recorder->records_.size();
+            return n;
+        }
+        std::size_t hits() const { return hits_.load(); }
+        std::size_t misses() const { return misses_.load(); }
+
+        // iterations of the first worker of the recorded run
+        std::uint64_t iterations() const { return iterations_; }
+        void setIterations(std::uint64_t iterations) { iterations_ = iterations; }
+
+        void save(const std::string& path) const {
+            std::ofstream out(path, std::ios::binary);
+            if (!out)
+                throw std::runtime_error("failed to open " + path);
+            std::uint64_t count = size();
+            out.write(kMagic, sizeof(kMagic));
+            out.write(reinterpret_cast<const char*>(&iterations_), sizeof(iterations_));
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            forEachRecord([&] (const Record& r) {
+                char result = r.result;
+                out.write(reinterpret_cast<const char*>(&r.key), sizeof(r.key));
+                out.write(&result, 1);
+            });
+            if (!out)
+                throw std::runtime_error("failed to write " + path);
+        }
+
+        static std::shared_ptr<CollisionTrace> load(const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+                throw std::runtime_error("failed to open " + path);
+
+            char magic[sizeof(kMagic)];
+            std::uint64_t count;
+            auto trace = std::make_shared<CollisionTrace>();
+            in.read(magic, sizeof(magic));
+            in.read(reinterpret_cast<char*>(&trace->iterations_), sizeof(trace->iterations_));
+            in.read(reinterpret_cast<char*>(&count), sizeof(count));
+            if (!in || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+                throw std::runtime_error("not a collision trace: " + path);
+
+            trace->records_.resize(count);
+            trace->results_.reserve(count);
+            for (Record& r : trace->records_) {
+                char result;
+                in.read(reinterpret_cast<char*>(&r.key), sizeof(r.key));
+                in.read(&result, 1);
+                r.result = result;
+                trace->results_.emplace(r.key, r.result);
+            }
+            if (!in)
+                throw std::runtime_error("truncated collision trace: " + path);
+
+            MPT_LOG(DEBUG) << "loaded " << count << " queries from " << path;
+            return trace;
+        }
+    };
+
+    // Forwards the space, bounds, and goal of the wrapped scenario.
+    template <typename Scenario>
+    class TraceScenarioBase {
+    protected:
+        Scenario scenario_;
+        std::shared_ptr<CollisionTrace> trace_;
+
+    public:
+        using Space = typename Scenario::Space;
+        using State = typename Space::Type;
+
+        TraceScenarioBase(const Scenario& scenario, std::shared_ptr<CollisionTrace> trace)
+            : scenario_(scenario)
+            , trace_(std::move(trace))
+        {
+        }
+
+        decltype(auto) space() const {
+            return scenario_.space();
+        }
+
+        // a template to only be present when the wrapped scenario
+        // has bounds.
+        template <typename S = Scenario>
+        auto bounds() const -> decltype(std::declval<const S&>().bounds()) {
+            return scenario_.bounds();
+        }
+
+        decltype(auto) goal() const {
+            return scenario_.goal();
+        }
+    };
+
+    // Since each worker copies the scenario, giving each copy its own
+    // recorder lets the workers record without contending on a lock.
+    template <typename Scenario>
+    class RecordingScenario : public TraceScenarioBase<Scenario> {
+        using Base = TraceScenarioBase<Scenario>;
+
+        std::shared_ptr<CollisionTrace::Recorder> recorder_;
+
+    public:
+        using typename Base::State;
+
+        explicit RecordingScenario(
+            const Scenario& scenario,
+            std::shared_ptr<CollisionTrace> trace = std::make_shared<CollisionTrace>())
+            : Base(scenario, std::move(trace))
+            , recorder_(this->trace_->recorder())
+        {
+        }
+
+        RecordingScenario(const RecordingScenario& other)
+            : Base(other)
+            , recorder_(this->trace_->recorder())
+        {
+        }
+
+        RecordingScenario(RecordingScenario&&) = default;
+
+        bool valid(const State& q) const {
+            bool result = this->scenario_.valid(q);
+            recorder_->record(trace::validKey(q), result);
+            return result;
+        }
+
+        bool link(const State& a, const State& b) const {
+            bool result = this->scenario_.link(a, b);
+            recorder_->record(trace::linkKey(a, b), result);
+            return result;
+        }
+    };
+
+    template <typename Scenario>
+    class ReplayScenario : public TraceScenarioBase<Scenario> {
+        using Base = TraceScenarioBase<Scenario>;
+
+        template <typename Fallback>
+        bool replay(std::uint64_t key, Fallback&& fallback) const {
+            int result = this->trace_->lookup(key);
+            if (result >= 0) {
+                this->trace_->countHit();
+                return result;
+            }
+            this->trace_->countMiss();
+            return fallback();
+        }
+
+    public:
+        using typename Base::State;
+
+        ReplayScenario(const Scenario& scenario, std::shared_ptr<CollisionTrace> trace)
+            : Base(scenario, std::move(trace))
+        {
+        }
+
+        bool valid(const State& q) const {
+            return replay(trace::validKey(q), [&] { return this->scenario_.valid(q); });
+        }
+
+        bool link(const State& a, const State& b) const {
+            return replay(trace::linkKey(a, b), [&] { return this->scenario_.link(a, b); });
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,583 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_DISTANCE_FIELD_HPP
+#define MPT_DEMO_DISTANCE_FIELD_HPP
+
+#include "mesh_cache.hpp"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A precomputed distance field of a triangle mesh environment, used
+// to classify rigid body states before running the exact (and much
+// more expensive) mesh-mesh collision check.  The robot is covered by
+// bounding spheres: when every sphere's center is farther from the
+// environment's surface than its radius, the state is clearly free.
+// When the environment mesh is closed, the field is signed, and a
+// state is clearly in collision if the (connected) robot has surface
+// points both inside and outside of the environment, since its
+// surface must then cross the environment's.  Both tests are
+// conservative, the remaining states must be checked exactly.
+//
+// As with FCL's mesh-mesh collision, collision means that the
+// surfaces intersect--a robot entirely inside a closed environment
+// mesh does not collide with it.
+//
+// Building the field takes time proportional to the number of
+// triangles times the number of grid points within the band of each,
+// which is seconds for large environments, thus the field is stored
+// in the mesh cache directory (see mesh_cache.hpp) and reused by
+// later runs with the same mesh, resolution, and band.
+
+namespace mpt_demo::impl {
+    template <typename Scalar>
+    using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+
+    // Returns the distance from p to the triangle abc.  From Ericson,
+    // Real-Time Collision Detection, 5.1.5.
+    template <typename Scalar>
+    Scalar pointTriangleDistance(const Vec3<Scalar>& p, const Vec3<Scalar>& a, const Vec3<Scalar>& b, const Vec3<Scalar>& c) {
+        Vec3<Scalar> ab = b - a, ac = c - a, ap = p - a;
+        Scalar d1 = ab.dot(ap), d2 = ac.dot(ap);
+        if (d1 <= 0 && d2 <= 0)
+            return ap.norm();
+
+        Vec3<Scalar> bp = p - b;
+        Scalar d3 = ab.dot(bp), d4 = ac.dot(bp);
+        if (d3 >= 0 && d4 <= d3)
+            return bp.norm();
+
+        Scalar vc = d1*d4 - d3*d2;
+        if (vc <= 0 && d1 >= 0 && d3 <= 0)
+            return (p - (a + ab * (d1 / (d1 - d3)))).norm();
+
+        Vec3<Scalar> cp = p - c;
+        Scalar d5 = ab.dot(cp), d6 = ac.dot(cp);
+        if (d6 >= 0 && d5 <= d6)
+            return cp.norm();
+
+        Scalar vb = d5*d2 - d1*d6;
+        if (vb <= 0 && d2 >= 0 && d6 <= 0)
+            return (p - (a + ac * (d2 / (d2 - d6)))).norm();
+
+        Scalar va = d3*d6 - d5*d4;
+        if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+            return (p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))))).norm();
+
+        Scalar denom = 1 / (va + vb + vc);
+        return (p - (a + ab * (vb * denom) + ac * (vc * denom))).norm();
+    }
+
+    // A triangle soup with the vertices merged by position, as
+    // needed to check that a mesh is closed or connected.  (FCL's
+    // BVHModel::addTriangle does not share vertices.)
+    template <typename Scalar>
+    class TriangleMesh {
+        std::vector<Vec3<Scalar>> vertices_;
+        std::vector<std::array<std::uint32_t, 3>> triangles_;
+
+        struct PositionHash {
+            std::size_t operator() (const std::array<Scalar, 3>& p) const {
+                std::size_t h = 0;
+                for (Scalar x : p)
+                    h = h * 31 + std::hash<Scalar>()(x);
+                return h;
+            }
+        };
+
+        std::unordered_map<std::array<Scalar, 3>, std::uint32_t, PositionHash> index_;
+
+        std::uint32_t vertex(const Vec3<Scalar>& v) {
+            auto [it, inserted] = index_.emplace(std::array<Scalar, 3>{v[0], v[1], v[2]}, vertices_.size());
+            if (inserted)
+                vertices_.push_back(v);
+            return it->second;
+        }
+
+    public:
+        void addTriangle(const Vec3<Scalar>& a, const Vec3<Scalar>& b, const Vec3<Scalar>& c) {
+            triangles_.push_back({ vertex(a), vertex(b), vertex(c) });
+        }
+
+        const std::vector<Vec3<Scalar>>& vertices() const { return vertices_; }
+        const std::vector<std::array<std::uint32_t, 3>>& triangles() const { return triangles_; }
+
+        Vec3<Scalar> vertex(std::size_t tri, int i) const {
+            return vertices_[triangles_[tri][i]];
+        }
+
+        // true if every edge is shared by exactly two triangles, thus
+        // the mesh has a well defined inside.
+        bool closed() const {
+            std::map<std::pair<std::uint32_t, std::uint32_t>, unsigned> edges;
+            for (const auto& t : triangles_)
+                for (int i = 0 ; i < 3 ; ++i)
+                    ++edges[std::minmax(t[i], t[(i+1)%3])];
+            return !edges.empty() && std::all_of(
+                edges.begin(), edges.end(), [] (const auto& e) { return e.second == 2; });
+        }
+
+        // true if all triangles are connected through shared vertices.
+        bool connected() const {
+            std::vector<std::uint32_t> parent(vertices_.size());
+            std::iota(parent.begin(), parent.end(), 0);
+            auto find = [&] (std::uint32_t v) {
+                while (parent[v] != v)
+                    v = parent[v] = parent[parent[v]];
+                return v;
+            };
+            for (const auto& t : triangles_) {
+                parent[find(t[1])] = find(t[0]);
+                parent[find(t[2])] = find(t[0]);
+            }
+            std::size_t roots = 0;
+            for (std::uint32_t v = 0 ; v < parent.size() ; ++v)
+                roots += (find(v) == v);
+            return roots == 1;
+        }
+
+        Eigen::AlignedBox<Scalar, 3> bounds() const {
+            Eigen::AlignedBox<Scalar, 3> box;
+            for (const Vec3<Scalar>& v : vertices_)
+                box.extend(v);
+            return box;
+        }
+    };
+
+    // The robot's bounding spheres and surface probe points, in the
+    // robot's frame.
+    template <typename Scalar>
+    class RobotProbes {
+    public:
+        struct Sphere {
+            Vec3<Scalar> center;
+            Scalar radius;
+        };
+
+    private:
+        std::vector<Sphere> spheres_;
+        std::vector<Vec3<Scalar>> points_;
+        bool connected_;
+
+    public:
+        // Covers the robot with up to divisions^3 spheres, one per
+        // cell of its bounding box, each bounding the triangles whose
+        // centroids are in the cell.  The probe points are up to
+        // maxPoints of the robot's vertices.
+        RobotProbes(const TriangleMesh<Scalar>& mesh, int divisions = 3, std::size_t maxPoints = 32)
+            : connected_(mesh.connected())
+        {
+            Eigen::AlignedBox<Scalar, 3> box = mesh.bounds();
+            Vec3<Scalar> cellSize = box.sizes() / divisions;
+            std::vector<Eigen::AlignedBox<Scalar, 3>> cells(divisions * divisions * divisions);
+            std::vector<std::vector<std::size_t>> members(cells.size());
+            for (std::size_t t = 0 ; t < mesh.triangles().size() ; ++t) {
+                Vec3<Scalar> centroid = (mesh.vertex(t, 0) + mesh.vertex(t, 1) + mesh.vertex(t, 2)) / 3;
+                int index = 0;
+                for (int i = 3 ; i-- > 0 ; ) {
+                    int c = cellSize[i] > 0 ? int((centroid[i] - box.min()[i]) / cellSize[i]) : 0;
+                    index = index * divisions + std::clamp(c, 0, divisions - 1);
+                }
+                members[index].push_back(t);
+                for (int i = 0 ; i < 3 ; ++i)
+                    cells[index].extend(mesh.vertex(t, i));
+            }
+
+            for (std::size_t c = 0 ; c < cells.size() ; ++c) {
+                if (members[c].empty())
+                    continue;
+                Sphere s{cells[c].center(), 0};
+                for (std::size_t t : members[c])
+                    for (int i = 0 ; i < 3 ; ++i)
+                        s.radius = std::max(s.radius, (mesh.vertex(t, i) - s.center).norm());
+                spheres_.push_back(s);
+            }
+
+            const auto& vertices = mesh.vertices();
+            std::size_t stride = std::max(std::size_t(1), vertices.size() / maxPoints);
+            for (std::size_t i = 0 ; i < vertices.size() ; i += stride)
+                points_.push_back(vertices[i]);
+        }
+
+        const std::vector<Sphere>& spheres() const { return spheres_; }
+        const std::vector<Vec3<Scalar>>& points() const { return points_; }
+
+        // the robot's surface is connected, a requirement of the
+        // collision test.
+        bool connected() const { return connected_; }
+
+        Scalar maxRadius() const {
+            Scalar r = 0;
+            for (const Sphere& s : spheres_)
+                r = std::max(r, s.radius);
+            return r;
+        }
+    };
+
+    enum class Prefilter {
+        kUnknown,
+        kFree,
+        kCollision,
+    };
+
+    // Converts a distance to the float stored in the field, rounding
+    // toward zero so that the stored magnitude never exceeds the
+    // actual distance, and the tests below remain conservative.
+    template <typename Scalar>
+    float toStoredDistance(Scalar d) {
+        float f = static_cast<float>(d);
+        if (std::abs(static_cast<Scalar>(f)) > std::abs(d))
+            f = std::nextafter(f, 0.0f);
+        return f;
+    }
+
+    // A grid of the (signed, when the mesh is closed) distance to the
+    // environment's surface, sampled at the grid's points.  Distances
+    // are only computed up to the band; beyond it, the grid stores the
+    // band, a lower bound.  Since distance is 1-Lipschitz, the distance
+    // at any point p is within |p - g| of the value at the nearest
+    // grid point g.
+    template <typename Scalar>
+    class DistanceField {
+        using Box = Eigen::AlignedBox<Scalar, 3>;
+
+        static constexpr char kMagic[8] = { 'M', 'P', 'T', 'S', 'D', 'F', 0, 0 };
+
+        // Bump when the layout, or how the distances are computed,
+        // changes.
+        static constexpr std::uint32_t kVersion = 1;
+
+        // The cache file is the header followed by the distances.
+        struct CacheHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t scalarSize;
+            std::uint64_t key;
+            Scalar meshMin[3];
+            Scalar meshMax[3];
+            Scalar origin[3];
+            Scalar cellSize;
+            Scalar band;
+            std::int32_t dims[3];
+            std::uint32_t isSigned;
+        };
+        static_assert(sizeof(CacheHeader) % alignof(float) == 0);
+
+        Box meshBounds_;
+        Vec3<Scalar> origin_;
+        Scalar cellSize_;
+        Scalar band_;
+        Eigen::Array3i dims_;
+        bool signed_;
+        std::vector<float> distance_;
+
+        DistanceField() = default;
+
+        std::size_t index(int i, int j, int k) const {
+            return (std::size_t(k) * dims_[1] + j) * dims_[0] + i;
+        }
+
+        Vec3<Scalar> point(int i, int j, int k) const {
+            return origin_ + Vec3<Scalar>(i, j, k) * cellSize_;
+        }
+
+        void computeDistances(const TriangleMesh<Scalar>& mesh) {
+            for (std::size_t t = 0 ; t < mesh.triangles().size() ; ++t) {
+                Vec3<Scalar> a = mesh.vertex(t, 0), b = mesh.vertex(t, 1), c = mesh.vertex(t, 2);
+                Vec3<Scalar> lo = a.cwiseMin(b).cwiseMin(c).array() - band_;
+                Vec3<Scalar> hi = a.cwiseMax(b).cwiseMax(c).array() + band_;
+                Eigen::Array3i first = ((lo - origin_) / cellSize_).array().ceil().template cast<int>().max(0);
+                Eigen::Array3i last = ((hi - origin_) / cellSize_).array().floor().template cast<int>().min(dims_ - 1);
+                for (int k = first[2] ; k <= last[2] ; ++k)
+                    for (int j = first[1] ; j <= last[1] ; ++j)
+                        for (int i = first[0] ; i <= last[0] ; ++i) {
+                            float& d = distance_[index(i, j, k)];
+                            d = std::min(d, toStoredDistance(pointTriangleDistance(point(i, j, k), a, b, c)));
+                        }
+            }
+        }
+
+        // Negates the distances inside the mesh, found by the parity
+        // of the crossings of a ray along +x through each column of
+        // grid points.  The rays are offset slightly from the grid
+        // points to avoid passing through the mesh's edges.
+        void computeSigns(const TriangleMesh<Scalar>& mesh) {
+            const Scalar dy = cellSize_ * Scalar(1.234567e-4);
+            const Scalar dz = cellSize_ * Scalar(2.345678e-4);
+            std::vector<std::vector<std::size_t>> columns(std::size_t(dims_[1]) * dims_[2]);
+            for (std::size_t t = 0 ; t < mesh.triangles().size() ; ++t) {
+                Vec3<Scalar> a = mesh.vertex(t, 0), b = mesh.vertex(t, 1), c = mesh.vertex(t, 2);
+                Vec3<Scalar> lo = a.cwiseMin(b).cwiseMin(c), hi = a.cwiseMax(b).cwiseMax(c);
+                int j0 = std::max(0, int(std::ceil((lo[1] - dy - origin_[1]) / cellSize_)));
+                int j1 = std::min(dims_[1] - 1, int(std::floor((hi[1] - dy - origin_[1]) / cellSize_)));
+                int k0 = std::max(0, int(std::ceil((lo[2] - dz - origin_[2]) / cellSize_)));
+                int k1 = std::min(dims_[2] - 1, int(std::floor((hi[2] - dz - origin_[2]) / cellSize_)));
+                for (int k = k0 ; k <= k1 ; ++k)
+                    for (int j = j0 ; j <= j1 ; ++j)
+                        columns[std::size_t(k) * dims_[1] + j].push_back(t);
+            }
+
+            std::vector<Scalar> crossings;
+            for (int k = 0 ; k < dims_[2] ; ++k) {
+                for (int j = 0 ; j < dims_[1] ; ++j) {
+                    Scalar y = origin_[1] + j * cellSize_ + dy;
+                    Scalar z = origin_[2] + k * cellSize_ + dz;
+                    crossings.clear();
+                    for (std::size_t t : columns[std::size_t(k) * dims_[1] + j]) {
+                        Vec3<Scalar> a = mesh.vertex(t, 0), b = mesh.vertex(t, 1), c = mesh.vertex(t, 2);
+                        // barycentric coordinates of (y,z) in the
+                        // triangle's projection onto the yz plane
+                        Scalar det = (b[1] - a[1]) * (c[2] - a[2]) - (c[1] - a[1]) * (b[2] - a[2]);
+                        if (det == 0)
+                            continue;
+                        Scalar u = ((y - a[1]) * (c[2] - a[2]) - (c[1] - a[1]) * (z - a[2])) / det;
+                        Scalar v = ((b[1] - a[1]) * (z - a[2]) - (y - a[1]) * (b[2] - a[2])) / det;
+                        if (u < 0 || v < 0 || u + v > 1)
+                            continue;
+                        crossings.push_back(a[0] + u * (b[0] - a[0]) + v * (c[0] - a[0]));
+                    }
+                    std::sort(crossings.begin(), crossings.end());
+                    std::size_t n = 0;
+                    for (int i = 0 ; i < dims_[0] ; ++i) {
+                        Scalar x = origin_[0] + i * cellSize_;
+                        while (n < crossings.size() && crossings[n] < x)
+                            ++n;
+                        if (n & 1)
+                            distance_[index(i, j, k)] = -distance_[index(i, j, k)];
+                    }
+                }
+            }
+        }
+
+        // the signed distance at the nearest grid point to p, and the
+        // distance from p to that grid point.
+        std::pair<Scalar, Scalar> sample(const Vec3<Scalar>& p) const {
+            Vec3<Scalar> g = (p - origin_) / cellSize_;
+            Eigen::Array3i i = g.array().round().template cast<int>();
+            if ((i < 0).any() || (i >= dims_).any())
+                return { band_, 0 }; // outside the grid, at least band_ outside the mesh
+            return { Scalar(distance_[index(i[0], i[1], i[2])]),
+                     (g - i.template cast<Scalar>().matrix()).norm() * cellSize_ };
+        }
+
+    public:
+        // Builds the field over the mesh's bounds, with maxCells
+        // cells along the longest axis, computing distances up to band
+        // (plus a cell to cover the sampling error), which should be at
+        // least the largest robot sphere's radius.
+        DistanceField(const TriangleMesh<Scalar>& mesh, int maxCells, Scalar band)
+            : meshBounds_(mesh.bounds())
+            , signed_(mesh.closed())
+        {
+            cellSize_ = meshBounds_.sizes().maxCoeff() / maxCells;
+            band_ = band + cellSize_;
+            origin_ = meshBounds_.min().array() - band_;
+            dims_ = ((meshBounds_.sizes().array() + 2 * band_) / cellSize_).ceil().template cast<int>() + 1;
+            distance_.assign(std::size_t(dims_.prod()), toStoredDistance(band_));
+            computeDistances(mesh);
+            if (signed_)
+                computeSigns(mesh);
+        }
+
+        // Loads a field stored by store() under the given key, returns
+        // null if the file does not exist or does not match.
+        static std::unique_ptr<DistanceField> load(const std::string& path, std::uint64_t key) {
+            MappedFile file(path);
+            if (!file.valid() || file.size() < sizeof(CacheHeader))
+                return nullptr;
+
+            CacheHeader header;
+            std::memcpy(&header, file.data(), sizeof(header));
+            Eigen::Array3i dims(header.dims[0], header.dims[1], header.dims[2]);
+            if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+                header.version != kVersion ||
+                header.scalarSize != sizeof(Scalar) ||
+                header.key != key ||
+                (dims <= 0).any() ||
+                file.size() != sizeof(CacheHeader) + std::size_t(dims.prod()) * sizeof(float))
+            {
+                MPT_LOG(WARN) << "ignoring invalid distance field cache file " << path;
+                return nullptr;
+            }
+
+            std::unique_ptr<DistanceField> field(new DistanceField());
+            field->meshBounds_ = Box(Eigen::Map<const Vec3<Scalar>>(header.meshMin),
+                                     Eigen::Map<const Vec3<Scalar>>(header.meshMax));
+            field->origin_ = Eigen::Map<const Vec3<Scalar>>(header.origin);
+            field->cellSize_ = header.cellSize;
+            field->band_ = header.band;
+            field->dims_ = dims;
+            field->signed_ = header.isSigned != 0;
+            const float *d = reinterpret_cast<const float*>(file.data() + sizeof(CacheHeader));
+            field->distance_.assign(d, d + dims.prod());
+            return field;
+        }
+
+        // Stores the field for load().  Failing to write the file is
+        // not an error, the next run will build the field again.
+        void store(const std::string& path, std::uint64_t key) const {
+            CacheHeader header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.scalarSize = sizeof(Scalar);
+            header.key = key;
+            Eigen::Map<Vec3<Scalar>>(header.meshMin) = meshBounds_.min();
+            Eigen::Map<Vec3<Scalar>>(header.meshMax) = meshBounds_.max();
+            Eigen::Map<Vec3<Scalar>>(header.origin) = origin_;
+            header.cellSize = cellSize_;
+            header.band = band_;
+            for (int i = 0 ; i < 3 ; ++i)
+                header.dims[i] = dims_[i];
+            header.isSigned = signed_;
+            writeCacheFile(path, &header, sizeof(header),
+                           distance_.data(), distance_.size() * sizeof(float));
+        }
+
+        Scalar cellSize() const { return cellSize_; }
+        Scalar band() const { return band_; }
+        const Eigen::Array3i& dims() const { return dims_; }
+        bool isSigned() const { return signed_; }
+
+        std::size_t memoryUsage() const {
+            return distance_.size() * sizeof(float);
+        }
+
+        // a lower bound on the distance from p to the surface.
+        Scalar lowerBound(const Vec3<Scalar>& p) const {
+            auto [d, err] = sample(p);
+            return std::max(Scalar(0), std::abs(d) - err);
+        }
+
+        // true if p is certainly inside/outside the (closed) mesh.
+        bool inside(const Vec3<Scalar>& p) const {
+            auto [d, err] = sample(p);
+            return d + err < 0;
+        }
+
+        bool outside(const Vec3<Scalar>& p) const {
+            auto [d, err] = sample(p);
+            return d - err > 0;
+        }
+
+        // Classifies the robot at the given transform.
+        template <typename Transform>
+        Prefilter classify(const RobotProbes<Scalar>& robot, const Transform& tf) const {
+            bool free = true;
+            for (const auto& s : robot.spheres())
+                if (lowerBound(tf * s.center) <= s.radius) {
+                    free = false;
+                    break;
+                }
+            if (free)
+                return Prefilter::kFree;
+
+            if (signed_ && robot.connected()) {
+                bool in = false, out = false;
+                for (const Vec3<Scalar>& p : robot.points()) {
+                    Vec3<Scalar> q = tf * p;
+                    in = in || inside(q);
+                    out = out || outside(q);
+                    if (in && out)
+                        return Prefilter::kCollision;
+                }
+            }
+
+            return Prefilter::kUnknown;
+        }
+
+        // A lower bound on the distance between the surfaces of the
+        // robot and the environment, 0 if they may touch.
+        template <typename Transform>
+        Scalar clearance(const RobotProbes<Scalar>& robot, const Transform& tf) const {
+            Scalar c = std::numeric_limits<Scalar>::infinity();
+            for (const auto& s : robot.spheres())
+                c = std::min(c, lowerBound(tf * s.center) - s.radius);
+            return std::max(Scalar(0), c);
+        }
+    };
+
+    // Returns the distance field of the mesh (see the DistanceField
+    // constructor), loading it from the cache directory when it was
+    // built by a previous run, and storing it there otherwise.
+    // fromCache is set to whether it was loaded.
+    template <typename Scalar>
+    std::shared_ptr<const DistanceField<Scalar>> cachedDistanceField(
+        const TriangleMesh<Scalar>& mesh, int maxCells, Scalar band, bool& fromCache)
+    {
+        fromCache = false;
+        std::string dir = MeshCache<Scalar>::directory();
+        if (dir.empty())
+            return std::make_shared<const DistanceField<Scalar>>(mesh, maxCells, band);
+
+        // the key identifies the triangles and the parameters, thus
+        // an edited mesh (or import options) misses the cache.
+        std::uint64_t key = fnv1a(&maxCells, sizeof(maxCells));
+        key = fnv1a(&band, sizeof(band), key);
+        for (const Vec3<Scalar>& v : mesh.vertices())
+            key = fnv1a(v.data(), 3 * sizeof(Scalar), key);
+        key = fnv1a(mesh.triangles().data(), mesh.triangles().size() * sizeof(mesh.triangles()[0]), key);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.sdf", static_cast<unsigned long long>(key));
+        std::string path = dir + "/" + name;
+
+        if (auto field = DistanceField<Scalar>::load(path, key)) {
+            fromCache = true;
+            return field;
+        }
+
+        auto field = std::make_shared<const DistanceField<Scalar>>(mesh, maxCells, band);
+        field->store(path, key);
+        return field;
+    }
+}
+
+#endif
@@ -39,10 +39,12 @@
 
 
 #include "shape_hierarchy.hpp"
+#include "shape_grid.hpp"
 #include <mpt/lp_space.hpp>
 #include <mpt/box_bounds.hpp>
 #include <mpt/goal_state.hpp>
 #include <Eigen/Dense>
+#include <memory>
 #include <vector>
 
 namespace mpt_demo {
@@ -67,6 +69,10 @@ namespace mpt_demo {
         Goal goal_;
         Space space_;
 
+        // index of the obstacles for valid() and link(), shared
+        // between the copies of the scenario.
+        std::shared_ptr<const ShapeGrid<Scalar>> grid_;
+
         Bounds makeBounds() {
             Eigen::Matrix<Scalar, 2, 1> min, max;
             min.fill(0);
@@ -88,28 +94,18 @@ namespace mpt_demo {
               circles_(circles),
               rects_(rects),
               bounds_(makeBounds()),
-              goal_(1e-6, goalState)
+              goal_(1e-6, goalState),
+              grid_(std::make_shared<const ShapeGrid<Scalar>>(
+                        circles_, rects_, State(0, 0), State(width_, height_)))
         {            
         }
 
         bool valid(const State &q) const {
-            for (auto const &c : circles_)
-                if (!c.pointIsValid(q))
-                    return false;
-            for (auto const &r : rects_)
-                if (!r.pointIsValid(q))
-                    return false;
-            return true;
+            return grid_->pointIsValid(q);
         }
 
         bool link(const State &a, const State &b) const {
-            for (auto const &c : circles_)
-                if (!c.segmentIsValid(a, b))
-                    return false;
-            for (auto const &r : rects_)
-                if (!r.segmentIsValid(a, b))
-                    return false;
-            return true;
+            return grid_->segmentIsValid(a, b);
         }
 
         const std::vector<Circle<Scalar>> &circles() const{
@@ -0,0 +1,414 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+// Time-to-first-solution latency benchmark.  Runs each planner on
+// each scenario many times with independent seeds, and reports the
+// distribution of the time to the first solution (percentiles up to
+// p99.9 and the maximum) per planner and thread count, along with the
+// fraction of trials that failed to solve by each deadline.  This is
+// the measurement to use when the objective is the tail latency of
+// planning, rather than the mean.  Example:
+//
+//    latency_benchmark -c nao_cup -a prrt -j 1,4 -n 5000 -D 10,50,100
+//
+// Each trial stops at its first solution.  To keep thousands of
+// trials fast, planners that support reset() are constructed once
+// per thread count and reset with the next seed between trials,
+// avoiding the per-trial copies of the scenario.  Other planners are
+// constructed for each trial.
+
+// The planners log each solve and solution at INFO, which would
+// swamp the output over thousands of trials.
+#ifndef MPT_LOG_LEVEL
+#define MPT_LOG_LEVEL WARN
+#endif
+
+#include "benchmark.hpp"
+#include "benchmark_scenarios.hpp"
+#include <mpt/pprm.hpp>
+#include <mpt/pprm_irs.hpp>
+#include <mpt/prrt.hpp>
+#include <mpt/prrt_star.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <type_traits>
+
+namespace mpt_demo {
+    using namespace unc::robotics::mpt;
+
+    struct LatencyBenchmarkOptions : BenchmarkOptions, BenchmarkScenarioOptions {
+        std::vector<std::string> planners;
+
+        // deadlines (in seconds) at which to report the failure rate
+        std::vector<double> deadlines{0.01, 0.1};
+
+        std::string output;
+
+        bool plannerSelected(const std::string& name) const {
+            return benchmarkSelected(planners, name);
+        }
+    };
+
+    template <typename P, typename = void>
+    struct has_reset : std::false_type {};
+
+    template <typename P>
+    struct has_reset<P, std::void_t<decltype(std::declval<P&>().reset(std::declval<const BenchmarkSeed&>()))>>
+        : std::true_type {};
+
+    // The trials of one planner on one scenario with a given thread
+    // count.
+    struct LatencySample {
+        unsigned threads{0};
+        bool reused{false};
+
+        // time to first solution of each trial in seconds, infinity
+        // if unsolved within the time limit.  Sorted after the runs.
+        std::vector<double> times;
+
+        // total time spent constructing or resetting planners
+        double setupTime{0};
+
+        // The nearest-rank percentile (0 < p <= 100) of the times.
+        double percentile(double p) const {
+            std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100 * times.size()));
+            return times[std::min(std::max(rank, std::size_t(1)), times.size()) - 1];
+        }
+
+        double mean() const {
+            double sum = 0;
+            for (double t : times)
+                sum += t;
+            return sum / times.size();
+        }
+
+        // the fraction of trials not solved by the deadline
+        double failureRate(double deadline) const {
+            auto solved = std::upper_bound(times.begin(), times.end(), deadline) - times.begin();
+            return 1.0 - double(solved) / times.size();
+        }
+    };
+
+    template <typename Algorithm, typename Scenario, typename State>
+    LatencySample runTrials(
+        const Scenario& scenario, const State& start,
+        unsigned threads, const LatencyBenchmarkOptions& options)
+    {
+        using Clock = std::chrono::steady_clock;
+        using P = Planner<Scenario, Algorithm>;
+
+#ifdef _OPENMP
+        omp_set_num_threads(static_cast<int>(threads));
+#endif
+
+        LatencySample sample;
+        sample.threads = threads;
+        sample.reused = has_reset<P>::value;
+        sample.times.reserve(options.seeds);
+
+        std::optional<P> planner;
+        for (unsigned i = 0 ; i < options.seeds ; ++i) {
+            BenchmarkSeed seed(options.firstSeed + i);
+            Clock::time_point setupStart = Clock::now();
+            if constexpr (has_reset<P>::value) {
+                if (planner)
+                    planner->reset(seed);
+                else
+                    planner.emplace(scenario, seed);
+            } else {
+                planner.reset();
+                planner.emplace(scenario, seed);
+            }
+            planner->addStart(start);
+
+            Clock::time_point startTime = Clock::now();
+            Clock::time_point deadline = startTime + options.timeLimit;
+            double t = std::numeric_limits<double>::infinity();
+            planner->solve([&] {
+                Clock::time_point now = Clock::now();
+                if (planner->solved()) {
+                    t = std::chrono::duration<double>(now - startTime).count();
+                    return true;
+                }
+                return now >= deadline;
+            });
+            sample.setupTime += std::chrono::duration<double>(startTime - setupStart).count();
+            sample.times.push_back(t);
+        }
+
+        std::sort(sample.times.begin(), sample.times.end());
+        return sample;
+    }
+
+    static const double kPercentiles[] = { 50, 90, 99, 99.9 };
+
+    void report(
+        std::ostream& out,
+        const std::string& plannerName, const std::string& scenarioName,
+        const std::vector<LatencySample>& samples, const std::vector<double>& deadlines)
+    {
+        auto ms = [] (double t) {
+            std::ostringstream str;
+            if (std::isfinite(t))
+                str << std::fixed << std::setprecision(3) << t * 1e3;
+            else
+                str << "fail";
+            return str.str();
+        };
+
+        out << "\n" << plannerName << " on " << scenarioName << " (times in ms)\n"
+            << std::setw(8) << "threads"
+            << std::setw(8) << "trials"
+            << std::setw(11) << "min";
+        for (double p : kPercentiles) {
+            std::ostringstream name;
+            name << 'p' << p;
+            out << std::setw(11) << name.str();
+        }
+        out << std::setw(11) << "max"
+            << std::setw(11) << "mean";
+        for (double d : deadlines) {
+            std::ostringstream name;
+            name << "fail@" << d * 1e3;
+            out << std::setw(14) << name.str();
+        }
+        out << std::setw(12) << "setup" << "\n";
+
+        std::ios::fmtflags flags = out.flags();
+        for (const LatencySample& s : samples) {
+            out << std::setw(8) << s.threads
+                << std::setw(8) << s.times.size()
+                << std::setw(11) << ms(s.times.front());
+            for (double p : kPercentiles)
+                out << std::setw(11) << ms(s.percentile(p));
+            out << std::setw(11) << ms(s.times.back())
+                << std::setw(11) << ms(s.mean())
+                << std::fixed << std::setprecision(2);
+            for (double d : deadlines)
+                out << std::setw(13) << 100 * s.failureRate(d) << '%';
+            out << std::setw(12) << ms(s.setupTime / s.times.size())
+                << (s.reused ? " (reset)" : " (construct)") << "\n";
+            out.flags(flags);
+        }
+    }
+
+    void writeJson(
+        std::ostream& out, const std::string& label,
+        const std::string& plannerName, const std::string& scenarioName,
+        const LatencySample& s, const std::vector<double>& deadlines)
+    {
+        auto num = [&] (double v) -> std::ostream& {
+            return std::isfinite(v) ? (out << v) : (out << "null");
+        };
+
+        out << "{\"label\":\"" << jsonEscape(label)
+            << "\",\"planner\":\"" << jsonEscape(plannerName)
+            << "\",\"scenario\":\"" << jsonEscape(scenarioName)
+            << "\",\"threads\":" << s.threads
+            << ",\"trials\":" << s.times.size()
+            << ",\"percentiles\":{";
+        for (std::size_t i = 0 ; i < std::size(kPercentiles) ; ++i) {
+            out << (i ? ",\"" : "\"") << kPercentiles[i] << "\":";
+            num(s.percentile(kPercentiles[i]));
+        }
+        out << "},\"failure_rate\":{";
+        for (std::size_t i = 0 ; i < deadlines.size() ; ++i)
+            out << (i ? ",\"" : "\"") << deadlines[i] << "\":" << s.failureRate(deadlines[i]);
+        out << "},\"setup_time\":" << s.setupTime / s.times.size()
+            << ",\"first_solution_times\":[";
+        for (std::size_t i = 0 ; i < s.times.size() ; ++i) {
+            if (i) out << ',';
+            num(s.times[i]);
+        }
+        out << "]}\n";
+    }
+
+    template <typename Fn>
+    void forEachLatencyPlanner(const LatencyBenchmarkOptions& options, Fn&& fn) {
+        if (options.plannerSelected("prrt"))
+            fn(PlannerType<PRRT<>>{}, "prrt");
+        if (options.plannerSelected("prrt_star_k"))
+            fn(PlannerType<PRRTStar<rewire_k_nearest>>{}, "prrt_star_k");
+        if (options.plannerSelected("prrt_star_r"))
+            fn(PlannerType<PRRTStar<rewire_r_nearest>>{}, "prrt_star_r");
+        if (options.plannerSelected("pprm"))
+            fn(PlannerType<PPRM<>>{}, "pprm");
+        if (options.plannerSelected("pprm_irs"))
+            fn(PlannerType<PPRMIRS<>>{}, "pprm_irs");
+    }
+
+    std::vector<double> parseDeadlines(const std::string& arg) {
+        std::vector<double> deadlines;
+        std::istringstream in(arg);
+        for (std::string item ; std::getline(in, item, ',') ; )
+            deadlines.push_back(parseDouble(item, "deadline") / 1e3);
+        return deadlines;
+    }
+
+    LatencyBenchmarkOptions parseOptions(int argc, char *argv[]) {
+        static struct option longOptions[] = {
+            { "time-limit", required_argument, 0, 't' },
+            { "threads", required_argument, 0, 'j' },
+            { "trials", required_argument, 0, 'n' },
+            { "first-seed", required_argument, 0, 's' },
+            { "deadlines", required_argument, 0, 'D' },
+            { "planner", required_argument, 0, 'a' },
+            { "scenario", required_argument, 0, 'c' },
+            { "dimensions", required_argument, 0, 'd' },
+            { "se3", required_argument, 0, 'e' },
+            { "png", required_argument, 0, 'p' },
+            { "output", required_argument, 0, 'o' },
+            { "label", required_argument, 0, 'l' },
+            { nullptr, 0, nullptr, 0 }
+        };
+
+        LatencyBenchmarkOptions options;
+        options.seeds = 1000;
+        options.timeLimit = std::chrono::milliseconds(1000);
+        for (int c, optInd ; -1 != (c=getopt_long(argc, argv, "t:j:n:s:D:a:c:d:e:p:o:l:", longOptions, &optInd)) ; ) {
+            switch (c) {
+            case 't':
+                options.timeLimit = std::chrono::milliseconds(parseNonNegative(optarg, "time limit"));
+                break;
+            case 'j':
+                options.threads = parseThreads(optarg);
+                break;
+            case 'n':
+                options.seeds = std::max(1, parseNonNegative(optarg, "trial count"));
+                break;
+            case 's':
+                options.firstSeed = parseNonNegative(optarg, "seed");
+                break;
+            case 'D':
+                options.deadlines = parseDeadlines(optarg);
+                break;
+            case 'a':
+                options.planners.push_back(optarg);
+                break;
+            case 'c':
+                options.scenarios.push_back(optarg);
+                break;
+            case 'd':
+                options.syntheticDimensions = parseSyntheticDimensions(optarg);
+                break;
+            case 'e':
+                options.se3Configs.push_back(optarg);
+                break;
+            case 'p':
+                options.pngFile = optarg;
+                break;
+            case 'o':
+                options.output = optarg;
+                break;
+            case 'l':
+                options.label = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [options]\n"
+                    "Options:\n"
+                    "  -t --time-limit=T    Fail trials unsolved after T milliseconds (default 1000)\n"
+                    "  -j --threads=N,...   Thread counts to run with (default 1)\n"
+                    "  -n --trials=N        Number of trials (seeds) per thread count (default 1000)\n"
+                    "  -s --first-seed=S    First seed (default 1)\n"
+                    "  -D --deadlines=MS,.. Report the failure rate at these deadlines in\n"
+                    "                       milliseconds (default 10,100, and the time limit)\n"
+                    "  -a --planner=P       Run planner P (prrt, prrt_star_k, prrt_star_r, pprm, pprm_irs),\n"
+                    "                       may be repeated, default is all planners\n"
+                    "  -c --scenario=S      Run scenario S (holonomic_2d, png_2d, link_manipulator,\n"
+                    "                       nao_cup, synthetic, se3), may be repeated, default is all\n"
+                    "  -d --dimensions=N,...  Dimensions of the synthetic scenario (default 8)\n"
+                    "  -e --se3=FILE        Add an OMPL.app SE(3) configuration file\n"
+                    "  -p --png=FILE        Input image for png_2d (default png_planning_input.png)\n"
+                    "  -o --output=FILE     Also append the distributions as JSON to FILE\n"
+                    "  -l --label=L         Label the results, e.g., with the build being tested\n"
+                          << std::flush;
+                throw std::invalid_argument("unrecognized option");
+            }
+        }
+
+        // the failure rate at the time limit is always reported
+        double limit = std::chrono::duration<double>(options.timeLimit).count();
+        options.deadlines.erase(
+            std::remove_if(options.deadlines.begin(), options.deadlines.end(),
+                           [&] (double d) { return d >= limit; }),
+            options.deadlines.end());
+        options.deadlines.push_back(limit);
+        std::sort(options.deadlines.begin(), options.deadlines.end());
+
+        return options;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace mpt_demo;
+
+    try {
+        LatencyBenchmarkOptions options = parseOptions(argc, argv);
+        std::ofstream json;
+        if (!options.output.empty()) {
+            json.open(options.output, std::ios::app);
+            if (!json)
+                throw std::runtime_error("failed to open " + options.output);
+        }
+
+        forEachScenario(options, [&] (const std::string& scenarioName, const auto& scenario, const auto& start) {
+            forEachLatencyPlanner(options, [&] (auto type, const std::string& plannerName) {
+                using Algorithm = typename decltype(type)::type;
+                std::vector<LatencySample> samples;
+                for (unsigned threads : options.threads) {
+                    std::cerr << "running " << options.seeds << " trials of " << plannerName
+                              << " on " << scenarioName << " with " << threads << " threads" << std::endl;
+                    samples.push_back(runTrials<Algorithm>(scenario, start, threads, options));
+                    if (json.is_open())
+                        writeJson(json, options.label, plannerName, scenarioName,
+                                  samples.back(), options.deadlines);
+                }
+                report(std::cout, plannerName, scenarioName, samples, options.deadlines);
+            });
+        });
+
+        return 0;
+    } catch (const std::exception& ex) {
+        MPT_LOG(FATAL) << "terminated with exception: " << ex.what();
+        return 1;
+    }
+}
@@ -42,6 +42,9 @@
 #include <mpt/box_bounds.hpp>
 #include <mpt/goal_state.hpp>
 #include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <vector>
 #include <cmath>
 
@@ -51,6 +54,56 @@ template <class T> constexpr T PI = T(3.1415926535897932384626433832795028841971
 
 namespace mpt_demo
 {
+    namespace impl
+    {
+        // sin and cos of x, written with branch-free arithmetic so that
+        // loops calling it vectorize (the libm functions do not, without
+        // -ffast-math).  It reduces x to [-pi/4, pi/4] by multiples of
+        // pi/2 (with pi/2 split in three parts to keep the reduction
+        // exact), then evaluates the Cephes minimax polynomials, which
+        // are accurate to about 1 ulp in double for |x| < 2^20.
+        template <typename Scalar>
+        inline void sincos(Scalar x, Scalar &s, Scalar &c)
+        {
+            constexpr double kTwoOverPi = 0.63661977236758134308;
+            constexpr double kDP1 = 1.57079625129699707031;
+            constexpr double kDP2 = 7.54978941586159635335E-8;
+            constexpr double kDP3 = 5.39030285815811905290E-15;
+
+            // rounds to the nearest integer by adding and subtracting
+            // 1.5 * 2^52, which, unlike std::nearbyint, vectorizes on
+            // any SSE2 target.
+            constexpr double kRound = 6755399441055744.0;
+
+            double xd = x;
+            double q = (xd * kTwoOverPi + kRound) - kRound;
+            double z = ((xd - q * kDP1) - q * kDP2) - q * kDP3;
+            double zz = z * z;
+
+            double sz = z + z * zz * (((((
+                1.58962301576546568060E-10 * zz
+                - 2.50507477628578072866E-8) * zz
+                + 2.75573136213857245213E-6) * zz
+                - 1.98412698295895385996E-4) * zz
+                + 8.33333333332211858878E-3) * zz
+                - 1.66666666666666307295E-1);
+            double cz = 1.0 - 0.5 * zz + zz * zz * (((((
+                - 1.13585365213876817300E-11 * zz
+                + 2.08757008419747316778E-9) * zz
+                - 2.75573141792967388112E-7) * zz
+                + 2.48015872888517045348E-5) * zz
+                - 1.38888888888730564116E-3) * zz
+                + 4.16666666666665929218E-2);
+
+            // rotate (cz, sz) by q quarter turns
+            int quadrant = int(q) & 3;
+            double ss = (quadrant & 1) ? cz : sz;
+            double cc = (quadrant & 1) ? sz : cz;
+            s = Scalar((quadrant & 2) ? -ss : ss);
+            c = Scalar(((quadrant + 1) & 2) ? -cc : cc);
+        }
+    }
+
     template <typename Scalar, int dimensions>
     class LinkManipulatorScenario
     {
@@ -72,6 +125,15 @@ namespace mpt_demo
         std::vector<Scalar> armLengths_;
         Scalar radius_;
 
+        // the circles in SoA layout, with the squared distance that
+        // the arm must keep from their centers, for validBatch.
+        std::vector<Scalar> circleX_;
+        std::vector<Scalar> circleY_;
+        std::vector<Scalar> circleMinDistSquared_;
+
+        // states checked at a time by validBatch
+        static constexpr std::size_t kBatchSize = 64;
+
     public:
         LinkManipulatorScenario(
             State goalState,
@@ -86,6 +148,12 @@ namespace mpt_demo
             armLengths_(armLengths),
             radius_(radius)
         {
+            for (const auto &c : circles_)
+            {
+                circleX_.push_back(c.cx());
+                circleY_.push_back(c.cy());
+                circleMinDistSquared_.push_back((c.r() + radius_) * (c.r() + radius_));
+            }
         }
 
         static Bounds makeBounds()
@@ -122,19 +190,93 @@ namespace mpt_demo
             return bisectLink(a, b);
         }
 
+        // Returns true if all n (at most kBatchSize) states are valid.
+        // Computes the forward kinematics of all states at once, one
+        // link at a time, with the states in the inner loops so that
+        // they vectorize.
+        bool validBatch(const State *qs, std::size_t n) const
+        {
+            assert(n <= kBatchSize);
+
+            // transpose the joint angles to SoA, as cumulative angles
+            std::array<std::array<Scalar, kBatchSize>, dimensions> angle;
+            for (std::size_t j = 0; j < n; j++)
+            {
+                Scalar sum = 0;
+                for (int i = 0; i < dimensions; i++)
+                    angle[i][j] = sum += qs[j][i];
+            }
+
+            std::array<Scalar, kBatchSize> fromX, fromY, toX, toY, s, c;
+            std::fill_n(fromX.begin(), n, Scalar(0));
+            std::fill_n(fromY.begin(), n, Scalar(0));
+            for (int i = 0; i < dimensions; i++)
+            {
+                for (std::size_t j = 0; j < n; j++)
+                    impl::sincos(angle[i][j], s[j], c[j]);
+
+                Scalar length = armLengths_[i];
+                for (std::size_t j = 0; j < n; j++)
+                {
+                    toX[j] = fromX[j] + length * c[j];
+                    toY[j] = fromY[j] + length * s[j];
+                }
+
+                // squared distance from each circle's center to the
+                // segment (from, to), by clamping the projection
+                // instead of branching.  Counting the collisions
+                // (rather than setting a flag) keeps the loop a
+                // vectorizable reduction.
+                int collisions = 0;
+                for (std::size_t k = 0; k < circleX_.size(); k++)
+                {
+                    for (std::size_t j = 0; j < n; j++)
+                    {
+                        Scalar vx = toX[j] - fromX[j];
+                        Scalar vy = toY[j] - fromY[j];
+                        Scalar wx = circleX_[k] - fromX[j];
+                        Scalar wy = circleY_[k] - fromY[j];
+                        Scalar t = std::clamp((vx * wx + vy * wy) / (vx * vx + vy * vy), Scalar(0), Scalar(1));
+                        Scalar dx = wx - t * vx;
+                        Scalar dy = wy - t * vy;
+                        collisions += dx * dx + dy * dy <= circleMinDistSquared_[k];
+                    }
+                }
+                if (collisions)
+                    return false;
+
+                std::copy_n(toX.begin(), n, fromX.begin());
+                std::copy_n(toY.begin(), n, fromY.begin());
+            }
+            return true;
+        }
+
+        // Checks the same states as bisecting recursively until the
+        // intervals are below the tolerance, but breadth first: each
+        // level checks the midpoints of all of the intervals of the
+        // previous level, in batches.  Coarse levels are still checked
+        // first, so invalid motions are usually rejected early.
         bool bisectLink(const State &a, const State &b) const
         {
-            State diff = a - b;
+            State diff = b - a;
             Scalar maxAngleDiff = diff.template lpNorm<Eigen::Infinity>();
             constexpr Scalar tolerance = 0.02; // 0.02 rad ~= 1 degree
-            if (maxAngleDiff < tolerance)
-                return true;
-            State mid = (a + b) / 2;
-            if (!valid(mid))
-                return false;
-            if (!bisectLink(a, mid))
-                return false;
-            return bisectLink(mid, b);
+            std::array<State, kBatchSize> batch;
+            for (std::size_t count = 1; maxAngleDiff >= tolerance; count *= 2, maxAngleDiff /= 2)
+            {
+                std::size_t n = 0;
+                for (std::size_t k = 0; k < count; k++)
+                {
+                    batch[n++] = a + diff * (Scalar(2 * k + 1) / Scalar(2 * count));
+                    if (n == kBatchSize || k + 1 == count)
+                    {
+                        if (!validBatch(batch.data(), n))
+                            return false;
+                        n = 0;
+                    }
+                }
+            }
+            return true;
         }
 
         const Space &space() const
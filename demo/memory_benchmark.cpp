@@ -0,0 +1,615 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+
+// Memory footprint benchmark.  Grows each planner to fixed node
+// counts in representative spaces (L2 in 2 and 10 dimensions, and
+// SE(3) in float and double), and reports the bytes actually
+// allocated per node and per edge, broken down by the planner's
+// allocation sites: the node, edge, and component pools, the link()
+// trajectories, and the nearest neighbor index.  Example:
+//
+//    memory_benchmark -a prrt_star_k -n 10000,100000 -w 4 -o memory.jsonl
+//
+// The counts come from the replacement operator new below, which
+// attributes each allocation to the site the planner declared with
+// MPT_TRACK_ALLOCATIONS (see mpt/memory_usage.hpp).  The scenarios
+// are obstacle free and the goal is unreachable, since the footprint
+// depends only on the state type and what link() returns.  With
+// --waypoints, link() returns a std::shared_ptr to a std::vector of
+// that many states, to measure the overhead of shared trajectories.
+//
+// Per node, the report compares the measured bytes to the planners'
+// memoryUsage() estimate, and "B/edge" divides the edge pools' bytes
+// by the edges in the graph.  The difference is the overhead that the
+// estimate does not see: the std::shared_ptr control blocks, the
+// std::deque block maps, and the nearest neighbor index's spare
+// capacity.  The "malloc" column is the allocator's size class
+// rounding and per-chunk header, and "state" is the payload of a
+// node, the rest of a node's bytes are its links and padding.
+
+#define MPT_TRACK_ALLOCATIONS
+
+#ifndef MPT_LOG_LEVEL
+#define MPT_LOG_LEVEL WARN
+#endif
+
+#include "benchmark.hpp"
+#include "benchmark_scenarios.hpp"
+#include <mpt/box_bounds.hpp>
+#include <mpt/goal_state.hpp>
+#include <mpt/lp_space.hpp>
+#include <mpt/memory_usage.hpp>
+#include <mpt/pprm.hpp>
+#include <mpt/pprm_irs.hpp>
+#include <mpt/prrt.hpp>
+#include <mpt/prrt_star.hpp>
+#include <mpt/unbounded.hpp>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <tuple>
+#include <vector>
+#if BENCHMARK_SE3
+#include <mpt/se3_space.hpp>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace mpt_demo {
+    using namespace unc::robotics::mpt;
+
+    // Heap usage of one allocation site.  requested is the sum of the
+    // sizes passed to operator new, usable the sum of the sizes malloc
+    // reserved for them.
+    struct AllocationStats {
+        std::ptrdiff_t count{0};
+        std::ptrdiff_t requested{0};
+        std::ptrdiff_t usable{0};
+
+        // glibc's per-chunk header, which is not included in the
+        // usable size.
+        static constexpr std::ptrdiff_t kChunkHeader = sizeof(std::size_t);
+
+        std::ptrdiff_t bytes() const {
+            return usable + count * kChunkHeader;
+        }
+
+        AllocationStats operator - (const AllocationStats& other) const {
+            return { count - other.count, requested - other.requested, usable - other.usable };
+        }
+
+        AllocationStats& operator += (const AllocationStats& other) {
+            count += other.count;
+            requested += other.requested;
+            usable += other.usable;
+            return *this;
+        }
+    };
+
+    using SiteStats = std::array<AllocationStats, kAllocationSiteCount>;
+
+    class AllocationCounter {
+        struct Counters {
+            std::atomic<std::ptrdiff_t> count{0};
+            std::atomic<std::ptrdiff_t> requested{0};
+            std::atomic<std::ptrdiff_t> usable{0};
+        };
+
+        // Each block is preceded by a header recording its site and
+        // size, so that it is subtracted from the site it was
+        // allocated from, regardless of where it is freed.
+        struct Header {
+            std::size_t size;
+            std::size_t align;
+            AllocationSite site;
+        };
+
+        static constexpr std::size_t kHeaderSize = 32;
+        static_assert(sizeof(Header) <= kHeaderSize);
+
+        static Counters& counters(AllocationSite site) {
+            static Counters sites[kAllocationSiteCount];
+            return sites[static_cast<int>(site)];
+        }
+
+        static std::size_t usableSize(void *block, std::size_t size, std::size_t headerSize) {
+#ifdef __GLIBC__
+            // the header shifts the request by a multiple of malloc's
+            // 16 byte granularity, thus does not change the rounding.
+            return malloc_usable_size(block) - headerSize;
+#else
+            (void)block; (void)headerSize;
+            return size;
+#endif
+        }
+
+        static void add(AllocationSite site, std::ptrdiff_t sign, std::size_t size, std::size_t usable) {
+            Counters& c = counters(site);
+            c.count.fetch_add(sign, std::memory_order_relaxed);
+            c.requested.fetch_add(sign * std::ptrdiff_t(size), std::memory_order_relaxed);
+            c.usable.fetch_add(sign * std::ptrdiff_t(usable), std::memory_order_relaxed);
+        }
+
+    public:
+        static void* allocate(std::size_t size, std::size_t align) {
+            std::size_t headerSize = std::max(kHeaderSize, align);
+            void *block = align > alignof(std::max_align_t)
+                ? std::aligned_alloc(align, (headerSize + size + align - 1) / align * align)
+                : std::malloc(headerSize + size);
+            if (block == nullptr)
+                throw std::bad_alloc();
+            AllocationSite site = currentAllocationSite();
+            void *p = static_cast<char*>(block) + headerSize;
+            new (static_cast<char*>(p) - kHeaderSize) Header{size, align, site};
+            add(site, 1, size, usableSize(block, size, headerSize));
+            return p;
+        }
+
+        static void deallocate(void *p) noexcept {
+            if (p == nullptr)
+                return;
+            const Header *h = reinterpret_cast<const Header*>(static_cast<char*>(p) - kHeaderSize);
+            std::size_t headerSize = std::max(kHeaderSize, h->align);
+            void *block = static_cast<char*>(p) - headerSize;
+            add(h->site, -1, h->size, usableSize(block, h->size, headerSize));
+            std::free(block);
+        }
+
+        static SiteStats snapshot() {
+            SiteStats stats;
+            for (int i = 0 ; i < kAllocationSiteCount ; ++i) {
+                const Counters& c = counters(static_cast<AllocationSite>(i));
+                stats[i] = { c.count.load(), c.requested.load(), c.usable.load() };
+            }
+            return stats;
+        }
+    };
+}
+
+void* operator new(std::size_t size) {
+    return mpt_demo::AllocationCounter::allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    return mpt_demo::AllocationCounter::allocate(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void *p) noexcept {
+    mpt_demo::AllocationCounter::deallocate(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    mpt_demo::AllocationCounter::deallocate(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    mpt_demo::AllocationCounter::deallocate(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    mpt_demo::AllocationCounter::deallocate(p);
+}
+
+namespace mpt_demo {
+    // An obstacle free scenario with an unreachable goal.  link()
+    // returns a bool, or with trajectories, a shared vector of
+    // waypoints.
+    template <typename SpaceType, typename BoundsType, bool trajectories>
+    class FootprintScenario {
+    public:
+        using Space = SpaceType;
+        using Bounds = BoundsType;
+        using State = typename Space::Type;
+        using Distance = typename Space::Distance;
+        using Goal = GoalState<Space>;
+        using Trajectory = std::vector<State>;
+
+    private:
+        Space space_;
+        Bounds bounds_;
+        Goal goal_;
+        unsigned waypoints_;
+
+    public:
+        FootprintScenario(const Bounds& bounds, const State& goal, unsigned waypoints)
+            : bounds_(bounds)
+            , goal_(Distance(1e-9), goal)
+            , waypoints_(waypoints)
+        {
+        }
+
+        const Space& space() const { return space_; }
+        const Bounds& bounds() const { return bounds_; }
+        const Goal& goal() const { return goal_; }
+
+        bool valid(const State&) const {
+            return true;
+        }
+
+        auto link(const State& a, const State& b) const {
+            if constexpr (trajectories) {
+                auto traj = std::make_shared<Trajectory>();
+                traj->reserve(waypoints_);
+                for (unsigned i = 1 ; i <= waypoints_ ; ++i)
+                    traj->push_back(interpolate(space_, a, b, Distance(i) / (waypoints_ + 1)));
+                return traj;
+            } else {
+                return true;
+            }
+        }
+    };
+
+    struct MemoryBenchmarkOptions {
+        std::vector<std::string> planners;
+        std::vector<std::string> spaces;
+        std::vector<std::size_t> nodeCounts{1000, 10000, 100000};
+        unsigned threads{1};
+        unsigned waypoints{0};
+        std::uint32_t seed{1};
+        std::string output;
+        std::string label;
+
+        bool plannerSelected(const std::string& name) const {
+            return benchmarkSelected(planners, name);
+        }
+
+        bool spaceSelected(const std::string& name) const {
+            return benchmarkSelected(spaces, name);
+        }
+    };
+
+    // The footprint of a planner grown to a node count.
+    struct FootprintSample {
+        std::size_t nodes{0};
+        std::size_t edges{0};
+        std::size_t stateSize{0};
+        SiteStats measured;
+        MemoryUsage estimate;
+
+        AllocationStats total() const {
+            AllocationStats sum;
+            for (const AllocationStats& s : measured)
+                sum += s;
+            return sum;
+        }
+
+        const AllocationStats& site(AllocationSite s) const {
+            return measured[static_cast<int>(s)];
+        }
+    };
+
+    // Counts the vertices and edges of a planner's graph.  PRM-type
+    // planners visit each undirected edge from both ends.
+    struct GraphCounter {
+        std::size_t& vertices;
+        std::size_t& edges;
+
+        template <typename State>
+        void vertex(const State&) { ++vertices; }
+
+        template <typename State>
+        void edge(const State&) { ++edges; }
+    };
+
+    template <typename Algorithm, typename Scenario, typename State>
+    std::vector<FootprintSample> runFootprint(
+        const Scenario& scenario, const State& start, bool undirected,
+        const MemoryBenchmarkOptions& options)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(static_cast<int>(options.threads));
+#endif
+
+        std::vector<FootprintSample> samples;
+        SiteStats before = AllocationCounter::snapshot();
+        {
+            Planner<Scenario, Algorithm> planner(scenario, BenchmarkSeed(options.seed));
+            planner.addStart(start);
+            for (std::size_t count : options.nodeCounts) {
+                planner.solve([&] { return planner.size() >= count; });
+
+                FootprintSample sample;
+                SiteStats after = AllocationCounter::snapshot();
+                for (int i = 0 ; i < kAllocationSiteCount ; ++i)
+                    sample.measured[i] = after[i] - before[i];
+                sample.estimate = planner.memoryUsage();
+                sample.stateSize = sizeof(State);
+                std::size_t edgeVisits = 0;
+                planner.visitGraph(GraphCounter{sample.nodes, edgeVisits});
+                sample.edges = undirected ? edgeVisits / 2 : edgeVisits;
+                samples.push_back(sample);
+            }
+        }
+        return samples;
+    }
+
+    void report(
+        std::ostream& out, const std::string& plannerName, const std::string& spaceName,
+        const MemoryBenchmarkOptions& options, const std::vector<FootprintSample>& samples)
+    {
+        out << "\n" << plannerName << " on " << spaceName;
+        if (options.waypoints)
+            out << " with " << options.waypoints << " waypoint trajectories";
+        out << " (bytes per node)\n"
+            << std::setw(10) << "nodes"
+            << std::setw(10) << "edges"
+            << std::setw(9) << "total"
+            << std::setw(9) << "estim"
+            << std::setw(9) << "state"
+            << std::setw(9) << "nodes"
+            << std::setw(9) << "edges"
+            << std::setw(9) << "comps"
+            << std::setw(9) << "traj"
+            << std::setw(9) << "nearest"
+            << std::setw(9) << "other"
+            << std::setw(9) << "B/edge"
+            << std::setw(9) << "malloc"
+            << std::setw(9) << "allocs" << "\n";
+
+        std::ios::fmtflags flags = out.flags();
+        out << std::fixed << std::setprecision(1);
+        for (const FootprintSample& s : samples) {
+            double n = static_cast<double>(s.nodes);
+            auto perNode = [&] (double bytes) { return bytes / n; };
+            AllocationStats total = s.total();
+            const AllocationStats& edges = s.site(AllocationSite::kEdges);
+
+            out << std::setw(10) << s.nodes
+                << std::setw(10) << s.edges
+                << std::setw(9) << perNode(total.bytes())
+                << std::setw(9) << perNode(s.estimate.total())
+                << std::setw(9) << double(s.stateSize)
+                << std::setw(9) << perNode(s.site(AllocationSite::kNodes).bytes())
+                << std::setw(9) << perNode(edges.bytes())
+                << std::setw(9) << perNode(s.site(AllocationSite::kComponents).bytes())
+                << std::setw(9) << perNode(s.site(AllocationSite::kTrajectories).bytes())
+                << std::setw(9) << perNode(s.site(AllocationSite::kNearest).bytes())
+                << std::setw(9) << perNode(s.site(AllocationSite::kOther).bytes());
+            // edges stored in the nodes have no allocations of their own
+            if (edges.count && s.edges)
+                out << std::setw(9) << double(edges.bytes()) / s.edges;
+            else
+                out << std::setw(9) << "-";
+            out
+                << std::setw(9) << perNode(total.bytes() - total.requested)
+                << std::setw(9) << perNode(total.count) << "\n";
+        }
+        out.flags(flags);
+    }
+
+    void writeJson(
+        std::ostream& out, const std::string& plannerName, const std::string& spaceName,
+        const MemoryBenchmarkOptions& options, const FootprintSample& s)
+    {
+        out << "{\"label\":\"" << jsonEscape(options.label)
+            << "\",\"planner\":\"" << jsonEscape(plannerName)
+            << "\",\"space\":\"" << jsonEscape(spaceName)
+            << "\",\"threads\":" << options.threads
+            << ",\"waypoints\":" << options.waypoints
+            << ",\"nodes\":" << s.nodes
+            << ",\"edges\":" << s.edges
+            << ",\"state_size\":" << s.stateSize
+            << ",\"estimate\":{\"nodes\":" << s.estimate.nodes
+            << ",\"edges\":" << s.estimate.edges
+            << ",\"components\":" << s.estimate.components
+            << ",\"trajectories\":" << s.estimate.trajectories
+            << ",\"nearest\":" << s.estimate.nearest
+            << ",\"scratch\":" << s.estimate.scratch
+            << "},\"measured\":{";
+        for (int i = 0 ; i < kAllocationSiteCount ; ++i) {
+            const AllocationStats& a = s.measured[i];
+            out << (i ? ",\"" : "\"") << allocationSiteName(static_cast<AllocationSite>(i))
+                << "\":{\"allocations\":" << a.count
+                << ",\"requested\":" << a.requested
+                << ",\"bytes\":" << a.bytes() << "}";
+        }
+        out << "}}\n";
+    }
+
+    template <typename Fn>
+    void forEachFootprintPlanner(const MemoryBenchmarkOptions& options, Fn&& fn) {
+        if (options.plannerSelected("prrt"))
+            fn(PlannerType<PRRT<>>{}, "prrt", false);
+        if (options.plannerSelected("prrt_star_k"))
+            fn(PlannerType<PRRTStar<rewire_k_nearest>>{}, "prrt_star_k", false);
+        if (options.plannerSelected("prrt_star_r"))
+            fn(PlannerType<PRRTStar<rewire_r_nearest>>{}, "prrt_star_r", false);
+        if (options.plannerSelected("pprm"))
+            fn(PlannerType<PPRM<>>{}, "pprm", true);
+        if (options.plannerSelected("pprm_irs"))
+            fn(PlannerType<PPRMIRS<>>{}, "pprm_irs", true);
+    }
+
+    template <typename Space, typename Bounds, typename Fn>
+    void withTrajectories(
+        const MemoryBenchmarkOptions& options, const Bounds& bounds,
+        const typename Space::Type& goal, Fn&& fn)
+    {
+        if (options.waypoints)
+            fn(FootprintScenario<Space, Bounds, true>(bounds, goal, options.waypoints));
+        else
+            fn(FootprintScenario<Space, Bounds, false>(bounds, goal, 0));
+    }
+
+    // Calls fn(name, scenario, start) for each selected space.
+    template <typename Fn>
+    void forEachSpace(const MemoryBenchmarkOptions& options, Fn&& fn) {
+        auto l2 = [&] (auto dim, const std::string& name) {
+            static constexpr int kDim = decltype(dim)::value;
+            using Space = L2Space<double, kDim>;
+            using Bounds = BoxBounds<double, kDim>;
+            using State = typename Space::Type;
+            if (!options.spaceSelected(name))
+                return;
+            withTrajectories<Space>(
+                options, Bounds(State::Constant(-1), State::Constant(1)), State::Constant(1),
+                [&] (const auto& scenario) { fn(name, scenario, State::Zero().eval()); });
+        };
+        l2(std::integral_constant<int, 2>{}, "l2_2");
+        l2(std::integral_constant<int, 10>{}, "l2_10");
+
+#if BENCHMARK_SE3
+        auto se3 = [&] (auto scalar, const std::string& name) {
+            using Scalar = decltype(scalar);
+            using Space = SE3Space<Scalar>;
+            using Bounds = std::tuple<Unbounded, BoxBounds<Scalar, 3>>;
+            using State = typename Space::Type;
+            using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+            if (!options.spaceSelected(name))
+                return;
+            State start(Eigen::Quaternion<Scalar>::Identity(), Vec3::Zero());
+            State goal(Eigen::Quaternion<Scalar>::Identity(), Vec3::Constant(1));
+            withTrajectories<Space>(
+                options, Bounds(Unbounded{}, BoxBounds<Scalar, 3>(Vec3::Constant(-1), Vec3::Constant(1))), goal,
+                [&] (const auto& scenario) { fn(name, scenario, start); });
+        };
+        se3(float{}, "se3_float");
+        se3(double{}, "se3_double");
+#endif
+    }
+
+    std::vector<std::size_t> parseNodeCounts(const std::string& arg) {
+        std::vector<std::size_t> counts;
+        std::istringstream in(arg);
+        for (std::string item ; std::getline(in, item, ',') ; )
+            counts.push_back(std::max(1, parseNonNegative(item, "node count")));
+        std::sort(counts.begin(), counts.end());
+        return counts;
+    }
+
+    MemoryBenchmarkOptions parseOptions(int argc, char *argv[]) {
+        static struct option longOptions[] = {
+            { "node-counts", required_argument, 0, 'n' },
+            { "threads", required_argument, 0, 'j' },
+            { "waypoints", required_argument, 0, 'w' },
+            { "seed", required_argument, 0, 's' },
+            { "planner", required_argument, 0, 'a' },
+            { "space", required_argument, 0, 'c' },
+            { "output", required_argument, 0, 'o' },
+            { "label", required_argument, 0, 'l' },
+            { nullptr, 0, nullptr, 0 }
+        };
+
+        MemoryBenchmarkOptions options;
+        for (int c, optInd ; -1 != (c=getopt_long(argc, argv, "n:j:w:s:a:c:o:l:", longOptions, &optInd)) ; ) {
+            switch (c) {
+            case 'n':
+                options.nodeCounts = parseNodeCounts(optarg);
+                break;
+            case 'j':
+                options.threads = std::max(1, parseNonNegative(optarg, "thread count"));
+                break;
+            case 'w':
+                options.waypoints = parseNonNegative(optarg, "waypoint count");
+                break;
+            case 's':
+                options.seed = parseNonNegative(optarg, "seed");
+                break;
+            case 'a':
+                options.planners.push_back(optarg);
+                break;
+            case 'c':
+                options.spaces.push_back(optarg);
+                break;
+            case 'o':
+                options.output = optarg;
+                break;
+            case 'l':
+                options.label = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [options]\n"
+                    "Options:\n"
+                    "  -n --node-counts=N,...  Report the footprint at these graph sizes\n"
+                    "                          (default 1000,10000,100000)\n"
+                    "  -j --threads=N       Threads to grow the graph with (default 1)\n"
+                    "  -w --waypoints=N     Return N-state shared trajectories from link()\n"
+                    "                       (default 0, link() returns a bool)\n"
+                    "  -s --seed=S          Random seed (default 1)\n"
+                    "  -a --planner=P       Run planner P (prrt, prrt_star_k, prrt_star_r, pprm, pprm_irs),\n"
+                    "                       may be repeated, default is all planners\n"
+                    "  -c --space=S         Run in space S (l2_2, l2_10, se3_float, se3_double),\n"
+                    "                       may be repeated, default is all\n"
+                    "  -o --output=FILE     Also append the footprints as JSON to FILE\n"
+                    "  -l --label=L         Label the results, e.g., with the build being tested\n"
+                          << std::flush;
+                throw std::invalid_argument("unrecognized option");
+            }
+        }
+        return options;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace mpt_demo;
+
+    try {
+        MemoryBenchmarkOptions options = parseOptions(argc, argv);
+        std::ofstream json;
+        if (!options.output.empty()) {
+            json.open(options.output, std::ios::app);
+            if (!json)
+                throw std::runtime_error("failed to open " + options.output);
+        }
+
+        forEachSpace(options, [&] (const std::string& spaceName, const auto& scenario, const auto& start) {
+            forEachFootprintPlanner(options, [&] (auto type, const std::string& plannerName, bool undirected) {
+                using Algorithm = typename decltype(type)::type;
+                std::cerr << "growing " << plannerName << " in " << spaceName
+                          << " to " << options.nodeCounts.back() << " nodes" << std::endl;
+                auto samples = runFootprint<Algorithm>(scenario, start, undirected, options);
+                report(std::cout, plannerName, spaceName, options, samples);
+                if (json.is_open())
+                    for (const FootprintSample& s : samples)
+                        writeJson(json, plannerName, spaceName, options, s);
+            });
+        });
+
+        return 0;
+    } catch (const std::exception& ex) {
+        MPT_LOG(FATAL) << "terminated with exception: " << ex.what();
+        return 1;
+    }
+}
@@ -0,0 +1,282 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_MESH_CACHE_HPP
+#define MPT_DEMO_MESH_CACHE_HPP
+
+// Binary cache of the triangles of imported meshes.  Importing a large
+// mesh with Assimp (and its post-processing steps) takes seconds,
+// while reading back the resulting triangle soup takes milliseconds.
+// The cache files are keyed by a hash of the contents of the mesh file
+// and the import options, so editing the mesh, or changing how it is
+// imported, misses the cache instead of loading stale triangles.
+// Cache files are mapped into memory when loaded, and written to a
+// temporary file then renamed into place, so that concurrent processes
+// never see a partial file.
+//
+// The cache directory is $MPT_MESH_CACHE, or $XDG_CACHE_HOME/mpt (or
+// ~/.cache/mpt) when it is unset.  Setting MPT_MESH_CACHE to an empty
+// string disables the cache.
+//
+// FCL does not expose a way to restore a built BVHModel, thus the BVH
+// is still built from the cached triangles on each load, which is
+// fast compared to the import.
+
+#include <mpt/log.hpp>
+#include <Eigen/Dense>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace mpt_demo::impl {
+    // A read-only private mapping of a whole file.  valid() is false
+    // if the file could not be opened, or is empty.
+    class MappedFile {
+        void *data_{MAP_FAILED};
+        std::size_t size_{0};
+
+    public:
+        explicit MappedFile(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+                return;
+            struct stat st;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+                size_ = st.st_size;
+                data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            ::close(fd);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator = (const MappedFile&) = delete;
+
+        ~MappedFile() {
+            if (data_ != MAP_FAILED)
+                ::munmap(data_, size_);
+        }
+
+        bool valid() const { return data_ != MAP_FAILED; }
+        const char* data() const { return static_cast<const char*>(data_); }
+        std::size_t size() const { return size_; }
+    };
+
+    // FNV-1a, 64-bit.  Hashing is I/O bound here, thus a faster hash
+    // would not make a difference.
+    inline std::uint64_t fnv1a(const void *data, std::size_t n, std::uint64_t h = 0xcbf29ce484222325ull) {
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        for (std::size_t i=0 ; i<n ; ++i) {
+            h ^= p[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    // Writes a cache file as a header followed by data, to a temporary
+    // file then renamed into place, so that concurrent processes never
+    // see a partial file.  Returns false (after logging) on failure,
+    // which callers treat as a cache miss on the next run.
+    inline bool writeCacheFile(
+        const std::string& path,
+        const void *header, std::size_t headerSize,
+        const void *data, std::size_t dataSize)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+        std::string tmp = path + ".tmp" + std::to_string(::getpid());
+        {
+            std::ofstream out(tmp, std::ios::binary);
+            out.write(static_cast<const char*>(header), headerSize);
+            out.write(static_cast<const char*>(data), dataSize);
+            if (out.close(), !out) {
+                MPT_LOG(WARN) << "failed to write cache file " << tmp;
+                std::filesystem::remove(tmp, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(tmp, path, ec);
+        if (ec) {
+            MPT_LOG(WARN) << "failed to rename cache file to " << path << ": " << ec.message();
+            std::filesystem::remove(tmp, ec);
+            return false;
+        }
+        return true;
+    }
+
+    template <typename Scalar>
+    class MeshCache {
+        using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+
+        static constexpr char kMagic[8] = { 'M', 'P', 'T', 'M', 'E', 'S', 'H', 0 };
+
+        // Bump when the layout, or the processing of the imported
+        // triangles, changes.
+        static constexpr std::uint32_t kVersion = 1;
+
+        // The file is the header followed by nTris * 9 Scalars, the
+        // three vertices of each triangle.  The header's size is a
+        // multiple of the Scalar's, thus the mapped triangles are
+        // aligned.
+        struct Header {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t scalarSize;
+            std::uint64_t sourceHash;
+            std::uint64_t sourceSize;
+            std::uint64_t options;
+            std::uint64_t nVertices;
+            std::uint64_t nTris;
+            Scalar center[3];
+        };
+        static_assert(sizeof(Header) % alignof(Scalar) == 0);
+
+        std::string path_;
+        std::uint64_t sourceHash_{0};
+        std::uint64_t sourceSize_{0};
+        std::uint64_t options_;
+
+    public:
+        static std::string directory() {
+            if (const char *dir = std::getenv("MPT_MESH_CACHE"))
+                return dir;
+            if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg)
+                return std::string(xdg) + "/mpt";
+            if (const char *home = std::getenv("HOME"); home && *home)
+                return std::string(home) + "/.cache/mpt";
+            return {};
+        }
+
+        // options must identify everything other than the mesh file's
+        // contents that affects the imported triangles.
+        MeshCache(const std::string& meshFile, std::uint64_t options)
+            : options_(options)
+        {
+            std::string dir = directory();
+            if (dir.empty())
+                return;
+
+            MappedFile source(meshFile);
+            if (!source.valid())
+                return; // let the importer report the error
+
+            sourceHash_ = fnv1a(source.data(), source.size());
+            sourceSize_ = source.size();
+
+            std::uint64_t key = fnv1a(&options_, sizeof(options_), sourceHash_);
+            std::uint32_t scalarSize = sizeof(Scalar);
+            key = fnv1a(&scalarSize, sizeof(scalarSize), key);
+
+            char name[32];
+            std::snprintf(name, sizeof(name), "%016llx.mesh", static_cast<unsigned long long>(key));
+            path_ = dir + "/" + name;
+        }
+
+        bool enabled() const { return !path_.empty(); }
+        const std::string& path() const { return path_; }
+
+        // Calls addTriangle(a, b, c) for each cached triangle, and
+        // returns true if the cache file exists and is valid.  On
+        // false, no triangles were visited.
+        template <typename Fn>
+        bool load(Fn&& addTriangle, std::size_t& nVertices, Vec3& center) const {
+            if (!enabled())
+                return false;
+
+            MappedFile file(path_);
+            if (!file.valid() || file.size() < sizeof(Header))
+                return false;
+
+            Header header;
+            std::memcpy(&header, file.data(), sizeof(header));
+            if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+                header.version != kVersion ||
+                header.scalarSize != sizeof(Scalar) ||
+                header.sourceHash != sourceHash_ ||
+                header.sourceSize != sourceSize_ ||
+                header.options != options_ ||
+                file.size() != sizeof(Header) + header.nTris * 9 * sizeof(Scalar))
+            {
+                MPT_LOG(WARN) << "ignoring invalid mesh cache file " << path_;
+                return false;
+            }
+
+            const Scalar *v = reinterpret_cast<const Scalar*>(file.data() + sizeof(Header));
+            for (std::uint64_t i=0 ; i<header.nTris ; ++i, v += 9)
+                addTriangle(Eigen::Map<const Vec3>(v), Eigen::Map<const Vec3>(v+3), Eigen::Map<const Vec3>(v+6));
+
+            nVertices = header.nVertices;
+            center = Eigen::Map<const Vec3>(header.center);
+            return true;
+        }
+
+        // Stores the imported triangles (9 Scalars per triangle).
+        // Failing to write the cache is not an error, the next run
+        // will import the mesh again.
+        void store(const std::vector<Scalar>& triangles, std::size_t nVertices, const Vec3& center) const {
+            if (!enabled())
+                return;
+
+            Header header;
+            std::memset(&header, 0, sizeof(header));
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.scalarSize = sizeof(Scalar);
+            header.sourceHash = sourceHash_;
+            header.sourceSize = sourceSize_;
+            header.options = options_;
+            header.nVertices = nVertices;
+            header.nTris = triangles.size() / 9;
+            Eigen::Map<Vec3>(header.center) = center;
+
+            writeCacheFile(path_, &header, sizeof(header),
+                           triangles.data(), triangles.size() * sizeof(Scalar));
+        }
+    };
+}
+
+#endif
@@ -37,81 +37,281 @@
 #define COLLIDE_H
 
 #include "linear.hpp"
+#include <algorithm>
+#include <cassert>
 
 namespace nao_cup {
 
-    int collide_trace = 0;
+    /*
+     * The collision model is a two-level sphere tree.  The leaves are
+     * spheres and capsules (spheres swept along a segment), stored as
+     * structures of arrays so that one primitive is tested against a
+     * run of spheres in a single loop that the compiler vectorizes (8
+     * floats or 4 doubles per AVX instruction).  The leaves are
+     * partitioned into groups, each rigidly attached to one frame of
+     * the robot, and each group is bounded by a sphere.  Two groups'
+     * leaves are only tested if their bounding spheres overlap.
+     */
+
+    template <typename S, unsigned N>
+    struct sphere_array {
+        S x[N], y[N], z[N], r[N];
+    };
+
+    template <typename S, unsigned N>
+    struct capsule_array {
+        S x0[N], y0[N], z0[N];
+        S x1[N], y1[N], z1[N];
+        S r[N];
+    };
 
     template <typename S>
-    bool collide_sphere_capsule(
-        const Transform<S> *sphere_transform, S sphere_radius,
-        const Transform<S> *capsule_transform, S capsule_length, S capsule_radius)
-    {
-        Vec3<S> sphere_center;
-        Vec3<S> capsule_start;
-        Vec3<S> capsule_end;
-        S dist;
+    struct collision_group {
+        /* the frame the leaves are attached to */
+        const Transform<S> *frame;
 
-        m4_transform_i3<S>(&sphere_center, sphere_transform, S(0), S(0), S(0));
-        m4_transform_i3<S>(&capsule_start, capsule_transform, S(0), S(0), S(0));
-        m4_transform_i3<S>(&capsule_end, capsule_transform, S(0), S(0), capsule_length);
+        unsigned sphere_begin, sphere_end;
+        unsigned capsule_begin, capsule_end;
 
-        // if (collide_trace) {
-        //         printf("capsule (%f, %f, %f) to (%f, %f, %f) radius=%f, sphere (%f, %f, %f) radius=%f\n",
-        //                capsule_start.x(), capsule_start.y(), capsule_start.z(),
-        //                capsule_end.x(), capsule_end.y(), capsule_end.z(), capsule_radius,
-        //                sphere_center.x(), sphere_center.y(), sphere_center.z(), sphere_radius);
-        // }
+        /* bounding sphere, in frame and world coordinates */
+        Vec3<S> local_center;
+        Vec3<S> center;
+        S radius;
+    };
 
-        dist = v3_dist_segment_point(&capsule_start, &capsule_end, &sphere_center);
+    template <typename S, unsigned MAX_SPHERES, unsigned MAX_CAPSULES>
+    struct collision_model {
+        unsigned sphere_count;
+        unsigned capsule_count;
 
-        return dist < (sphere_radius + capsule_radius);
-    }
+        /* leaves in the coordinates of their group's frame */
+        sphere_array<S, MAX_SPHERES> local_spheres;
+        capsule_array<S, MAX_CAPSULES> local_capsules;
+
+        /* leaves in world coordinates, see update_group */
+        sphere_array<S, MAX_SPHERES> spheres;
+        capsule_array<S, MAX_CAPSULES> capsules;
+    };
 
+    /*
+     * Squared distance from the point p to the segment from a to a+v.
+     * Written without branches so that it vectorizes when inlined
+     * into a loop.  v must not be zero.
+     */
     template <typename S>
-    bool collide_sphere_sphere(
-        const Transform<S> *a_transform, S a_radius,
-        const Transform<S> *b_transform, S b_radius)
+    inline S dist_squared_segment_point(
+        S ax, S ay, S az, S vx, S vy, S vz, S px, S py, S pz)
     {
-        Vec4<S> a_center, b_center;
-        S d2, r2;
+        S wx = px - ax, wy = py - ay, wz = pz - az;
+        S c1 = wx*vx + wy*vy + wz*vz;
+        S c2 = vx*vx + vy*vy + vz*vz;
+        S t = std::min(std::max(c1 / c2, S(0)), S(1));
+        S dx = wx - t*vx, dy = wy - t*vy, dz = wz - t*vz;
+        return dx*dx + dy*dy + dz*dz;
+    }
 
-        m4_transform_i<S>(&a_center, a_transform, S(0), S(0), S(0), S(1));
-        m4_transform_i<S>(&b_center, b_transform, S(0), S(0), S(0), S(1));
+    /*
+     * Returns the number of the n spheres that intersect the sphere
+     * centered at p with radius pr.
+     */
+    template <typename S, unsigned N>
+    int collide_spheres_sphere(
+        const sphere_array<S, N>& a, unsigned begin, unsigned end,
+        S px, S py, S pz, S pr)
+    {
+        int hits = 0;
+        for (unsigned i=begin ; i<end ; ++i) {
+            S dx = a.x[i] - px, dy = a.y[i] - py, dz = a.z[i] - pz;
+            S rr = a.r[i] + pr;
+            hits += (dx*dx + dy*dy + dz*dz < rr*rr);
+        }
+        return hits;
+    }
 
-        d2 = (a_center.template head<3>() - b_center.template head<3>()).squaredNorm();
-        r2 = a_radius + b_radius;
-        r2 *= r2;
+    /*
+     * Returns the number of spheres that intersect capsule j of b.
+     */
+    template <typename S, unsigned N, unsigned M>
+    int collide_spheres_capsule(
+        const sphere_array<S, N>& a, unsigned begin, unsigned end,
+        const capsule_array<S, M>& b, unsigned j)
+    {
+        S ax = b.x0[j], ay = b.y0[j], az = b.z0[j];
+        S vx = b.x1[j] - ax, vy = b.y1[j] - ay, vz = b.z1[j] - az;
+        S br = b.r[j];
+        int hits = 0;
+        for (unsigned i=begin ; i<end ; ++i) {
+            S rr = a.r[i] + br;
+            hits += (dist_squared_segment_point(ax, ay, az, vx, vy, vz, a.x[i], a.y[i], a.z[i]) < rr*rr);
+        }
+        return hits;
+    }
 
-        return (d2 < r2);
+    /*
+     * Capsule-capsule test.  Like the original C implementation, this
+     * takes the distance between the capsules' axes as the minimum
+     * distance between an endpoint of one axis and the other axis,
+     * which misses crossing axes whose endpoints are all far apart.
+     */
+    template <typename S, unsigned M>
+    bool collide_capsule_capsule(const capsule_array<S, M>& c, unsigned i, unsigned j) {
+        S avx = c.x1[i] - c.x0[i], avy = c.y1[i] - c.y0[i], avz = c.z1[i] - c.z0[i];
+        S bvx = c.x1[j] - c.x0[j], bvy = c.y1[j] - c.y0[j], bvz = c.z1[j] - c.z0[j];
+        S d2 = std::min(
+            std::min(dist_squared_segment_point(c.x0[i], c.y0[i], c.z0[i], avx, avy, avz, c.x0[j], c.y0[j], c.z0[j]),
+                     dist_squared_segment_point(c.x0[i], c.y0[i], c.z0[i], avx, avy, avz, c.x1[j], c.y1[j], c.z1[j])),
+            std::min(dist_squared_segment_point(c.x0[j], c.y0[j], c.z0[j], bvx, bvy, bvz, c.x0[i], c.y0[i], c.z0[i]),
+                     dist_squared_segment_point(c.x0[j], c.y0[j], c.z0[j], bvx, bvy, bvz, c.x1[i], c.y1[i], c.z1[i])));
+        S rr = c.r[i] + c.r[j];
+        return d2 < rr*rr;
     }
 
-    template <typename S>
-    bool collide_capsule_capsule(
-        const Transform<S> *a_transform, S a_length, S a_radius,
-        const Transform<S> *b_transform, S b_length, S b_radius)
+    template <typename S, unsigned N, unsigned M>
+    void group_init(collision_model<S, N, M> *model, collision_group<S> *group, const Transform<S> *frame) {
+        group->frame = frame;
+        group->sphere_begin = group->sphere_end = model->sphere_count;
+        group->capsule_begin = group->capsule_end = model->capsule_count;
+    }
+
+    /*
+     * Adds a sphere at the origin of the transform local (relative to
+     * the group's frame) to the group, which must be the last group
+     * initialized.
+     */
+    template <typename S, unsigned N, unsigned M>
+    void group_add_sphere(
+        collision_model<S, N, M> *model, collision_group<S> *group,
+        const Transform<S>& local, S radius)
+    {
+        assert(group->sphere_end == model->sphere_count && model->sphere_count < N);
+        unsigned i = model->sphere_count++;
+        Vec3<S> p = local.translation();
+        model->local_spheres.x[i] = p.x();
+        model->local_spheres.y[i] = p.y();
+        model->local_spheres.z[i] = p.z();
+        model->local_spheres.r[i] = model->spheres.r[i] = radius;
+        group->sphere_end = model->sphere_count;
+    }
+
+    /*
+     * Adds a capsule along the z axis of the transform local from 0
+     * to length to the group, which must be the last group
+     * initialized.
+     */
+    template <typename S, unsigned N, unsigned M>
+    void group_add_capsule(
+        collision_model<S, N, M> *model, collision_group<S> *group,
+        const Transform<S>& local, S radius, S length)
     {
-        Vec3<S> a_s0, a_s1;
-        Vec3<S> b_s0, b_s1;
-        S a0, a1;
-        S b0, b1;
-        S dist;
+        assert(group->capsule_end == model->capsule_count && model->capsule_count < M);
+        unsigned i = model->capsule_count++;
+        Vec3<S> p0 = local.translation();
+        Vec3<S> p1 = local * Vec3<S>(S(0), S(0), length);
+        model->local_capsules.x0[i] = p0.x();
+        model->local_capsules.y0[i] = p0.y();
+        model->local_capsules.z0[i] = p0.z();
+        model->local_capsules.x1[i] = p1.x();
+        model->local_capsules.y1[i] = p1.y();
+        model->local_capsules.z1[i] = p1.z();
+        model->local_capsules.r[i] = model->capsules.r[i] = radius;
+        group->capsule_end = model->capsule_count;
+    }
+
+    /*
+     * Computes the group's bounding sphere, after all of its leaves
+     * have been added.  The sphere is centered on the group's
+     * axis-aligned bounding box, which is not the smallest bound, but
+     * is close enough for the handful of leaves in a group.
+     */
+    template <typename S, unsigned N, unsigned M>
+    void group_finish(collision_model<S, N, M> *model, collision_group<S> *group) {
+        const auto& s = model->local_spheres;
+        const auto& c = model->local_capsules;
+        Eigen::AlignedBox<S, 3> box;
+        for (unsigned i=group->sphere_begin ; i<group->sphere_end ; ++i)
+            box.extend(Vec3<S>(s.x[i], s.y[i], s.z[i]));
+        for (unsigned i=group->capsule_begin ; i<group->capsule_end ; ++i) {
+            box.extend(Vec3<S>(c.x0[i], c.y0[i], c.z0[i]));
+            box.extend(Vec3<S>(c.x1[i], c.y1[i], c.z1[i]));
+        }
+        group->local_center = box.center();
 
-        m4_transform_i<S>(&a_s0, a_transform, S(0), S(0), S(0));
-        m4_transform_i<S>(&a_s1, a_transform, S(0), S(0), a_length);
+        S radius = 0;
+        for (unsigned i=group->sphere_begin ; i<group->sphere_end ; ++i)
+            radius = std::max(radius, (Vec3<S>(s.x[i], s.y[i], s.z[i]) - group->local_center).norm() + s.r[i]);
+        for (unsigned i=group->capsule_begin ; i<group->capsule_end ; ++i) {
+            radius = std::max(radius, (Vec3<S>(c.x0[i], c.y0[i], c.z0[i]) - group->local_center).norm() + c.r[i]);
+            radius = std::max(radius, (Vec3<S>(c.x1[i], c.y1[i], c.z1[i]) - group->local_center).norm() + c.r[i]);
+        }
+        group->radius = radius;
+    }
 
-        m4_transform_i<S>(&b_s0, b_transform, S(0), S(0), S(0));
-        m4_transform_i<S>(&b_s1, b_transform, S(0), S(0), b_length);
+    template <typename S>
+    inline void transform_points(
+        const Transform<S>& m,
+        const S *lx, const S *ly, const S *lz,
+        S *x, S *y, S *z,
+        unsigned begin, unsigned end)
+    {
+        const auto& r = m.linear();
+        const auto& t = m.translation();
+        S r00 = r(0,0), r01 = r(0,1), r02 = r(0,2), t0 = t[0];
+        S r10 = r(1,0), r11 = r(1,1), r12 = r(1,2), t1 = t[1];
+        S r20 = r(2,0), r21 = r(2,1), r22 = r(2,2), t2 = t[2];
+        for (unsigned i=begin ; i<end ; ++i) {
+            S px = lx[i], py = ly[i], pz = lz[i];
+            x[i] = r00*px + r01*py + r02*pz + t0;
+            y[i] = r10*px + r11*py + r12*pz + t1;
+            z[i] = r20*px + r21*py + r22*pz + t2;
+        }
+    }
 
-        a0 = v3_dist_segment_point(&a_s0, &a_s1, &b_s0);
-        a1 = v3_dist_segment_point(&a_s0, &a_s1, &b_s1);
+    /*
+     * Moves the group's leaves and bounding sphere to the current
+     * value of its frame.
+     */
+    template <typename S, unsigned N, unsigned M>
+    void update_group(collision_model<S, N, M> *model, collision_group<S> *group) {
+        const Transform<S>& m = *group->frame;
+        const auto& ls = model->local_spheres;
+        const auto& lc = model->local_capsules;
+        auto& s = model->spheres;
+        auto& c = model->capsules;
 
-        b0 = v3_dist_segment_point(&b_s0, &b_s1, &a_s0);
-        b1 = v3_dist_segment_point(&b_s0, &b_s1, &a_s1);
+        group->center = m * group->local_center;
+        transform_points(m, ls.x, ls.y, ls.z, s.x, s.y, s.z, group->sphere_begin, group->sphere_end);
+        transform_points(m, lc.x0, lc.y0, lc.z0, c.x0, c.y0, c.z0, group->capsule_begin, group->capsule_end);
+        transform_points(m, lc.x1, lc.y1, lc.z1, c.x1, c.y1, c.z1, group->capsule_begin, group->capsule_end);
+    }
 
-        dist = fmin(fmin(a0, a1), fmin(b0, b1));
+    /*
+     * Tests two groups for collision, first their bounding spheres,
+     * then their leaves.  The spheres of a are the run that is
+     * vectorized over, so a should be the group with more spheres.
+     */
+    template <typename S, unsigned N, unsigned M>
+    bool collide_groups(
+        const collision_model<S, N, M> *model,
+        const collision_group<S> *a,
+        const collision_group<S> *b)
+    {
+        S rr = a->radius + b->radius;
+        if ((a->center - b->center).squaredNorm() >= rr*rr)
+            return false;
 
-        return dist < (a_radius + b_radius);
+        const auto& s = model->spheres;
+        const auto& c = model->capsules;
+        int hits = 0;
+        for (unsigned j=b->sphere_begin ; j<b->sphere_end ; ++j)
+            hits += collide_spheres_sphere(s, a->sphere_begin, a->sphere_end, s.x[j], s.y[j], s.z[j], s.r[j]);
+        for (unsigned j=b->capsule_begin ; j<b->capsule_end ; ++j)
+            hits += collide_spheres_capsule(s, a->sphere_begin, a->sphere_end, c, j);
+        for (unsigned i=a->capsule_begin ; i<a->capsule_end ; ++i) {
+            hits += collide_spheres_capsule(s, b->sphere_begin, b->sphere_end, c, i);
+            for (unsigned j=b->capsule_begin ; j<b->capsule_end ; ++j)
+                hits += collide_capsule_capsule(c, i, j);
+        }
+        return hits != 0;
     }
 }
 
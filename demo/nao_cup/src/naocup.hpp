@@ -76,22 +76,13 @@ namespace nao_cup {
 
     template <typename S> constexpr S BALL_RADIUS = S(0.015);
 
-    constexpr unsigned NUM_OBSTACLES = 4;
     template <typename S> constexpr S PLANAR_SPHERE_RADIUS = S(25.0);
     template <typename S> constexpr S TABLE_OFFSET_Z = S(0.09);
     template <typename S> constexpr S DISCRETIZATION = (S(1.0) * PI<S> / S(180.0));
 
-    enum {
-        SPHERE, CAPSULE
-    };
-
-    template <typename S>
-    struct collision_object {
-        int type;
-        Transform<S> *transform;
-        S radius;
-        S length;
-    };
+    /* leaves of the collision model, see init_collisions */
+    constexpr unsigned NUM_SPHERES = 3 + 1 + 2 + 1 + CUP_BEAD_COUNT * 2;
+    constexpr unsigned NUM_CAPSULES = 2 + 1 + 2 + 2;
 
     template <typename S>
     struct nao_arm {
@@ -147,23 +138,15 @@ namespace nao_cup {
 
     template <typename S>
     struct nao_collision {
-        struct collision_object<S> left_arm[3];
-        struct collision_object<S> right_arm[3];
-        struct collision_object<S> torso[3];
-        struct collision_object<S> head[2];
-        struct collision_object<S> cup[CUP_BEAD_COUNT * 2 + 2];
-        struct collision_object<S> obstacles[NUM_OBSTACLES];
-        struct collision_object<S> ball[1];
-        Transform<S> coke_transform;
-        Transform<S> pepsi_transform;
-        Transform<S> table_transform;
-        Transform<S> backwall_transform;
-        Transform<S> ball_transform;
-        Transform<S> cup_stem_transform;
-        Transform<S> cup_bowl_transform;
-        Transform<S> cup_bead_transform[CUP_BEAD_COUNT * 2];
-        S bead_x[CUP_BEAD_COUNT];
-        S bead_y[CUP_BEAD_COUNT];
+        collision_model<S, NUM_SPHERES, NUM_CAPSULES> model;
+
+        struct collision_group<S> left_arm;
+        struct collision_group<S> right_arm;
+        struct collision_group<S> torso;
+        struct collision_group<S> head;
+        struct collision_group<S> cup;
+        struct collision_group<S> obstacles;
+        struct collision_group<S> ball;
     };
 
     template <typename S>
@@ -328,53 +311,6 @@ namespace nao_cup {
         return array;
     }
 
-    template <typename S>
-    bool collide_objects(struct collision_object<S> *a, struct collision_object<S> *b) {
-        switch ((a->type << 1) | b->type) {
-        case (SPHERE<<1) | SPHERE:
-            return collide_sphere_sphere(
-                a->transform, a->radius,
-                b->transform, b->radius);
-
-        case (SPHERE<<1) | CAPSULE:
-            return collide_sphere_capsule(
-                a->transform, a->radius,
-                b->transform, b->length, b->radius);
-
-        case (CAPSULE<<1) | SPHERE:
-            return collide_sphere_capsule(
-                b->transform, b->radius,
-                a->transform, a->length, a->radius);
-
-        case (CAPSULE<<1) | CAPSULE:
-            return collide_capsule_capsule(
-                a->transform, a->length, a->radius,
-                b->transform, b->length, b->radius);
-
-        default:
-            assert(0);
-            return 1;
-        }
-    }
-
-    template <typename S>
-    bool collide_object_lists(
-        struct collision_object<S> *a, size_t n,
-        struct collision_object<S> *b, size_t m)
-    {
-        size_t i, j;
-        bool collision = false;
-
-        for (i=0 ; i<n ; ++i) {
-            for (j=0 ; j<m ; ++j) {
-                if (collide_objects(a + i, b + j)) {
-                    collision = true;
-                }
-            }
-        }
-        return collision;
-    }
-
     template <typename S>
     void compute_head(Transform<S> *transform, nao_robot<S> *robot) {
         Transform<S> head_yaw;
@@ -456,98 +392,89 @@ namespace nao_cup {
     }
 #endif
 
-    inline bool dbool(const char *name, bool value) {
-        /* if (value) printf("%s: %s\n", name, value ? "true" : "false"); */
-        return value;
-    }
-
     template <typename S>
     void init_collisions(nao_world<S> *world) {
         nao_collision<S> *c = &world->collide;
-
-        c->right_arm[0].type = CAPSULE;
-        c->right_arm[0].transform = &world->robot.right_arm.lower_capsule_transform;
-        c->right_arm[0].radius = ARM_RADIUS<S>;
-        c->right_arm[0].length = LOWER_ARM_LENGTH<S> + HAND_OFFSET_X<S> - ARM_RADIUS<S>;
-
-        c->left_arm[0].type = CAPSULE;
-        c->left_arm[0].transform = &world->robot.left_arm.lower_capsule_transform;
-        c->left_arm[0].radius = ARM_RADIUS<S>;
-        c->left_arm[0].length = LOWER_ARM_LENGTH<S> + HAND_OFFSET_X<S> - ARM_RADIUS<S>;
-
-        c->torso[0].type = SPHERE;
-        c->torso[0].transform = &world->robot.transform; /* center_torso */
-        c->torso[0].radius = S(55.6 / 1000.0);
-
-        c->torso[1].type = SPHERE;
-        c->torso[1].transform = &world->robot.upper_torso;
-        c->torso[1].radius = CENTER_TORSO_RADIUS<S>;
-
-        c->torso[2].type = SPHERE;
-        c->torso[2].transform = &world->robot.lower_torso;
-        c->torso[2].radius = (HIP_OFFSET_Z<S>/S(2.0));
-
-        c->head[0].type = SPHERE;
-        c->head[0].transform = &world->robot.head_center;
-        c->head[0].radius = HEAD_RADIUS<S>;
-
-        c->head[1].type = CAPSULE;
-        c->head[1].transform = &world->robot.head_capsule;
-        c->head[1].radius = EAR_RADIUS<S>;
-        c->head[1].length = HEAD_WIDTH<S> - EAR_RADIUS<S>/S(2.0);
-
+        collision_model<S, NUM_SPHERES, NUM_CAPSULES> *m = &c->model;
+        const Transform<S> identity = Transform<S>::Identity();
+        Transform<S> t, r;
+
+        m->sphere_count = 0;
+        m->capsule_count = 0;
+
+        // leaves are placed relative to the frame computed by
+        // compute(), compute_head(), or compute_arm() that they are
+        // attached to.
+
+        group_init(m, &c->right_arm, &world->robot.right_arm.lower_capsule_transform);
+        group_add_capsule(m, &c->right_arm, identity,
+                          ARM_RADIUS<S>, LOWER_ARM_LENGTH<S> + HAND_OFFSET_X<S> - ARM_RADIUS<S>);
+        group_finish(m, &c->right_arm);
+
+        group_init(m, &c->left_arm, &world->robot.left_arm.lower_capsule_transform);
+        group_add_capsule(m, &c->left_arm, identity,
+                          ARM_RADIUS<S>, LOWER_ARM_LENGTH<S> + HAND_OFFSET_X<S> - ARM_RADIUS<S>);
+        group_finish(m, &c->left_arm);
+
+        group_init(m, &c->torso, &world->robot.transform);
+        group_add_sphere(m, &c->torso, identity, S(55.6 / 1000.0)); /* center_torso */
+        m4_translate<S>(&t, &identity, S(0), S(0), NECK_OFFSET_Z<S> - S(66.7) / S(1000.0));
+        group_add_sphere(m, &c->torso, t, CENTER_TORSO_RADIUS<S>); /* upper_torso */
+        m4_translate<S>(&t, &identity, S(0), S(0), -HIP_OFFSET_Z<S> / S(2.0));
+        group_add_sphere(m, &c->torso, t, HIP_OFFSET_Z<S>/S(2.0)); /* lower_torso */
+        group_finish(m, &c->torso);
+
+        group_init(m, &c->head, &world->robot.head_center);
+        group_add_sphere(m, &c->head, identity, HEAD_RADIUS<S>);
+        m4_rotate<S>(&r, &identity, PI<S>/S(2.0), S(1), S(0), S(0));
+        m4_translate<S>(&t, &r, S(0), S(0), -(HEAD_WIDTH<S> - EAR_RADIUS<S>*2)/S(2));
+        group_add_capsule(m, &c->head, t, EAR_RADIUS<S>, HEAD_WIDTH<S> - EAR_RADIUS<S>/S(2.0));
+        group_finish(m, &c->head);
+
+        group_init(m, &c->obstacles, &world->robot.transform);
         // 12oz coke bottle
-        c->obstacles[0].type = CAPSULE;
-        c->obstacles[0].transform = &c->coke_transform;
-        c->obstacles[0].radius = S(2.5)/S(2.0) * INCHES<S>;
-        c->obstacles[0].length = (S(6.75) - S(2.5)/S(2.0)) * INCHES<S>;
-
+        m4_translate<S>(&t, &identity, S(0.12), S(0.08), -TABLE_OFFSET_Z<S>);
+        group_add_capsule(m, &c->obstacles, t,
+                          S(2.5)/S(2.0) * INCHES<S>, (S(6.75) - S(2.5)/S(2.0)) * INCHES<S>);
         // 20oz pepsi near right hand
-        c->obstacles[1].type = CAPSULE;
-        c->obstacles[1].transform = &c->pepsi_transform;
-        c->obstacles[1].radius = S(3.0)/S(2.0) * INCHES<S>;
-        c->obstacles[1].length = (S(8.5) - S(3.0)/S(2.0)) * INCHES<S>;
-
+        m4_translate<S>(&t, &identity, S(0.12) + S(2.5) * INCHES<S>, S(-0.12), -TABLE_OFFSET_Z<S>);
+        group_add_capsule(m, &c->obstacles, t,
+                          S(3.0)/S(2.0) * INCHES<S>, (S(8.5) - S(3.0)/S(2.0)) * INCHES<S>);
         // table
-        c->obstacles[2].type = SPHERE;
-        c->obstacles[2].transform = &c->table_transform;
-        c->obstacles[2].radius = PLANAR_SPHERE_RADIUS<S>;
-
+        m4_translate<S>(&t, &identity, S(0.0), S(0.0), -PLANAR_SPHERE_RADIUS<S> - TABLE_OFFSET_Z<S>);
+        group_add_sphere(m, &c->obstacles, t, PLANAR_SPHERE_RADIUS<S>);
         // back wall
-        c->obstacles[3].type = SPHERE;
-        c->obstacles[3].transform = &c->backwall_transform;
-        c->obstacles[3].radius = PLANAR_SPHERE_RADIUS<S>;
+        m4_translate<S>(&t, &identity, -PLANAR_SPHERE_RADIUS<S> - CENTER_TORSO_RADIUS<S>, S(0.0), S(0.0));
+        group_add_sphere(m, &c->obstacles, t, PLANAR_SPHERE_RADIUS<S>);
+        group_finish(m, &c->obstacles);
 
         // ball in hand
-        c->ball[0].type = SPHERE;
-        c->ball[0].transform = &c->ball_transform;
-        c->ball[0].radius = BALL_RADIUS<S>;
+        group_init(m, &c->ball, &world->robot.left_arm.transform_to_hand);
+        m4_translate<S>(&t, &identity, S(0.0), BALL_RADIUS<S> / S(2.0) + S(0.01), S(0.0));
+        group_add_sphere(m, &c->ball, t, BALL_RADIUS<S>);
+        group_finish(m, &c->ball);
 
+        group_init(m, &c->cup, &world->robot.right_arm.transform_to_hand);
         // cup stem
-        c->cup[0].type = CAPSULE;
-        c->cup[0].transform = &c->cup_stem_transform;
-        c->cup[0].radius = CUP_GRIP_DIAMETER<S> / S(2.0);
-        c->cup[0].length = -CUP_GRIP_CAPSULE_HEIGHT<S>;
-
+        m4_translate<S>(&t, &identity, S(0.0), S(0.0), CUP_GRIP_HEIGHT<S> / S(2.0));
+        group_add_capsule(m, &c->cup, t, CUP_GRIP_DIAMETER<S> / S(2.0), -CUP_GRIP_CAPSULE_HEIGHT<S>);
         // cup bowl
-        c->cup[1].type = CAPSULE;
-        c->cup[1].transform = &c->cup_bowl_transform;
-        c->cup[1].radius = CUP_DIAMETER<S> / S(2.0);
-        c->cup[1].length = CUP_BOWL_HEIGHT<S> - CUP_DIAMETER<S>;
-
+        m4_translate<S>(&t, &identity, S(0.0), S(0.0), CUP_GRIP_HEIGHT<S> / S(2.0) + CUP_DIAMETER<S> / S(2.0));
+        group_add_capsule(m, &c->cup, t, CUP_DIAMETER<S> / S(2.0), CUP_BOWL_HEIGHT<S> - CUP_DIAMETER<S>);
         // cup beads (representing base and cap)
         for (unsigned i=0 ; i<CUP_BEAD_COUNT ; ++i) {
-                S a = PI<S> * S(2.0) * (S)i / (S)CUP_BEAD_COUNT;
-                c->bead_x[i] = cos(a) * (CUP_DIAMETER<S> / S(2.0) - CUP_BEAD_RADIUS<S>);
-                c->bead_y[i] = sin(a) * (CUP_DIAMETER<S> / S(2.0) - CUP_BEAD_RADIUS<S>);
-                c->cup[i*2+2].type = SPHERE;
-                c->cup[i*2+2].transform = &c->cup_bead_transform[i*2];
-                c->cup[i*2+2].radius = CUP_BEAD_RADIUS<S>;
-
-                c->cup[i*2+3].type = SPHERE;
-                c->cup[i*2+3].transform = &c->cup_bead_transform[i*2+1];
-                c->cup[i*2+3].radius = CUP_BEAD_RADIUS<S>;
+            S a = PI<S> * S(2.0) * (S)i / (S)CUP_BEAD_COUNT;
+            S x = cos(a) * (CUP_DIAMETER<S> / S(2.0) - CUP_BEAD_RADIUS<S>);
+            S y = sin(a) * (CUP_DIAMETER<S> / S(2.0) - CUP_BEAD_RADIUS<S>);
+
+            m4_translate<S>(&t, &identity, x, y,
+                            CUP_BOWL_HEIGHT<S> + CUP_GRIP_HEIGHT<S> / S(2.0) - CUP_BEAD_RADIUS<S>);
+            group_add_sphere(m, &c->cup, t, CUP_BEAD_RADIUS<S>);
+            m4_translate<S>(&t, &identity, x, y,
+                            CUP_GRIP_HEIGHT<S> / S(2.0) - CUP_BASE_TO_BOWL<S> + CUP_BEAD_RADIUS<S>);
+            group_add_sphere(m, &c->cup, t, CUP_BEAD_RADIUS<S>);
         }
+        group_finish(m, &c->cup);
 
         // self-collision defined as:
         //   torso-cells(3) & [ left-arm-cells, right-arm-cells ]
@@ -558,55 +485,51 @@ namespace nao_cup {
         //   obstacles & [ left-arm-cells, right-arm-cells ]
         //   cup  & [ left-arm-cells, head-cells, torso-cells, obstacles ]
         //   ball & [ right-arm-cells, head-cells, torso-cells, obstacles ]
+
+        assert(m->sphere_count == NUM_SPHERES);
+        assert(m->capsule_count == NUM_CAPSULES);
     }
 
     template <typename S>
     bool check_collisions(nao_world<S> *world) {
         nao_collision<S> *c = &world->collide;
+        collision_model<S, NUM_SPHERES, NUM_CAPSULES> *m = &c->model;
 
-        m4_translate<S>(&c->coke_transform, &world->robot.transform, S(0.12), S(0.08), -TABLE_OFFSET_Z<S>);
-        m4_translate<S>(&c->pepsi_transform, &world->robot.transform, S(0.12) + S(2.5) * INCHES<S>, S(-0.12), -TABLE_OFFSET_Z<S>);
-        m4_translate<S>(&c->table_transform, &world->robot.transform, S(0.0), S(0.0), -PLANAR_SPHERE_RADIUS<S> - TABLE_OFFSET_Z<S>);
-        m4_translate<S>(&c->backwall_transform, &world->robot.transform, -PLANAR_SPHERE_RADIUS<S> - CENTER_TORSO_RADIUS<S>, S(0.0), S(0.0));
-        m4_translate<S>(&c->ball_transform, &world->robot.left_arm.transform_to_hand, S(0.0), BALL_RADIUS<S> / S(2.0) + S(0.01), S(0.0));
-        m4_translate<S>(&c->cup_stem_transform, &world->robot.right_arm.transform_to_hand,
-                     S(0.0), S(0.0), CUP_GRIP_HEIGHT<S> / S(2.0));
-        m4_translate<S>(&c->cup_bowl_transform, &world->robot.right_arm.transform_to_hand,
-                     S(0.0), S(0.0), CUP_GRIP_HEIGHT<S> / S(2.0) + CUP_DIAMETER<S> / S(2.0));
-
-        for (unsigned i=0 ; i<CUP_BEAD_COUNT ; ++i) {
-            S x = c->bead_x[i];
-            S y = c->bead_y[i];
-
-            m4_translate<S>(&c->cup_bead_transform[i*2], &world->robot.right_arm.transform_to_hand,
-                         x, y, CUP_BOWL_HEIGHT<S> + CUP_GRIP_HEIGHT<S> / S(2.0) - CUP_BEAD_RADIUS<S>);
-            m4_translate<S>(&c->cup_bead_transform[i*2+1], &world->robot.right_arm.transform_to_hand,
-                         x, y, CUP_GRIP_HEIGHT<S> / S(2.0) - CUP_BASE_TO_BOWL<S> + CUP_BEAD_RADIUS<S>);
-        }
+        update_group(m, &c->right_arm);
+        update_group(m, &c->left_arm);
+        update_group(m, &c->torso);
+        update_group(m, &c->head);
+        update_group(m, &c->obstacles);
+        update_group(m, &c->ball);
+        update_group(m, &c->cup);
 
         /*
-         * we're forcing unconditional evaluation here to make sure
-         * there's no per-sampling-region bias on computation time.
+         * The original C implementation evaluated every pair
+         * unconditionally to avoid a per-sampling-region bias on
+         * computation time.  The bounding spheres make the time
+         * depend on the configuration anyway, so this stops at the
+         * first collision.  Each pair puts the group with more
+         * spheres first.
          */
-        world->in_collision = 0 != (
+        world->in_collision =
             /* self collision */
-            (dbool("torso<->right arm", collide_object_lists(c->torso, 3, c->right_arm, 1))?1:0) +
-            (dbool("torso<->left arm", collide_object_lists(c->torso, 3, c->left_arm, 1))?1:0) +
-            (dbool("left<->right arms", collide_object_lists(c->left_arm, 1, c->right_arm, 1))?1:0) +
-            (dbool("head<->right arm", collide_object_lists(c->head, 2, c->right_arm, 1))?1:0) +
-            (dbool("head<->left arm", collide_object_lists(c->head, 2, c->left_arm, 1))?1:0) +
+            collide_groups(m, &c->torso, &c->right_arm) ||
+            collide_groups(m, &c->torso, &c->left_arm) ||
+            collide_groups(m, &c->left_arm, &c->right_arm) ||
+            collide_groups(m, &c->head, &c->right_arm) ||
+            collide_groups(m, &c->head, &c->left_arm) ||
 
             /* environmental collisions */
-            (dbool("right arm<->obstacles", collide_object_lists(c->right_arm, 1, c->obstacles, NUM_OBSTACLES))?1:0) +
-            (dbool("left arm<->obstacles", collide_object_lists(c->left_arm, 1, c->obstacles, NUM_OBSTACLES))?1:0) +
-            (dbool("cup<->torso", collide_object_lists(c->cup, CUP_BEAD_COUNT * 2 + 2, c->torso, 3))?1:0) +
-            (dbool("cup<->obstacles", collide_object_lists(c->cup, CUP_BEAD_COUNT * 2 + 2, c->obstacles, NUM_OBSTACLES))?1:0) +
-            (dbool("cup<->left arm", collide_object_lists(c->cup, CUP_BEAD_COUNT * 2 + 2, c->left_arm, 1))?1:0) +
-            (dbool("cup<->head", collide_object_lists(c->cup, CUP_BEAD_COUNT * 2 + 2, c->head, 2))?1:0) +
-            (collide_object_lists(c->right_arm, 1, c->ball, 1)?1:0) +
-            (collide_object_lists(c->head, 2, c->ball, 1)?1:0) +
-            (collide_object_lists(c->torso, 3, c->ball, 1)?1:0) +
-            (collide_object_lists(c->obstacles, NUM_OBSTACLES, c->ball, 1)?1:0));
+            collide_groups(m, &c->obstacles, &c->right_arm) ||
+            collide_groups(m, &c->obstacles, &c->left_arm) ||
+            collide_groups(m, &c->cup, &c->torso) ||
+            collide_groups(m, &c->cup, &c->obstacles) ||
+            collide_groups(m, &c->cup, &c->left_arm) ||
+            collide_groups(m, &c->cup, &c->head) ||
+            collide_groups(m, &c->ball, &c->right_arm) ||
+            collide_groups(m, &c->head, &c->ball) ||
+            collide_groups(m, &c->torso, &c->ball) ||
+            collide_groups(m, &c->obstacles, &c->ball);
 
         return world->in_collision;
     }
@@ -813,22 +736,43 @@ namespace nao_cup {
            !validate_is_self_collision(&world->nao); */
     }
 
+    /*
+     * Checks the motion from a to b at the midpoints of its recursive
+     * bisection down to DISCRETIZATION, without recursion.  The
+     * bisection to depth k checks the points a + (b-a)*i/2^k for odd
+     * i, so the motion is checked one depth at a time, coarsest
+     * first, to find a collision as early as possible.
+     */
     template <typename S>
     bool nao_link_impl(nao_world<S> *world, const S *a, const S *b) {
         S d = nao_dist(a, b);
+        S v[DIMENSIONS];
         S m[DIMENSIONS];
+        unsigned depth = 0;
 
-        if (d < DISCRETIZATION<S>) {
-                return true;
+        while (d >= DISCRETIZATION<S>) {
+            d /= S(2.0);
+            ++depth;
         }
 
-        for (unsigned i=0 ; i<DIMENSIONS ; ++i) {
-            m[i] = (a[i] + b[i]) / S(2.0);
+        if (depth == 0)
+            return true;
+
+        for (unsigned i=0 ; i<DIMENSIONS ; ++i)
+            v[i] = b[i] - a[i];
+
+        for (unsigned k=1 ; k<=depth ; ++k) {
+            S scale = std::ldexp(S(1), -(int)k);
+            for (unsigned j=1 ; j < (1u << k) ; j += 2) {
+                S t = j * scale;
+                for (unsigned i=0 ; i<DIMENSIONS ; ++i)
+                    m[i] = a[i] + v[i] * t;
+                if (!nao_clear(world, m))
+                    return false;
+            }
         }
 
-        return nao_clear(world, m)
-            && nao_link_impl(world, a, m)
-            && nao_link_impl(world, m, b);
+        return true;
     }
 
     template <typename S>
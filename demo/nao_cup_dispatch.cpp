@@ -0,0 +1,212 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+// Runs the NAO cup planner variant best suited to the problem and the
+// CPU, in place of picking one of the nao_cup_planning-* binaries by
+// hand.  The variants are compiled into one module per instruction
+// set level (nao_cup_variants_<isa>.so, next to this binary), of
+// which the highest level the CPU supports is loaded.
+
+#include "nao_cup_variants.hpp"
+#include "nao_cup_scenario.hpp"
+#include <mpt/log.hpp>
+#include <dlfcn.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <climits>
+#include <iostream>
+#include <string>
+#include <omp.h>
+
+namespace mpt_demo {
+    class NaoCupVariantModule {
+        void *handle_{nullptr};
+        NaoCupVariantRunFn run_{nullptr};
+
+        void unload() {
+            if (handle_)
+                dlclose(handle_);
+            handle_ = nullptr;
+            run_ = nullptr;
+        }
+
+    public:
+        NaoCupVariantModule() = default;
+        NaoCupVariantModule(const NaoCupVariantModule&) = delete;
+        NaoCupVariantModule& operator = (const NaoCupVariantModule&) = delete;
+
+        ~NaoCupVariantModule() {
+            unload();
+        }
+
+        // loads the module compiled for isa from dir, returns false
+        // if it was not built or was built for a different level.
+        bool load(const std::string& dir, InstructionSet isa) {
+            unload();
+            std::string path = dir + "/" + naoCupVariantModule(isa);
+            if ((handle_ = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)) == nullptr) {
+                MPT_LOG(DEBUG) << "cannot load " << path << ": " << dlerror();
+                return false;
+            }
+
+            auto isaFn = reinterpret_cast<NaoCupVariantISAFn>(dlsym(handle_, kNaoCupVariantISASymbol));
+            run_ = reinterpret_cast<NaoCupVariantRunFn>(dlsym(handle_, kNaoCupVariantRunSymbol));
+            if (isaFn == nullptr || run_ == nullptr) {
+                MPT_LOG(WARN) << path << " is not a planner variant module";
+                unload();
+                return false;
+            }
+
+            if (isaFn() != isa) {
+                MPT_LOG(WARN) << path << " was compiled for " << instructionSetName(isaFn())
+                              << " instead of " << instructionSetName(isa);
+                unload();
+                return false;
+            }
+
+            MPT_LOG(DEBUG) << "loaded " << path;
+            return true;
+        }
+
+        int run(const NaoCupRun& run) const {
+            return run_(run);
+        }
+    };
+
+    inline std::string executableDir(const char *argv0) {
+        std::string path;
+        char buf[PATH_MAX];
+        ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf));
+        path = n > 0 ? std::string(buf, n) : std::string(argv0);
+        std::size_t slash = path.rfind('/');
+        return slash == std::string::npos ? "." : path.substr(0, slash);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace unc::robotics::mpt;
+    using namespace mpt_demo;
+
+    static struct option options[] = {
+        { "solve-time", required_argument, 0, 't' },
+        { "algorithm", required_argument, 0, 'a' },
+        { "node-count", required_argument, 0, 'n' },
+        { "solved", no_argument, 0, 'S' },
+        { "variant", required_argument, 0, 'V' },
+        { "module-dir", required_argument, 0, 'M' },
+        { nullptr, 0, nullptr, 0 }
+    };
+
+    int solveTimeMillis = -1;
+    bool terminateWhenSolved = false;
+    std::string algorithm = "rrtstar";
+    int nodeCount = -1;
+    PlannerVariantOverrides overrides;
+    std::string moduleDir = executableDir(argv[0]);
+
+    for (int c, optInd ; -1 != (c=getopt_long(argc, argv, "t:a:n:SV:M:", options, &optInd)) ; ) {
+        std::size_t pos;
+        std::string arg;
+
+        switch (c) {
+        case 't':
+            arg = optarg;
+            solveTimeMillis = std::stoi(arg, &pos);
+            if (pos != arg.length() || solveTimeMillis < 0)
+                throw std::invalid_argument("invalid solve time: " + arg);
+            break;
+        case 'n':
+            arg = optarg;
+            nodeCount = std::stoi(arg, &pos);
+            if (pos != arg.length() || nodeCount < 0)
+                throw std::invalid_argument("invalid node count: " + arg);
+            break;
+        case 'S':
+            terminateWhenSolved = true;
+            break;
+        case 'a':
+            algorithm = optarg;
+            break;
+        case 'V':
+            overrides = parsePlannerVariantOverrides(optarg);
+            break;
+        case 'M':
+            moduleDir = optarg;
+            break;
+        default:
+            std::cerr << "Usage: " << argv[0] << " [options]\n"
+                "Options:\n"
+                "  -t --solve-time=T    Run for T milliseconds\n"
+                "  -S --solved          Run until solved\n"
+                "  -n --node-count=N    Run until N nodes are generated\n"
+                "  -a --algorithm=A     Run algorithm (A = rrt, rrtstar, or prm)\n"
+                "  -V --variant=F,...   Override the selected variant's fields\n"
+                "                       (KDTreeBatch|GNAT, float|double, st|mt,\n"
+                "                        generic|avx2|avx512)\n"
+                "  -M --module-dir=DIR  Load the variant modules from DIR\n"
+                      << std::flush;
+            throw std::invalid_argument("unrecognized option");
+        }
+    }
+
+    InstructionSet host = hostInstructionSet();
+    if (overrides.isa && overrides.variant.isa > host) {
+        MPT_LOG(ERROR) << "CPU does not support " << instructionSetName(overrides.variant.isa);
+        return 1;
+    }
+
+    // load the highest level module that the CPU supports, or the one
+    // requested.
+    NaoCupVariantModule module;
+    InstructionSet isa = overrides.isa ? overrides.variant.isa : host;
+    for ( ; !module.load(moduleDir, isa) ; isa = InstructionSet(int(isa) - 1)) {
+        if (overrides.isa || isa == InstructionSet::kGeneric) {
+            MPT_LOG(ERROR) << "no planner variant module found in " << moduleDir;
+            return 1;
+        }
+    }
+
+    PlannerVariant variant = selectPlannerVariant(
+        NaoCupScenario<double>::kDimensions,
+        nodeCount > 0 ? std::size_t(nodeCount) : 0,
+        omp_get_max_threads(), isa);
+    overrides.apply(variant);
+
+    MPT_LOG(INFO) << "host " << instructionSetName(host) << ", running variant " << variant;
+
+    NaoCupRun run{variant, algorithm.c_str(), solveTimeMillis, nodeCount, terminateWhenSolved};
+    return module.run(run);
+}
@@ -0,0 +1,395 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+// Head-to-head benchmark of MPT's PRRT* against the original C
+// implementation of PRRT* on the NAO cup problem.  Both planners use
+// the same collision functions (nao_cup/src/naocup.hpp), the same
+// thread counts, and the same time limit, and the benchmark reports
+// their sampling rate, peak memory, and solution cost over time side
+// by side.  Example:
+//
+//    nao_cup_legacy_benchmark -j 1,4,8 -n 5 -t 5000
+//
+// Each run is forked into its own process, so that the peak resident
+// memory of each run is measured the same way for both
+// implementations and is not polluted by earlier runs.
+//
+// The C implementation is not part of this repository.  It is only
+// run when built with PRRTS_C (see PRRTS_C_LIBRARY in
+// CMakeLists.txt).  Since it only has a run-for-N-samples entry
+// point and seeds its own RNG, its cost over time is measured with
+// independent runs of doubling sample counts, each timed, until a run
+// takes the time limit.  Thus its costs over time come from separate
+// runs rather than one anytime run, and its seeds only number the
+// runs.
+
+#ifndef MPT_LOG_LEVEL
+#define MPT_LOG_LEVEL WARN
+#endif
+
+#include "benchmark.hpp"
+#include "benchmark_scenarios.hpp"
+#include "nao_cup_scenario.hpp"
+#ifdef PRRTS_C
+#include "prrts_c.hpp"
+#endif
+#include <mpt/prrt_star.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace mpt_demo {
+    using namespace unc::robotics::mpt;
+
+    // fractions of the time limit at which the cost is reported
+    static constexpr std::array<double, 4> kCheckpoints{{0.125, 0.25, 0.5, 1.0}};
+
+    struct LegacyBenchmarkOptions : BenchmarkOptions {
+        std::string output;
+
+        // PRRT* rewiring constant of the C implementation
+        double gamma{5.0};
+    };
+
+    // The result of a single run, sent from the forked process to the
+    // parent through a pipe, thus it must be trivially copyable.
+    struct RunResult {
+        bool ok{false};
+        double samplesPerSecond{0};
+        std::size_t peakBytes{0};
+        double firstSolutionTime{std::numeric_limits<double>::infinity()};
+        std::array<double, kCheckpoints.size()> cost;
+    };
+
+    // The peak resident set size of the process in bytes.
+    inline std::size_t peakResidentBytes() {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss;
+#else
+        return usage.ru_maxrss * std::size_t(1024);
+#endif
+    }
+
+    // Runs fn() in a child process and returns the RunResult it
+    // returns.  The result is not ok if the child fails.
+    template <typename Fn>
+    RunResult runForked(Fn&& fn) {
+        int fds[2];
+        if (pipe(fds) != 0)
+            throw std::runtime_error("pipe failed");
+
+        pid_t pid = fork();
+        if (pid < 0)
+            throw std::runtime_error("fork failed");
+
+        if (pid == 0) {
+            close(fds[0]);
+            RunResult result;
+            try {
+                result = fn();
+            } catch (const std::exception& ex) {
+                MPT_LOG(ERROR) << "run failed: " << ex.what();
+            }
+            ssize_t n = write(fds[1], &result, sizeof(result));
+            _exit(n == sizeof(result) ? 0 : 1);
+        }
+
+        close(fds[1]);
+        RunResult result;
+        if (read(fds[0], &result, sizeof(result)) != sizeof(result))
+            result.ok = false;
+        close(fds[0]);
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            result.ok = false;
+        return result;
+    }
+
+    RunResult runMPT(unsigned threads, std::uint32_t seed, const LegacyBenchmarkOptions& options) {
+        using Scenario = NaoCupScenario<double>;
+        using State = typename Scenario::Config;
+
+        RunResult run;
+        Scenario scenario;
+        State start = Eigen::Map<const State>(nao_cup::nao_init_config<double>());
+        std::size_t baseBytes = peakResidentBytes();
+        BenchmarkResult result = runBenchmark<PRRTStar<>>(
+            "prrt_star", "nao_cup", scenario, start, threads, seed, options);
+        run.peakBytes = peakResidentBytes() - baseBytes;
+
+        run.samplesPerSecond = result.samplesPerSecond;
+        if (result.solved)
+            run.firstSolutionTime = result.firstSolutionTime;
+
+        // costVsTime records each change in cost, thus the cost at a
+        // checkpoint is that of the last change before it.
+        double limit = std::chrono::duration<double>(options.timeLimit).count();
+        for (std::size_t i = 0 ; i < kCheckpoints.size() ; ++i) {
+            run.cost[i] = std::numeric_limits<double>::infinity();
+            for (auto [t, cost] : result.costVsTime)
+                if (t <= kCheckpoints[i] * limit)
+                    run.cost[i] = cost;
+        }
+        run.ok = true;
+        return run;
+    }
+
+#ifdef PRRTS_C
+    RunResult runLegacy(unsigned threads, const LegacyBenchmarkOptions& options) {
+        using Clock = std::chrono::steady_clock;
+
+        RunResult run;
+        std::unique_ptr<nao_cup::prrts_system<double>, void(*)(nao_cup::prrts_system<double>*)> system(
+            nao_cup::naocup_create_system<double>(), nao_cup::naocup_free_system<double>);
+        prrts_options prrtsOptions{options.gamma, false, 1};
+
+        double limit = std::chrono::duration<double>(options.timeLimit).count();
+        std::size_t baseBytes = peakResidentBytes();
+        std::vector<std::pair<double, double>> costVsTime;
+        for (std::size_t samples = 1000 ; ; samples *= 2) {
+            Clock::time_point start = Clock::now();
+            prrts_solution *solution = prrts_run_for_samples(
+                system.get(), &prrtsOptions, static_cast<int>(threads), samples);
+            double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            double cost = solution ? solution->path_cost : std::numeric_limits<double>::infinity();
+            free(solution);
+
+            costVsTime.emplace_back(elapsed, cost);
+            run.samplesPerSecond = samples / elapsed;
+            if (std::isfinite(cost) && !std::isfinite(run.firstSolutionTime))
+                run.firstSolutionTime = elapsed;
+            if (elapsed >= limit)
+                break;
+        }
+        run.peakBytes = peakResidentBytes() - baseBytes;
+
+        for (std::size_t i = 0 ; i < kCheckpoints.size() ; ++i) {
+            run.cost[i] = std::numeric_limits<double>::infinity();
+            for (auto [t, cost] : costVsTime)
+                if (t <= kCheckpoints[i] * limit)
+                    run.cost[i] = cost;
+        }
+        run.ok = true;
+        return run;
+    }
+#endif
+
+    // The median over the runs of a field of the results, infinity
+    // sorts last, thus the median cost is infinite when fewer than
+    // half of the runs solved.
+    template <typename Fn>
+    double median(const std::vector<RunResult>& runs, Fn&& field) {
+        std::vector<double> v;
+        for (const RunResult& r : runs)
+            if (r.ok)
+                v.push_back(field(r));
+        if (v.empty())
+            return std::numeric_limits<double>::quiet_NaN();
+        std::nth_element(v.begin(), v.begin() + v.size()/2, v.end());
+        return v[v.size()/2];
+    }
+
+    void reportHeader(std::ostream& out, double limit) {
+        out << std::setw(8) << "threads"
+            << std::setw(12) << "planner"
+            << std::setw(8) << "runs"
+            << std::setw(14) << "samples/s"
+            << std::setw(12) << "peak MB"
+            << std::setw(12) << "first t(s)";
+        for (double c : kCheckpoints) {
+            std::ostringstream name;
+            name << "cost@" << c * limit;
+            out << std::setw(12) << name.str();
+        }
+        out << "\n";
+    }
+
+    void reportRow(std::ostream& out, unsigned threads, const char *name, const std::vector<RunResult>& runs) {
+        std::size_t ok = std::count_if(runs.begin(), runs.end(), [] (const RunResult& r) { return r.ok; });
+        std::ios::fmtflags flags = out.flags();
+        out << std::fixed
+            << std::setw(8) << threads
+            << std::setw(12) << name
+            << std::setw(8) << (std::to_string(ok) + "/" + std::to_string(runs.size()))
+            << std::setw(14) << std::setprecision(0) << median(runs, [] (auto& r) { return r.samplesPerSecond; })
+            << std::setw(12) << std::setprecision(1) << median(runs, [] (auto& r) { return r.peakBytes / 1048576.0; })
+            << std::setw(12) << std::setprecision(3) << median(runs, [] (auto& r) { return r.firstSolutionTime; });
+        for (std::size_t i = 0 ; i < kCheckpoints.size() ; ++i)
+            out << std::setw(12) << std::setprecision(4) << median(runs, [&] (auto& r) { return r.cost[i]; });
+        out << "\n";
+        out.flags(flags);
+    }
+
+    void writeJson(
+        std::ostream& out, const std::string& label, const char *planner,
+        unsigned threads, std::uint32_t seed, const RunResult& r, double limit)
+    {
+        auto num = [&] (double v) -> std::ostream& {
+            return std::isfinite(v) ? (out << v) : (out << "null");
+        };
+
+        out << "{\"label\":\"" << jsonEscape(label)
+            << "\",\"planner\":\"" << jsonEscape(planner)
+            << "\",\"scenario\":\"nao_cup\",\"threads\":" << threads
+            << ",\"seed\":" << seed
+            << ",\"ok\":" << (r.ok ? "true" : "false")
+            << ",\"samples_per_second\":";
+        num(r.samplesPerSecond) << ",\"peak_bytes\":" << r.peakBytes
+                                << ",\"first_solution_time\":";
+        num(r.firstSolutionTime) << ",\"cost_vs_time\":[";
+        for (std::size_t i = 0 ; i < kCheckpoints.size() ; ++i) {
+            out << (i ? ",[" : "[") << kCheckpoints[i] * limit << ',';
+            num(r.cost[i]) << ']';
+        }
+        out << "]}\n";
+    }
+
+    LegacyBenchmarkOptions parseOptions(int argc, char *argv[]) {
+        static struct option longOptions[] = {
+            { "solve-time", required_argument, 0, 't' },
+            { "threads", required_argument, 0, 'j' },
+            { "seeds", required_argument, 0, 'n' },
+            { "first-seed", required_argument, 0, 's' },
+            { "gamma", required_argument, 0, 'g' },
+            { "output", required_argument, 0, 'o' },
+            { "label", required_argument, 0, 'l' },
+            { nullptr, 0, nullptr, 0 }
+        };
+
+        LegacyBenchmarkOptions options;
+        options.seeds = 5;
+        options.timeLimit = std::chrono::milliseconds(5000);
+        for (int c, optInd ; -1 != (c=getopt_long(argc, argv, "t:j:n:s:g:o:l:", longOptions, &optInd)) ; ) {
+            switch (c) {
+            case 't':
+                options.timeLimit = std::chrono::milliseconds(parseNonNegative(optarg, "solve time"));
+                break;
+            case 'j':
+                options.threads = parseThreads(optarg);
+                break;
+            case 'n':
+                options.seeds = std::max(1, parseNonNegative(optarg, "seed count"));
+                break;
+            case 's':
+                options.firstSeed = parseNonNegative(optarg, "seed");
+                break;
+            case 'g':
+                options.gamma = parseDouble(optarg, "gamma");
+                break;
+            case 'o':
+                options.output = optarg;
+                break;
+            case 'l':
+                options.label = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [options]\n"
+                    "Options:\n"
+                    "  -t --solve-time=T    Run each planner for T milliseconds (default 5000)\n"
+                    "  -j --threads=N,...   Thread counts to run with (default 1)\n"
+                    "  -n --seeds=N         Number of runs per thread count (default 5)\n"
+                    "  -s --first-seed=S    First seed (default 1)\n"
+                    "  -g --gamma=G         Rewiring constant of the C PRRT* (default 5)\n"
+                    "  -o --output=FILE     Also append each run as JSON to FILE\n"
+                    "  -l --label=L         Label the results, e.g., with the machine type\n"
+                          << std::flush;
+                throw std::invalid_argument("unrecognized option");
+            }
+        }
+        return options;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace mpt_demo;
+
+    try {
+        LegacyBenchmarkOptions options = parseOptions(argc, argv);
+        std::ofstream json;
+        if (!options.output.empty()) {
+            json.open(options.output, std::ios::app);
+            if (!json)
+                throw std::runtime_error("failed to open " + options.output);
+        }
+
+        double limit = std::chrono::duration<double>(options.timeLimit).count();
+#ifndef PRRTS_C
+        std::cerr << "built without the C PRRT* (PRRTS_C_LIBRARY), only running MPT" << std::endl;
+#endif
+
+        std::vector<std::pair<unsigned, std::array<std::vector<RunResult>, 2>>> results;
+        for (unsigned threads : options.threads) {
+            auto& [t, runs] = results.emplace_back();
+            t = threads;
+            for (unsigned i = 0 ; i < options.seeds ; ++i) {
+                std::uint32_t seed = options.firstSeed + i;
+                std::cerr << "running " << threads << " threads, seed " << seed << std::endl;
+
+                runs[0].push_back(runForked([&] { return runMPT(threads, seed, options); }));
+                if (json.is_open())
+                    writeJson(json, options.label, "mpt", threads, seed, runs[0].back(), limit);
+#ifdef PRRTS_C
+                runs[1].push_back(runForked([&] { return runLegacy(threads, options); }));
+                if (json.is_open())
+                    writeJson(json, options.label, "prrts_c", threads, seed, runs[1].back(), limit);
+#endif
+            }
+        }
+
+        std::cout << "\nPRRT* on nao_cup, median of " << options.seeds << " runs\n";
+        reportHeader(std::cout, limit);
+        for (auto& [threads, runs] : results) {
+            reportRow(std::cout, threads, "mpt", runs[0]);
+            if (!runs[1].empty())
+                reportRow(std::cout, threads, "prrts_c", runs[1]);
+        }
+
+        return 0;
+    } catch (const std::exception& ex) {
+        MPT_LOG(FATAL) << "terminated with exception: " << ex.what();
+        return 1;
+    }
+}
@@ -0,0 +1,128 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_NAO_CUP_RUN_PLANNER_HPP
+#define MPT_DEMO_NAO_CUP_RUN_PLANNER_HPP
+
+#include "nao_cup_scenario.hpp"
+#include "proc_info.hpp"
+#include <mpt/planner.hpp>
+#include <mpt/log.hpp>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace mpt_demo {
+    // Runs the planner on the NAO cup problem, shared between the
+    // per-variant nao_cup_planning binaries and the variants of
+    // nao_cup_dispatch.
+    template <typename S, typename Algorithm>
+    int runPlanner(int solveTimeMillis, int nodeCount, bool terminateWhenSolved) {
+        using namespace unc::robotics::mpt;
+        using Scenario = NaoCupScenario<S>;
+        using Space = typename Scenario::Space;
+        using Config = typename Space::Type;
+
+        Config qGoal;
+        qGoal <<
+            S(0.258284303377494),
+            S(-0.2699099199363406),
+            S(-0.01113121187052224),
+            S(1.2053012757652763),
+            S(1.2716626717484503),
+            S(-0.9826967097045605),
+            S(0.07355836822937814),
+            S(0.25450053440459897),
+            S(-0.9512909033938429),
+            S(-0.5297424293532234);
+
+        MPT_LOG(INFO) << "state type: " << log::type_name<Config>();
+        Scenario scenario;
+        auto space = scenario.space();
+        bool isGoalV = scenario.goal()(space, qGoal).first;
+        MPT_LOG(INFO) << "GOAL: " << isGoalV;
+        Planner<Scenario, Algorithm> planner(scenario);
+
+        planner.addStart(Eigen::Map<const Config>(nao_cup::nao_init_config<S>()));
+        using Clock = std::chrono::steady_clock;
+        //planner.solve([&] { return planner.solved(); });
+        //Clock::duration maxSolveTime = 10s;
+        // planner.solve([start] { return Clock::now() - start >= maxSolveTime; });
+        // planner.setRange(2.5);
+
+        // setGoalBias is not available on all planners
+        // planner.setGoalBias(0.01);
+
+        auto start = Clock::now();
+        if (solveTimeMillis > 0) {
+            if (terminateWhenSolved) {
+                planner.solveFor([&] { return planner.solved(); }, std::chrono::milliseconds(solveTimeMillis));
+            } else {
+                planner.solveFor(std::chrono::milliseconds(solveTimeMillis));
+            }
+        } else if (nodeCount > 0) {
+            planner.solve([&, count = std::size_t(nodeCount)] { return planner.size() >= count; });
+        } else if (terminateWhenSolved) {
+            planner.solve([&] { return planner.solved(); });
+        } else {
+            MPT_LOG(ERROR) << "termination condition not specified";
+            return 1;
+        }
+
+        auto elapsed = Clock::now() - start;
+        MPT_LOG(INFO) << "solve time " << elapsed << " seconds";
+        planner.printStats();
+
+        if (planner.solved()) {
+            std::vector<Config> path = planner.solution();
+
+            S cost = 0;
+            auto curr = path.begin();
+            if (curr != path.end()) {
+                for (auto prev = curr ; ++curr != path.end() ; prev = curr)
+                    cost += scenario.space().distance(*prev, *curr);
+            }
+            MPT_LOG(INFO) << "path cost " << cost;
+        }
+
+        std::cout << ProcInfo() << std::flush;
+
+        return 0;
+    }
+}
+
+#endif
@@ -0,0 +1,158 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_DEMO_NAO_CUP_SCENARIO_HPP
+#define MPT_DEMO_NAO_CUP_SCENARIO_HPP
+
+#include "nao_cup/src/naocup.hpp"
+#include <mpt/lp_space.hpp>
+#include <mpt/box_bounds.hpp>
+#include <mpt/goal_state.hpp>
+#include <mpt/log.hpp>
+#include <mpt/scenario_data.hpp>
+#include <memory>
+
+namespace mpt_demo {
+    using namespace unc::robotics::mpt;
+
+    template <typename S>
+    class NaoCupScenario {
+    public:
+        static constexpr int kDimensions =  10;
+        using Scalar = S;
+        using Space = L2Space<Scalar, kDimensions>;
+        using Config = typename Space::Type;
+
+        Space space_;
+#if 0
+        class Goal {
+            mutable void *instance_;
+
+        public:
+            Goal(void *instance) : instance_{instance} {
+            }
+
+            std::pair<bool, Scalar> operator() (const Space&, const Config& q) const {
+                return {nao_in_goal(instance_, q.data()), Scalar(0)};
+            }
+        };
+
+        Goal goal() const {
+            return instance_;
+        }
+#else
+        using Goal = GoalState<Space>;
+
+        const Goal& goal() const {
+            static const Goal inst(
+                1e-5,
+                (Config() <<
+                 S(0.258284303377494),
+                 S(-0.2699099199363406),
+                 S(-0.01113121187052224),
+                 S(1.2053012757652763),
+                 S(1.2716626717484503),
+                 S(-0.9826967097045605),
+                 S(0.07355836822937814),
+                 S(0.25450053440459897),
+                 S(-0.9512909033938429),
+                 S(-0.5297424293532234)).finished());
+            return inst;
+        }
+#endif
+
+    private:
+        using System = nao_cup::prrts_system<S>;
+
+        // Per-thread collision checking state (the nao_world of
+        // naocup.hpp), see ScenarioData.
+        class Context {
+            const System& system_;
+            void *instance_;
+
+        public:
+            explicit Context(const System& system)
+                : system_(system)
+                , instance_(system.system_data_alloc_func(0, nullptr, nullptr))
+            {
+                MPT_LOG(TRACE) << "created scenario context";
+            }
+
+            Context(const Context&) = delete;
+            Context& operator = (const Context&) = delete;
+
+            ~Context() {
+                system_.system_data_free_func(instance_);
+            }
+
+            void *instance() const {
+                return instance_;
+            }
+        };
+
+        ScenarioData<System, Context> data_;
+
+    public:
+        NaoCupScenario()
+            : data_(std::shared_ptr<const System>(
+                        nao_cup::naocup_create_system<S>(), nao_cup::naocup_free_system<S>))
+        {
+        }
+
+        const Space& space() const {
+            return space_;
+        }
+
+        const BoxBounds<Scalar, kDimensions> bounds() const {
+            using Map = Eigen::Map<const Eigen::Matrix<Scalar, kDimensions, 1>>;
+            static BoxBounds<Scalar, kDimensions> inst{
+                Map(nao_cup::nao_min_config<S>()),
+                Map(nao_cup::nao_max_config<S>())
+            };
+            return inst;
+        }
+
+        bool valid(const Config& q) const {
+            return nao_cup::nao_clear(data_.context().instance(), q.data());
+        }
+
+        bool link(const Config& a, const Config& b) const {
+            return nao_cup::nao_link(data_.context().instance(), a.data(), b.data());
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+// Module instantiating every planner variant for the NAO cup problem.
+// It is built once per instruction set level (see CMakeLists.txt) and
+// loaded by nao_cup_dispatch.
+
+#include "nao_cup_variants.hpp"
+#include "nao_cup_run_planner.hpp"
+#include <mpt/prrt.hpp>
+#include <mpt/prrt_star.hpp>
+#include <mpt/pprm.hpp>
+#include <string>
+
+namespace mpt_demo {
+    template <typename S, typename NN, typename Threads>
+    int runAlgorithm(const NaoCupRun& run) {
+        using namespace unc::robotics::mpt;
+        static constexpr bool reportStats = false;
+        std::string algorithm(run.algorithm);
+
+        if (algorithm == "rrt") {
+            using Algorithm = PRRT<report_stats<reportStats>, Threads, NN>;
+            return runPlanner<S, Algorithm>(run.solveTimeMillis, run.nodeCount, run.terminateWhenSolved);
+        } else if (algorithm == "rrtstar") {
+            using Algorithm = PRRTStar<report_stats<reportStats>, Threads, NN>;
+            return runPlanner<S, Algorithm>(run.solveTimeMillis, run.nodeCount, run.terminateWhenSolved);
+        } else if (algorithm == "prm") {
+            using Algorithm = PPRM<report_stats<reportStats>, Threads, NN>;
+            return runPlanner<S, Algorithm>(run.solveTimeMillis, run.nodeCount, run.terminateWhenSolved);
+        } else {
+            MPT_LOG(ERROR) << "algorithm invalid: " << algorithm;
+            return 1;
+        }
+    }
+
+    template <typename S, typename NN>
+    int runThreads(const NaoCupRun& run) {
+        using namespace unc::robotics::mpt;
+        return run.variant.multiThreaded
+            ? runAlgorithm<S, NN, hardware_concurrency>(run)
+            : runAlgorithm<S, NN, single_threaded>(run);
+    }
+
+    template <typename S>
+    int runNN(const NaoCupRun& run) {
+        using namespace unc::robotics::nigh;
+        return run.variant.nn == NNStrategy::kGNAT
+            ? runThreads<S, GNAT<>>(run)
+            : runThreads<S, KDTreeBatch<>>(run);
+    }
+}
+
+extern "C" __attribute__((visibility("default")))
+mpt_demo::InstructionSet mpt_demo_nao_cup_variant_isa() {
+    return unc::robotics::mpt::compiledInstructionSet();
+}
+
+extern "C" __attribute__((visibility("default")))
+int mpt_demo_nao_cup_variant_run(const mpt_demo::NaoCupRun& run) {
+    using namespace mpt_demo;
+    return run.variant.singlePrecision
+        ? runNN<float>(run)
+        : runNN<double>(run);
+}
@@ -0,0 +1,74 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_NAO_CUP_VARIANTS_HPP
+#define MPT_DEMO_NAO_CUP_VARIANTS_HPP
+
+#include "planner_variant.hpp"
+
+// Interface between nao_cup_dispatch and the nao_cup_variants_<isa>
+// modules.  Each module instantiates every PlannerVariant for one
+// instruction set level.  The modules are loaded as separate shared
+// objects with hidden visibility, rather than linked into the
+// dispatcher, since the linker would otherwise merge the inline
+// functions and template instantiations common to all levels (e.g.,
+// the collision checker), and could pick an AVX-512 copy for the
+// generic variant.
+
+namespace mpt_demo {
+    struct NaoCupRun {
+        PlannerVariant variant;
+        const char *algorithm;
+        int solveTimeMillis;
+        int nodeCount;
+        bool terminateWhenSolved;
+    };
+
+    // the instruction set level a module was compiled for.
+    using NaoCupVariantISAFn = InstructionSet (*)();
+    static constexpr const char *kNaoCupVariantISASymbol = "mpt_demo_nao_cup_variant_isa";
+
+    // runs the planner, returns the process exit status.
+    using NaoCupVariantRunFn = int (*)(const NaoCupRun&);
+    static constexpr const char *kNaoCupVariantRunSymbol = "mpt_demo_nao_cup_variant_run";
+
+    inline std::string naoCupVariantModule(InstructionSet isa) {
+        return std::string("nao_cup_variants_") + instructionSetName(isa) + ".so";
+    }
+}
+
+#endif
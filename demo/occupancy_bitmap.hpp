@@ -0,0 +1,239 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_OCCUPANCY_BITMAP_HPP
+#define MPT_DEMO_OCCUPANCY_BITMAP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mpt_demo {
+    // A packed occupancy grid, 1 bit per pixel, for checking segments
+    // against grid obstacles.  Pixel (x, y) covers the square of side
+    // 1 centered at (x, y), matching the rounding of grid scenarios'
+    // valid().
+    //
+    // Along with the full resolution bitmap, it keeps a pyramid of
+    // "any occupied" bitmaps, where each bit of a level covers 2x2
+    // bits of the level below.  A segment is checked one row of cells
+    // at a time: the cells of a row that the segment touches form a
+    // contiguous span, which is tested 64 cells per word with masks.
+    // The check starts at a level where the segment spans at most two
+    // rows, and only descends into rows whose span has an occupied
+    // cell, thus segments through open space are accepted from a few
+    // words of a coarse level.
+    //
+    // The test is exact for the supercover of the segment (every
+    // pixel the closed segment touches), it does not sample points
+    // along it.
+    class OccupancyBitmap {
+        using Word = std::uint64_t;
+        static constexpr int kWordBits = 64;
+
+        struct Level {
+            int width;
+            int height;
+            std::size_t stride; // words per row
+            std::vector<Word> bits;
+
+            Level(int w, int h)
+                : width(w)
+                , height(h)
+                , stride((w + kWordBits - 1) / kWordBits)
+                , bits(stride * h)
+            {
+            }
+
+            const Word* row(int y) const { return &bits[stride * y]; }
+            Word* row(int y) { return &bits[stride * y]; }
+
+            bool get(int x, int y) const {
+                return (row(y)[x / kWordBits] >> (x % kWordBits)) & 1;
+            }
+
+            // true if none of the cells x0..x1 (inclusive) of row y
+            // are occupied.
+            bool spanFree(int y, int x0, int x1) const {
+                const Word *r = row(y);
+                std::size_t i0 = x0 / kWordBits, i1 = x1 / kWordBits;
+                Word lo = ~Word(0) << (x0 % kWordBits);
+                Word hi = ~Word(0) >> (kWordBits - 1 - x1 % kWordBits);
+                if (i0 == i1)
+                    return (r[i0] & lo & hi) == 0;
+                Word any = (r[i0] & lo) | (r[i1] & hi);
+                for (std::size_t i = i0 + 1 ; i < i1 ; ++i)
+                    any |= r[i];
+                return any == 0;
+            }
+        };
+
+        // the even bits of v, packed into the low 32 bits.
+        static Word compactEvenBits(Word v) {
+            v &= 0x5555555555555555ull;
+            v = (v | (v >> 1)) & 0x3333333333333333ull;
+            v = (v | (v >> 2)) & 0x0f0f0f0f0f0f0f0full;
+            v = (v | (v >> 4)) & 0x00ff00ff00ff00ffull;
+            v = (v | (v >> 8)) & 0x0000ffff0000ffffull;
+            v = (v | (v >> 16)) & 0x00000000ffffffffull;
+            return v;
+        }
+
+        // the segment in cell coordinates, where pixel (x, y) covers
+        // [x, x+1) x [y, y+1).
+        struct Segment {
+            double ax, ay, bx, by;
+
+            // the range of x covered by the segment within the closed
+            // band of y in [y0, y1], returns false if it does not
+            // enter the band.
+            bool xRange(double y0, double y1, double& x0, double& x1) const {
+                double t0, t1;
+                if (ay == by) {
+                    if (ay < y0 || ay > y1)
+                        return false;
+                    t0 = 0;
+                    t1 = 1;
+                } else {
+                    t0 = (y0 - ay) / (by - ay);
+                    t1 = (y1 - ay) / (by - ay);
+                    if (t0 > t1)
+                        std::swap(t0, t1);
+                    t0 = std::max(t0, 0.0);
+                    t1 = std::min(t1, 1.0);
+                    if (t0 > t1)
+                        return false;
+                }
+                double xa = ax + (bx - ax) * t0;
+                double xb = ax + (bx - ax) * t1;
+                x0 = std::min(xa, xb);
+                x1 = std::max(xa, xb);
+                return true;
+            }
+        };
+
+        std::vector<Level> levels_;
+
+        bool rowsFree(int level, int r0, int r1, const Segment& s) const {
+            const Level& l = levels_[level];
+            double size = double(1 << level);
+            for (int r = r0 ; r <= r1 ; ++r) {
+                double x0, x1;
+                if (!s.xRange(r * size, (r + 1) * size, x0, x1))
+                    continue;
+                int c0 = std::clamp(int(std::floor(x0 / size)), 0, l.width - 1);
+                int c1 = std::clamp(int(std::floor(x1 / size)), 0, l.width - 1);
+                if (l.spanFree(r, c0, c1))
+                    continue;
+                if (level == 0)
+                    return false;
+                if (!rowsFree(level - 1, 2*r, std::min(2*r + 1, levels_[level-1].height - 1), s))
+                    return false;
+            }
+            return true;
+        }
+
+    public:
+        // occupied is row-major, width * height pixels.
+        OccupancyBitmap(int width, int height, const std::vector<bool>& occupied) {
+            assert(width > 0 && height > 0);
+            assert(occupied.size() == std::size_t(width) * height);
+
+            Level& base = levels_.emplace_back(width, height);
+            for (int y = 0 ; y < height ; ++y) {
+                Word *r = base.row(y);
+                for (int x = 0 ; x < width ; ++x)
+                    if (occupied[std::size_t(y) * width + x])
+                        r[x / kWordBits] |= Word(1) << (x % kWordBits);
+            }
+
+            while (levels_.back().width > 1 || levels_.back().height > 1) {
+                const Level& fine = levels_.back();
+                Level coarse((fine.width + 1) / 2, (fine.height + 1) / 2);
+                for (int y = 0 ; y < coarse.height ; ++y) {
+                    const Word *r0 = fine.row(2*y);
+                    const Word *r1 = 2*y + 1 < fine.height ? fine.row(2*y + 1) : r0;
+                    Word *out = coarse.row(y);
+                    for (std::size_t i = 0 ; i < fine.stride ; ++i) {
+                        Word v = r0[i] | r1[i];
+                        out[i / 2] |= compactEvenBits(v | (v >> 1)) << (i % 2 * 32);
+                    }
+                }
+                levels_.push_back(std::move(coarse));
+            }
+        }
+
+        int width() const { return levels_[0].width; }
+        int height() const { return levels_[0].height; }
+
+        bool occupied(int x, int y) const {
+            return levels_[0].get(x, y);
+        }
+
+        // true if no occupied pixel touches the segment from a to b,
+        // given in pixel coordinates.
+        template <typename Scalar>
+        bool segmentFree(Scalar ax, Scalar ay, Scalar bx, Scalar by) const {
+            Segment s{ax + 0.5, ay + 0.5, bx + 0.5, by + 0.5};
+
+            // the lowest level at which the segment's rows span at most
+            // 2 cells.
+            double dy = std::abs(s.by - s.ay);
+            int level = 0;
+            while (level + 1 < int(levels_.size()) && double(1 << level) < dy)
+                ++level;
+
+            const Level& l = levels_[level];
+            double size = double(1 << level);
+            int r0 = std::clamp(int(std::floor(std::min(s.ay, s.by) / size)), 0, l.height - 1);
+            int r1 = std::clamp(int(std::floor(std::max(s.ay, s.by) / size)), 0, l.height - 1);
+            return rowsFree(level, r0, r1, s);
+        }
+
+        std::size_t memoryUsage() const {
+            std::size_t bytes = sizeof(*this);
+            for (const Level& l : levels_)
+                bytes += sizeof(l) + l.bits.size() * sizeof(Word);
+            return bytes;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,318 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+// Runs every planner over a set of scenarios, thread counts, and
+// seeds, and writes the results to a file with one JSON object per
+// run.  Example:
+//
+//    planner_benchmark -t 1000 -j 1,4,8 -n 20 -o results.jsonl --se3 Home.cfg
+//
+// where Home.cfg is from omplapp/resources/3D.
+//
+// Results from multiple builds can be appended to the same file and
+// told apart with --label.
+//
+// To profile the planners without the cost of collision checking,
+// run once with --record=DIR to save the collision queries of each
+// run to DIR, then with --replay=DIR to answer the queries from the
+// saved traces (see collision_trace.hpp).
+
+// Trace logging in the planners would skew the results.
+#ifndef MPT_LOG_LEVEL
+#define MPT_LOG_LEVEL INFO
+#endif
+
+#include "benchmark.hpp"
+#include "benchmark_scenarios.hpp"
+#include "collision_trace.hpp"
+#include <mpt/pprm.hpp>
+#include <mpt/pprm_irs.hpp>
+#include <mpt/prrt.hpp>
+#include <mpt/prrt_star.hpp>
+#include <nigh/gnat.hpp>
+#include <nigh/linear.hpp>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+
+namespace mpt_demo {
+    using namespace unc::robotics::mpt;
+
+    struct PlannerBenchmarkOptions : BenchmarkOptions, BenchmarkScenarioOptions {
+        std::vector<std::string> planners;
+        std::string output{"benchmark.jsonl"};
+
+        // directories to record collision traces to, or replay them
+        // from.
+        std::string recordDir;
+        std::string replayDir;
+
+        bool plannerSelected(const std::string& name) const {
+            return benchmarkSelected(planners, name);
+        }
+
+        // planners that only run when named
+        bool plannerNamed(const std::string& name) const {
+            return std::find(planners.begin(), planners.end(), name) != planners.end();
+        }
+    };
+
+    // Calls fn(PlannerType<Algorithm>{}, name) for each selected
+    // planner.  The variants with a nearest neighbor strategy other
+    // than the default only run when named.
+    template <typename Fn>
+    void forEachPlanner(const PlannerBenchmarkOptions& options, Fn&& fn) {
+        if (options.plannerSelected("prrt"))
+            fn(PlannerType<PRRT<>>{}, "prrt");
+        if (options.plannerSelected("prrt_star_k"))
+            fn(PlannerType<PRRTStar<rewire_k_nearest>>{}, "prrt_star_k");
+        if (options.plannerSelected("prrt_star_r"))
+            fn(PlannerType<PRRTStar<rewire_r_nearest>>{}, "prrt_star_r");
+        if (options.plannerSelected("pprm"))
+            fn(PlannerType<PPRM<>>{}, "pprm");
+        if (options.plannerSelected("pprm_irs"))
+            fn(PlannerType<PPRMIRS<>>{}, "pprm_irs");
+
+        if (options.plannerNamed("prrt_gnat"))
+            fn(PlannerType<PRRT<nigh::GNAT<>>>{}, "prrt_gnat");
+        if (options.plannerNamed("prrt_linear"))
+            fn(PlannerType<PRRT<nigh::Linear>>{}, "prrt_linear");
+        if (options.plannerNamed("prrt_star_k_gnat"))
+            fn(PlannerType<PRRTStar<rewire_k_nearest, nigh::GNAT<>>>{}, "prrt_star_k_gnat");
+        if (options.plannerNamed("prrt_star_k_linear"))
+            fn(PlannerType<PRRTStar<rewire_k_nearest, nigh::Linear>>{}, "prrt_star_k_linear");
+    }
+
+    PlannerBenchmarkOptions parseOptions(int argc, char *argv[]) {
+        static struct option longOptions[] = {
+            { "solve-time", required_argument, 0, 't' },
+            { "solved", no_argument, 0, 'S' },
+            { "threads", required_argument, 0, 'j' },
+            { "seeds", required_argument, 0, 'n' },
+            { "first-seed", required_argument, 0, 's' },
+            { "interval", required_argument, 0, 'i' },
+            { "planner", required_argument, 0, 'a' },
+            { "scenario", required_argument, 0, 'c' },
+            { "se3", required_argument, 0, 'e' },
+            { "png", required_argument, 0, 'p' },
+            { "output", required_argument, 0, 'o' },
+            { "label", required_argument, 0, 'l' },
+            { "dimensions", required_argument, 0, 'd' },
+            { "obstacles", required_argument, 0, 'O' },
+            { "density", required_argument, 0, 'D' },
+            { "passage", required_argument, 0, 'P' },
+            { "check-cost", required_argument, 0, 'C' },
+            { "record", required_argument, 0, 'R' },
+            { "replay", required_argument, 0, 'Y' },
+            { nullptr, 0, nullptr, 0 }
+        };
+
+        PlannerBenchmarkOptions options;
+        for (int c, optInd ; -1 != (c=getopt_long(argc, argv, "t:Sj:n:s:i:a:c:e:p:o:l:d:O:D:P:C:R:Y:", longOptions, &optInd)) ; ) {
+            switch (c) {
+            case 't':
+                options.timeLimit = std::chrono::milliseconds(parseNonNegative(optarg, "solve time"));
+                break;
+            case 'S':
+                options.untilSolved = true;
+                break;
+            case 'j':
+                options.threads = parseThreads(optarg);
+                break;
+            case 'n':
+                options.seeds = parseNonNegative(optarg, "seed count");
+                break;
+            case 's':
+                options.firstSeed = parseNonNegative(optarg, "seed");
+                break;
+            case 'i':
+                options.sampleInterval = std::chrono::milliseconds(parseNonNegative(optarg, "interval"));
+                break;
+            case 'a':
+                options.planners.push_back(optarg);
+                break;
+            case 'c':
+                options.scenarios.push_back(optarg);
+                break;
+            case 'e':
+                options.se3Configs.push_back(optarg);
+                break;
+            case 'p':
+                options.pngFile = optarg;
+                break;
+            case 'o':
+                options.output = optarg;
+                break;
+            case 'l':
+                options.label = optarg;
+                break;
+            case 'd':
+                options.syntheticDimensions = parseSyntheticDimensions(optarg);
+                break;
+            case 'O':
+                options.synthetic.obstacleCount = parseNonNegative(optarg, "obstacle count");
+                break;
+            case 'D':
+                options.synthetic.obstacleDensity = parseDouble(optarg, "density");
+                break;
+            case 'P':
+                options.synthetic.passageWidth = parseDouble(optarg, "passage width");
+                break;
+            case 'C':
+                options.synthetic.checkCost = parseNonNegative(optarg, "check cost");
+                break;
+            case 'R':
+                options.recordDir = optarg;
+                break;
+            case 'Y':
+                options.replayDir = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [options]\n"
+                    "Options:\n"
+                    "  -t --solve-time=T    Run each benchmark for T milliseconds (default 1000)\n"
+                    "  -S --solved          Stop each benchmark when solved\n"
+                    "  -j --threads=N,...   Comma-separated thread counts (default 1)\n"
+                    "  -n --seeds=N         Number of seeds per configuration (default 10)\n"
+                    "  -s --first-seed=S    First seed (default 1)\n"
+                    "  -i --interval=T      Sample the solution cost every T milliseconds (default 10)\n"
+                    "  -a --planner=P       Run planner P (prrt, prrt_star_k, prrt_star_r, pprm, pprm_irs),\n"
+                    "                       may be repeated, default is all planners.  The nearest\n"
+                    "                       neighbor variants prrt_gnat, prrt_linear, prrt_star_k_gnat,\n"
+                    "                       and prrt_star_k_linear only run when named.\n"
+                    "  -c --scenario=S      Run scenario S (holonomic_2d, png_2d, link_manipulator,\n"
+                    "                       nao_cup, synthetic, se3), may be repeated, default is all\n"
+                    "  -e --se3=FILE        Add an OMPL.app SE(3) configuration file\n"
+                    "  -p --png=FILE        Input image for png_2d (default png_planning_input.png)\n"
+                    "  -o --output=FILE     Append results to FILE (default benchmark.jsonl)\n"
+                    "  -l --label=L         Label the results, e.g., with the build being tested\n"
+                    "  -R --record=DIR      Record the collision queries of each run to DIR\n"
+                    "  -Y --replay=DIR      Answer the collision queries from the traces in DIR,\n"
+                    "                       running as many iterations as the recorded runs\n"
+                    "Synthetic scenario options:\n"
+                    "  -d --dimensions=N,...  Dimensions to run (2, 4, 8, 16, or 32, default 8)\n"
+                    "  -O --obstacles=N       Number of hypersphere obstacles (default 20)\n"
+                    "  -D --density=F         Fraction of the volume covered by obstacles (default 0.2)\n"
+                    "  -P --passage=W         Width of the narrow passage, 0 for no wall (default 0.2)\n"
+                    "  -C --check-cost=N      Busy-work iterations per state check (default 0)\n"
+                          << std::flush;
+                throw std::invalid_argument("unrecognized option");
+            }
+        }
+        if (!options.recordDir.empty() && !options.replayDir.empty())
+            throw std::invalid_argument("--record and --replay are mutually exclusive");
+        return options;
+    }
+
+    std::string tracePath(
+        const std::string& dir, const std::string& plannerName, const std::string& scenarioName,
+        unsigned threads, std::uint32_t seed)
+    {
+        return dir + "/" + plannerName + "-" + scenarioName + "-"
+            + std::to_string(threads) + "-" + std::to_string(seed) + ".trace";
+    }
+
+    // Runs a benchmark, recording or replaying its collision queries
+    // when requested.
+    template <typename Algorithm, typename Scenario, typename State>
+    BenchmarkResult runTracedBenchmark(
+        const std::string& plannerName, const std::string& scenarioName,
+        const Scenario& scenario, const State& start,
+        unsigned threads, std::uint32_t seed,
+        const PlannerBenchmarkOptions& options)
+    {
+        if (!options.recordDir.empty()) {
+            auto trace = std::make_shared<CollisionTrace>();
+            RecordingScenario<Scenario> recording(scenario, trace);
+            BenchmarkResult result = runBenchmark<Algorithm>(
+                plannerName, scenarioName, recording, start, threads, seed, options);
+            trace->setIterations(result.iterations);
+            trace->save(tracePath(options.recordDir, plannerName, scenarioName, threads, seed));
+            MPT_LOG(INFO) << "recorded " << trace->size() << " collision queries";
+            return result;
+        }
+
+        if (!options.replayDir.empty()) {
+            auto trace = CollisionTrace::load(
+                tracePath(options.replayDir, plannerName, scenarioName, threads, seed));
+            BenchmarkOptions replayOptions = options;
+            replayOptions.maxIterations = trace->iterations();
+            ReplayScenario<Scenario> replay(scenario, trace);
+            BenchmarkResult result = runBenchmark<Algorithm>(
+                plannerName, scenarioName, replay, start, threads, seed, replayOptions);
+            if (trace->misses())
+                MPT_LOG(WARN) << trace->misses() << " of " << (trace->hits() + trace->misses())
+                              << " collision queries were not in the trace";
+            return result;
+        }
+
+        return runBenchmark<Algorithm>(
+            plannerName, scenarioName, scenario, start, threads, seed, options);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace mpt_demo;
+
+    try {
+        PlannerBenchmarkOptions options = parseOptions(argc, argv);
+        std::ofstream out(options.output, std::ios::app);
+        if (!out)
+            throw std::runtime_error("failed to open " + options.output);
+
+        std::size_t runs = 0;
+        forEachScenario(options, [&] (const std::string& scenarioName, const auto& scenario, const auto& start) {
+            forEachPlanner(options, [&] (auto type, const std::string& plannerName) {
+                using Algorithm = typename decltype(type)::type;
+                for (unsigned threads : options.threads) {
+                    for (unsigned i = 0 ; i < options.seeds ; ++i) {
+                        writeJson(out, runTracedBenchmark<Algorithm>(
+                                      plannerName, scenarioName, scenario, start,
+                                      threads, options.firstSeed + i, options),
+                                  options.label);
+                        out.flush();
+                        ++runs;
+                    }
+                }
+            });
+        });
+
+        MPT_LOG(INFO) << "wrote " << runs << " results to " << options.output;
+        return 0;
+    } catch (const std::exception& ex) {
+        MPT_LOG(FATAL) << "terminated with exception: " << ex.what();
+        return 1;
+    }
+}
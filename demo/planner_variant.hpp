@@ -0,0 +1,152 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_PLANNER_VARIANT_HPP
+#define MPT_DEMO_PLANNER_VARIANT_HPP
+
+#include <mpt/cpu_features.hpp>
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace mpt_demo {
+    using unc::robotics::mpt::InstructionSet;
+    using unc::robotics::mpt::instructionSetName;
+
+    enum class NNStrategy {
+        kKDTreeBatch,
+        kGNAT,
+    };
+
+    inline const char* nnStrategyName(NNStrategy nn) {
+        return nn == NNStrategy::kGNAT ? "GNAT" : "KDTreeBatch";
+    }
+
+    // One compile-time specialization of a planner: the template
+    // arguments selecting the nearest neighbor structure, scalar type
+    // and concurrency, and the instruction set level of the module it
+    // is instantiated in.  This is what the nao_cup_planning-* binaries
+    // encode in their names.
+    struct PlannerVariant {
+        NNStrategy nn{NNStrategy::kKDTreeBatch};
+        bool singlePrecision{false};
+        bool multiThreaded{true};
+        InstructionSet isa{InstructionSet::kGeneric};
+    };
+
+    template <typename Char, typename Traits>
+    std::basic_ostream<Char, Traits>& operator << (
+        std::basic_ostream<Char, Traits>& out, const PlannerVariant& v)
+    {
+        return out << nnStrategyName(v.nn)
+                   << '-' << (v.singlePrecision ? "float" : "double")
+                   << '-' << (v.multiThreaded ? "mt" : "st")
+                   << '-' << instructionSetName(v.isa);
+    }
+
+    // Above this many dimensions, the kd-tree's axis-aligned splits
+    // prune poorly and GNAT's metric partitioning is faster.
+    static constexpr unsigned kKDTreeMaxDimensions = 16;
+
+    // Below this many expected nodes, double precision costs little;
+    // above it, float halves the memory traffic of the nearest
+    // neighbor searches, and packs twice as many lanes per vector when
+    // the vector units are wide enough to use them.
+    static constexpr std::size_t kSinglePrecisionMinNodes = std::size_t(1) << 20;
+
+    // Picks the variant for a problem of the given dimensions and
+    // expected graph size (0 when unknown, e.g. when running for a
+    // fixed time) on the given number of threads, from the variants
+    // compiled for the instruction set isa.
+    inline PlannerVariant selectPlannerVariant(
+        unsigned dimensions, std::size_t expectedNodes, unsigned threads, InstructionSet isa)
+    {
+        PlannerVariant v;
+        v.nn = dimensions <= kKDTreeMaxDimensions ? NNStrategy::kKDTreeBatch : NNStrategy::kGNAT;
+        v.singlePrecision = isa >= InstructionSet::kAVX2 && expectedNodes >= kSinglePrecisionMinNodes;
+        v.multiThreaded = threads > 1;
+        v.isa = isa;
+        return v;
+    }
+
+    // Fields of a variant set explicitly on the command line, which
+    // override the ones selected by selectPlannerVariant.
+    struct PlannerVariantOverrides {
+        bool nn{false};
+        bool scalar{false};
+        bool threads{false};
+        bool isa{false};
+        PlannerVariant variant;
+
+        void apply(PlannerVariant& v) const {
+            if (nn) v.nn = variant.nn;
+            if (scalar) v.singlePrecision = variant.singlePrecision;
+            if (threads) v.multiThreaded = variant.multiThreaded;
+            if (isa) v.isa = variant.isa;
+        }
+    };
+
+    // Parses a comma-separated list of variant fields, e.g.
+    // "GNAT,float" or "st,avx2".
+    inline PlannerVariantOverrides parsePlannerVariantOverrides(const std::string& spec) {
+        PlannerVariantOverrides o;
+        std::istringstream in(spec);
+        for (std::string field ; std::getline(in, field, ',') ; ) {
+            if (field == "KDTreeBatch" || field == "GNAT") {
+                o.nn = true;
+                o.variant.nn = field == "GNAT" ? NNStrategy::kGNAT : NNStrategy::kKDTreeBatch;
+            } else if (field == "float" || field == "double") {
+                o.scalar = true;
+                o.variant.singlePrecision = field == "float";
+            } else if (field == "st" || field == "mt") {
+                o.threads = true;
+                o.variant.multiThreaded = field == "mt";
+            } else if (field == "generic" || field == "avx2" || field == "avx512") {
+                o.isa = true;
+                o.variant.isa = field == "avx512" ? InstructionSet::kAVX512
+                    : field == "avx2" ? InstructionSet::kAVX2 : InstructionSet::kGeneric;
+            } else {
+                throw std::invalid_argument("invalid variant field: " + field);
+            }
+        }
+        return o;
+    }
+}
+
+#endif
@@ -39,14 +39,102 @@
 #include <mpt/lp_space.hpp>
 #include <mpt/box_bounds.hpp>
 #include <mpt/goal_state.hpp>
+#include "occupancy_bitmap.hpp"
 #include <png.h>
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
 constexpr bool PRINT_FILTERED_IMAGE = true; // enable this to export a filtered png file.
 
 namespace mpt_demo
 {
+    namespace impl
+    {
+        // Computes, for each pixel, a lower bound on the distance from
+        // any point that rounds to it to any point that rounds to an
+        // obstacle pixel, i.e. the Euclidean distance between the
+        // pixel centers minus sqrt(2) (half a diagonal at each end),
+        // rounded down.  Distances are saturated at 65535, and images
+        // without obstacles get the saturated value everywhere.
+        //
+        // This is the separable exact EDT of Felzenszwalb and
+        // Huttenlocher: first the distance to the nearest obstacle in
+        // the same column, then per row the lower envelope of the
+        // parabolas rooted at those distances.  It runs in time linear
+        // in the number of pixels, and the only full-size buffer is
+        // the result.
+        inline std::vector<std::uint16_t> obstacleClearance(const OccupancyBitmap& obstacles)
+        {
+            const int width = obstacles.width();
+            const int height = obstacles.height();
+            static constexpr std::uint16_t kFar = std::numeric_limits<std::uint16_t>::max();
+            std::vector<std::uint16_t> g(std::size_t(width) * height);
+
+            // vertical distance, in pixels, to the nearest obstacle
+            // in the column
+            for (int y = 0 ; y < height ; ++y)
+            {
+                std::uint16_t *row = &g[std::size_t(y) * width];
+                const std::uint16_t *prev = y ? row - width : nullptr;
+                for (int x = 0 ; x < width ; ++x)
+                    row[x] = obstacles.occupied(x, y) ? 0
+                        : (prev && prev[x] < kFar) ? prev[x] + 1 : kFar;
+            }
+            for (int y = height - 1 ; y-- > 0 ; )
+            {
+                std::uint16_t *row = &g[std::size_t(y) * width];
+                const std::uint16_t *next = row + width;
+                for (int x = 0 ; x < width ; ++x)
+                    if (next[x] < kFar && next[x] + 1 < row[x])
+                        row[x] = next[x] + 1;
+            }
+
+            // per row, squared distance to the nearest obstacle
+            // anywhere, from the lower envelope of the parabolas
+            // (x - q)^2 + f(q).
+            const double inf = std::numeric_limits<double>::infinity();
+            std::vector<double> f(width), z(width + 1);
+            std::vector<int> v(width);
+            for (int y = 0 ; y < height ; ++y)
+            {
+                std::uint16_t *row = &g[std::size_t(y) * width];
+                int k = -1;
+                for (int q = 0 ; q < width ; ++q)
+                {
+                    if (row[q] == kFar)
+                        continue; // no parabola
+                    f[q] = double(row[q]) * row[q];
+                    double s = -inf;
+                    while (k >= 0 && (s = ((f[q] + double(q)*q) - (f[v[k]] + double(v[k])*v[k])) / (2.0*(q - v[k]))) <= z[k])
+                        --k;
+                    v[++k] = q;
+                    z[k] = k ? s : -inf;
+                    z[k+1] = inf;
+                }
+
+                for (int x = 0, j = 0 ; x < width ; ++x)
+                {
+                    if (k < 0)
+                    {
+                        row[x] = kFar;
+                        continue;
+                    }
+                    while (z[j+1] < x)
+                        ++j;
+                    double d = std::sqrt(double(x - v[j])*(x - v[j]) + f[v[j]]) - std::sqrt(2.0);
+                    row[x] = d <= 0 ? 0 : d >= kFar ? kFar : std::uint16_t(d);
+                }
+            }
+
+            return g;
+        }
+    }
+
     struct FilterColor
     {
         FilterColor(int r, int g, int b, int tol)
@@ -84,7 +172,13 @@ namespace mpt_demo
         Space space_;
         Bounds bounds_;
         Goal goal_;
-        std::vector<bool> isObstacle_;
+
+        // The obstacles, shared between the copies of the scenario.
+        std::shared_ptr<const OccupancyBitmap> obstacles_;
+
+        // See impl::obstacleClearance.  It is as large as the image,
+        // thus shared between the copies of the scenario.
+        std::shared_ptr<const std::vector<std::uint16_t>> clearance_;
 
     public:
         PNG2dScenario(
@@ -97,7 +191,9 @@ namespace mpt_demo
               height_(height),
               bounds_(makeBounds()),
               goal_(1e-6, goalState),
-              isObstacle_(isObstacle)
+              obstacles_(std::make_shared<const OccupancyBitmap>(width, height, isObstacle)),
+              clearance_(std::make_shared<const std::vector<std::uint16_t>>(
+                             impl::obstacleClearance(*obstacles_)))
         {
         }
 
@@ -106,14 +202,30 @@ namespace mpt_demo
             int x = (int) (q[0] + 0.5);
             int y = (int) (q[1] + 0.5);
 
-            return !isObstacle_[width_ * y + x];
+            return !obstacles_->occupied(x, y);
         }
 
         bool link(const State &a, const State &b) const
         {
             if(!valid(a) || !valid(b))
                 return false;
-            return validSegment(a, b);
+            // a segment shorter than the clearance at either end
+            // cannot reach an obstacle.  Otherwise fall back to the
+            // exact test.
+            Scalar length = (b - a).norm();
+            if (length < std::max(clearance(a), clearance(b)))
+                return true;
+            return obstacles_->segmentFree(a[0], a[1], b[0], b[1]);
+        }
+
+        // A lower bound on the distance from q to any obstacle, see
+        // impl::obstacleClearance.
+        Scalar clearance(const State &q) const
+        {
+            int x = (int) (q[0] + 0.5);
+            int y = (int) (q[1] + 0.5);
+
+            return (*clearance_)[std::size_t(width_) * y + x];
         }
 
         const Space &space() const
@@ -148,21 +260,6 @@ namespace mpt_demo
             max << width_, height_;
             return Bounds(min, max);
         }
-
-        bool validSegment(const State &a, const State &b) const
-        {
-            // uses the bisection method to verify links.
-            State mid = (a + b) / 2;
-            Scalar distSquared = (b - a).squaredNorm();
-            Scalar tolerance = 1;
-            if (distSquared < tolerance * tolerance)
-                return true;
-            if (!valid(mid))
-                return false;
-            if (!validSegment(a, mid)) // check the left half
-                return false;
-            return validSegment(mid, b); // check the right half
-        }
     };
 
 
@@ -0,0 +1,70 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_DEMO_PRRTS_C_HPP
+#define MPT_DEMO_PRRTS_C_HPP
+
+// Declarations of the entry points of the original C implementation
+// of PRRT* (https://github.com/jeffi/prrts-c), from which the NAO cup
+// problem in nao_cup/ was taken.  These match the declarations
+// commented out in nao_cup/src/prrts.hpp.  The implementation is not
+// part of this repository; to use these, build prrts-c and link
+// against its library (see PRRTS_C_LIBRARY in CMakeLists.txt).
+
+#include "nao_cup/src/prrts.hpp"
+#include <cstddef>
+
+extern "C" {
+    struct prrts_options {
+        double gamma;
+        bool regional_sampling;
+        int samples_per_step;
+    };
+
+    // The solution is followed by path_length configurations, which
+    // are not needed for benchmarking.  It is allocated with malloc.
+    struct prrts_solution {
+        double path_cost;
+        std::size_t path_length;
+    };
+
+    prrts_solution* prrts_run_for_samples(
+        nao_cup::prrts_system<double> *system, prrts_options *options,
+        int thread_count, std::size_t sample_count);
+}
+
+#endif
@@ -0,0 +1,395 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+// Strong-scaling benchmark.  Runs the parallel planners on fixed
+// scenarios and seeds with 1, 2, 4, ... threads, and reports the
+// speedup and parallel efficiency of the iteration rate and of the
+// time to first solution.  Using the planners' worker statistics,
+// it also breaks each iteration down into its timed phases (nearest
+// neighbor searches, motion validation, and the untimed remainder),
+// and flags the phase whose share of the run time grows the most with
+// the thread count.  That phase is the one limiting scaling on the
+// machine running the benchmark.  Example:
+//
+//    scaling_benchmark -c nao_cup -m 16 -n 5 -t 2000
+//
+// The thread count is set with omp_set_num_threads(), thus this
+// requires the OpenMP worker pool (the default when built with
+// OpenMP).
+
+#ifndef MPT_LOG_LEVEL
+#define MPT_LOG_LEVEL INFO
+#endif
+
+#include "benchmark.hpp"
+#include "benchmark_scenarios.hpp"
+#include <mpt/pprm.hpp>
+#include <mpt/prrt.hpp>
+#include <mpt/prrt_star.hpp>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <thread>
+
+namespace mpt_demo {
+    using namespace unc::robotics::mpt;
+
+    struct ScalingBenchmarkOptions : BenchmarkOptions, BenchmarkScenarioOptions {
+        std::vector<std::string> planners;
+        unsigned maxThreads{std::max(1u, std::thread::hardware_concurrency())};
+        std::string output;
+
+        bool plannerSelected(const std::string& name) const {
+            return benchmarkSelected(planners, name);
+        }
+    };
+
+    // Totals over all seeds run with a given thread count.
+    struct ScalingSample {
+        unsigned threads{0};
+        unsigned runs{0};
+        std::size_t iterations{0};
+
+        // sum of the wall-clock solve times
+        double solveTime{0};
+
+        // first solution times of the solved runs
+        std::vector<double> solutionTimes;
+
+        // total time in each phase, summed over the workers.  The
+        // insertion order is the order reported by visitTimers().
+        std::vector<std::pair<std::string, double>> phases;
+
+        // total worker time: threads * solveTime
+        double workerTime() const {
+            return threads * solveTime;
+        }
+
+        double iterationsPerSecond() const {
+            return iterations / solveTime;
+        }
+
+        double medianSolutionTime() const {
+            if (solutionTimes.empty())
+                return std::numeric_limits<double>::quiet_NaN();
+            std::vector<double> t(solutionTimes);
+            std::nth_element(t.begin(), t.begin() + t.size()/2, t.end());
+            return t[t.size()/2];
+        }
+
+        void addPhase(const std::string& name, double seconds) {
+            for (auto& p : phases) {
+                if (p.first == name) {
+                    p.second += seconds;
+                    return;
+                }
+            }
+            phases.emplace_back(name, seconds);
+        }
+
+        // the fraction of the worker time not in a timed phase
+        double otherShare() const {
+            double timed = 0;
+            for (auto& p : phases)
+                timed += p.second;
+            return std::max(0.0, 1.0 - timed / workerTime());
+        }
+    };
+
+    template <typename Planner>
+    void collectStats(ScalingSample& sample, const Planner& planner, const BenchmarkResult& result) {
+        auto stats = planner.stats();
+        sample.iterations += stats.iterations();
+        sample.solveTime += result.solveTime;
+        ++sample.runs;
+        if (result.solved)
+            sample.solutionTimes.push_back(result.firstSolutionTime);
+        stats.visitTimers([&] (const char *name, const auto& timer) {
+            sample.addPhase(name, std::chrono::duration<double>(timer.elapsed()).count());
+        });
+    }
+
+    // Prints the scaling report for one planner on one scenario, and
+    // returns the name of the phase whose share of the worker time
+    // grows the most from the first to the last thread count.
+    std::string report(
+        std::ostream& out,
+        const std::string& plannerName, const std::string& scenarioName,
+        const std::vector<ScalingSample>& samples)
+    {
+        const ScalingSample& base = samples.front();
+        const ScalingSample& last = samples.back();
+        double baseRate = base.iterationsPerSecond();
+        double baseSolve = base.medianSolutionTime();
+
+        out << "\n" << plannerName << " on " << scenarioName << "\n"
+            << std::setw(8) << "threads"
+            << std::setw(14) << "iters/s"
+            << std::setw(10) << "speedup"
+            << std::setw(12) << "efficiency"
+            << std::setw(12) << "solved"
+            << std::setw(14) << "median t(s)"
+            << std::setw(10) << "speedup"
+            << std::setw(12) << "efficiency" << "\n";
+
+        std::ios::fmtflags flags = out.flags();
+        out << std::fixed;
+        for (const ScalingSample& s : samples) {
+            double speedup = s.iterationsPerSecond() / baseRate;
+            double solve = s.medianSolutionTime();
+            double solveSpeedup = baseSolve / solve;
+            out << std::setw(8) << s.threads
+                << std::setw(14) << std::setprecision(0) << s.iterationsPerSecond()
+                << std::setw(10) << std::setprecision(2) << speedup
+                << std::setw(12) << speedup / s.threads
+                << std::setw(12) << (std::to_string(s.solutionTimes.size()) + "/" + std::to_string(s.runs))
+                << std::setw(14) << std::setprecision(4) << solve
+                << std::setw(10) << std::setprecision(2) << solveSpeedup
+                << std::setw(12) << solveSpeedup / s.threads << "\n";
+        }
+
+        // Per phase: the share of total worker time, and the time per
+        // iteration.  The phase efficiency is the ratio of the time
+        // per iteration with one thread to that with N threads, thus
+        // 1.0 means the phase did not slow down with contention.
+        out << std::setw(16) << "phase";
+        for (const ScalingSample& s : samples)
+            out << std::setw(9) << ("share@" + std::to_string(s.threads));
+        out << std::setw(14) << "ns/iter@" + std::to_string(base.threads)
+            << std::setw(14) << "ns/iter@" + std::to_string(last.threads)
+            << std::setw(12) << "efficiency" << "\n";
+
+        std::string limiting;
+        double maxGrowth = 0;
+        auto phaseRow = [&] (const std::string& name, auto share, auto perIteration) {
+            out << std::setw(16) << name;
+            for (const ScalingSample& s : samples)
+                out << std::setw(9) << std::setprecision(3) << share(s);
+            double t0 = perIteration(base) * 1e9;
+            double t1 = perIteration(last) * 1e9;
+            out << std::setw(14) << std::setprecision(1) << t0
+                << std::setw(14) << t1
+                << std::setw(12) << std::setprecision(2) << t0 / t1;
+            out << "\n";
+            double growth = share(last) - share(base);
+            if (growth > maxGrowth) {
+                maxGrowth = growth;
+                limiting = name;
+            }
+        };
+
+        for (std::size_t i = 0 ; i < base.phases.size() ; ++i) {
+            phaseRow(
+                base.phases[i].first,
+                [&] (const ScalingSample& s) { return s.phases[i].second / s.workerTime(); },
+                [&] (const ScalingSample& s) { return s.phases[i].second / s.iterations; });
+        }
+        phaseRow(
+            "other",
+            [&] (const ScalingSample& s) { return s.otherShare(); },
+            [&] (const ScalingSample& s) { return s.otherShare() * s.workerTime() / s.iterations; });
+
+        if (!limiting.empty() && samples.size() > 1)
+            out << "share of '" << limiting << "' grows the most with threads (+"
+                << std::setprecision(3) << maxGrowth << "), it limits scaling\n";
+
+        out.flags(flags);
+        return limiting;
+    }
+
+    void writeJson(
+        std::ostream& out, const std::string& label,
+        const std::string& plannerName, const std::string& scenarioName,
+        const std::vector<ScalingSample>& samples, const std::string& limiting)
+    {
+        auto num = [&] (double v) -> std::ostream& {
+            return std::isfinite(v) ? (out << v) : (out << "null");
+        };
+
+        out << "{\"label\":\"" << jsonEscape(label)
+            << "\",\"planner\":\"" << jsonEscape(plannerName)
+            << "\",\"scenario\":\"" << jsonEscape(scenarioName)
+            << "\",\"limiting_phase\":\"" << jsonEscape(limiting)
+            << "\",\"threads\":[";
+        for (std::size_t i = 0 ; i < samples.size() ; ++i) {
+            const ScalingSample& s = samples[i];
+            out << (i ? ",{" : "{") << "\"threads\":" << s.threads
+                << ",\"runs\":" << s.runs
+                << ",\"solved\":" << s.solutionTimes.size()
+                << ",\"iterations_per_second\":";
+            num(s.iterationsPerSecond()) << ",\"median_solution_time\":";
+            num(s.medianSolutionTime()) << ",\"phases\":{";
+            for (const auto& [name, seconds] : s.phases) {
+                out << '"' << name << "\":";
+                num(seconds / s.workerTime()) << ',';
+            }
+            out << "\"other\":";
+            num(s.otherShare()) << "}}";
+        }
+        out << "]}\n";
+    }
+
+    template <typename Fn>
+    void forEachScalingPlanner(const ScalingBenchmarkOptions& options, Fn&& fn) {
+        if (options.plannerSelected("prrt"))
+            fn(PlannerType<PRRT<report_stats<true>>>{}, "prrt");
+        if (options.plannerSelected("prrt_star"))
+            fn(PlannerType<PRRTStar<report_stats<true>>>{}, "prrt_star");
+        if (options.plannerSelected("pprm"))
+            fn(PlannerType<PPRM<report_stats<true>>>{}, "pprm");
+    }
+
+    ScalingBenchmarkOptions parseOptions(int argc, char *argv[]) {
+        static struct option longOptions[] = {
+            { "solve-time", required_argument, 0, 't' },
+            { "max-threads", required_argument, 0, 'm' },
+            { "seeds", required_argument, 0, 'n' },
+            { "first-seed", required_argument, 0, 's' },
+            { "planner", required_argument, 0, 'a' },
+            { "scenario", required_argument, 0, 'c' },
+            { "se3", required_argument, 0, 'e' },
+            { "png", required_argument, 0, 'p' },
+            { "output", required_argument, 0, 'o' },
+            { "label", required_argument, 0, 'l' },
+            { nullptr, 0, nullptr, 0 }
+        };
+
+        ScalingBenchmarkOptions options;
+        options.seeds = 5;
+        options.timeLimit = std::chrono::milliseconds(2000);
+        for (int c, optInd ; -1 != (c=getopt_long(argc, argv, "t:m:n:s:a:c:e:p:o:l:", longOptions, &optInd)) ; ) {
+            switch (c) {
+            case 't':
+                options.timeLimit = std::chrono::milliseconds(parseNonNegative(optarg, "solve time"));
+                break;
+            case 'm':
+                options.maxThreads = std::max(1, parseNonNegative(optarg, "thread count"));
+                break;
+            case 'n':
+                options.seeds = std::max(1, parseNonNegative(optarg, "seed count"));
+                break;
+            case 's':
+                options.firstSeed = parseNonNegative(optarg, "seed");
+                break;
+            case 'a':
+                options.planners.push_back(optarg);
+                break;
+            case 'c':
+                options.scenarios.push_back(optarg);
+                break;
+            case 'e':
+                options.se3Configs.push_back(optarg);
+                break;
+            case 'p':
+                options.pngFile = optarg;
+                break;
+            case 'o':
+                options.output = optarg;
+                break;
+            case 'l':
+                options.label = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [options]\n"
+                    "Options:\n"
+                    "  -t --solve-time=T    Run each benchmark for T milliseconds (default 2000)\n"
+                    "  -m --max-threads=N   Run with 1, 2, 4, ... up to N threads (default hardware concurrency)\n"
+                    "  -n --seeds=N         Number of seeds per thread count (default 5)\n"
+                    "  -s --first-seed=S    First seed (default 1)\n"
+                    "  -a --planner=P       Run planner P (prrt, prrt_star, pprm), may be repeated\n"
+                    "  -c --scenario=S      Run scenario S (holonomic_2d, png_2d, link_manipulator,\n"
+                    "                       nao_cup, se3), may be repeated\n"
+                    "  -e --se3=FILE        Add an OMPL.app SE(3) configuration file\n"
+                    "  -p --png=FILE        Input image for png_2d (default png_planning_input.png)\n"
+                    "  -o --output=FILE     Also append the results as JSON to FILE\n"
+                    "  -l --label=L         Label the results, e.g., with the machine type\n"
+                          << std::flush;
+                throw std::invalid_argument("unrecognized option");
+            }
+        }
+
+        options.threads.clear();
+        for (unsigned n = 1 ; n <= options.maxThreads ; n *= 2)
+            options.threads.push_back(n);
+        if (options.threads.back() != options.maxThreads)
+            options.threads.push_back(options.maxThreads);
+
+        return options;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    using namespace mpt_demo;
+
+    try {
+        ScalingBenchmarkOptions options = parseOptions(argc, argv);
+        std::ofstream json;
+        if (!options.output.empty()) {
+            json.open(options.output, std::ios::app);
+            if (!json)
+                throw std::runtime_error("failed to open " + options.output);
+        }
+
+        forEachScenario(options, [&] (const std::string& scenarioName, const auto& scenario, const auto& start) {
+            forEachScalingPlanner(options, [&] (auto type, const std::string& plannerName) {
+                using Algorithm = typename decltype(type)::type;
+                std::vector<ScalingSample> samples;
+                for (unsigned threads : options.threads) {
+                    ScalingSample& sample = samples.emplace_back();
+                    sample.threads = threads;
+                    for (unsigned i = 0 ; i < options.seeds ; ++i) {
+                        runBenchmark<Algorithm>(
+                            plannerName, scenarioName, scenario, start,
+                            threads, options.firstSeed + i, options,
+                            [&] (const auto& planner, const BenchmarkResult& result) {
+                                collectStats(sample, planner, result);
+                            });
+                    }
+                }
+
+                std::string limiting = report(std::cout, plannerName, scenarioName, samples);
+                if (json.is_open())
+                    writeJson(json, options.label, plannerName, scenarioName, samples, limiting);
+            });
+        });
+
+        return 0;
+    } catch (const std::exception& ex) {
+        MPT_LOG(FATAL) << "terminated with exception: " << ex.what();
+        return 1;
+    }
+}
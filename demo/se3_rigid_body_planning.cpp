@@ -170,6 +170,12 @@ void runPlanner(
     using Clock = std::chrono::steady_clock;
 
     Scenario scenario(envMesh, robotMeshes, qGoal, volumeMin, volumeMax, 0.01);
+    if (config.hasProp("problem", "motion_check")) {
+        std::string check;
+        config.load(check, "problem", "motion_check");
+        MPT_LOG(INFO) << "motion check: " << check;
+        scenario.setMotionCheck(mpt_demo::impl::parseMotionCheck(check));
+    }
 
     Planner<Scenario, Algorithm> planner(scenario);
     // planner.addGoal(qGoal);
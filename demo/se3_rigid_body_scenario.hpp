@@ -35,20 +35,32 @@
 
 #pragma once
 
+#include "distance_field.hpp"
+#include "mesh_cache.hpp"
 #include <Eigen/Dense>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <chrono>
+#include <cstdint>
+#include <array>
+#include <fcl/broadphase/broadphase_dynamic_AABB_tree.h>
 #include <fcl/geometry/bvh/BVH_model.h>
 #include <fcl/narrowphase/collision.h>
+#include <fcl/narrowphase/continuous_collision.h>
 #include <functional>
 #include <memory>
 #include <mpt/discrete_motion_validator.hpp>
 #include <mpt/goal_state.hpp>
 #include <mpt/log.hpp>
+#include <mpt/scenario_data.hpp>
 #include <mpt/se3_space.hpp>
 #include <mpt/uniform_sampler.hpp>
 #include <nigh/kdtree_batch.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace mpt_demo::impl {
     static constexpr std::intmax_t SO3_WEIGHT = 50;
@@ -164,13 +176,29 @@ namespace mpt_demo::impl {
         Mesh(const std::string& name, bool shiftToCenter)
             : name_(name)
         {
-            Assimp::Importer importer;
             // these options are the same as from OMPL app to strive
             // for parity
             static constexpr auto readOpts =
                 aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
                 aiProcess_SortByPType | aiProcess_OptimizeGraph | aiProcess_OptimizeMeshes;
 
+            MeshCache<Scalar> cache(name, (std::uint64_t(readOpts) << 1) | shiftToCenter);
+            std::size_t nVertices;
+            Vec3 center;
+            model_.beginModel();
+            if (cache.load([&] (const auto& a, const auto& b, const auto& c) {
+                        model_.addTriangle(a, b, c);
+                    }, nVertices, center))
+            {
+                model_.endModel();
+                model_.computeLocalAABB();
+                MPT_LOG(INFO) << "Loaded mesh '" << name << "' from " << cache.path() << " ("
+                              << nVertices << " vertices, " << model_.num_tris
+                              << " triangles, center=" << center << ")";
+                return;
+            }
+
+            Assimp::Importer importer;
             const aiScene *scene = importer.ReadFile(name, readOpts);
             if (scene == nullptr)
                 throw std::invalid_argument("could not load mesh file '" + name + "'");
@@ -178,8 +206,8 @@ namespace mpt_demo::impl {
             if (!scene->HasMeshes())
                 throw std::invalid_argument("mesh file '" + name + "' does not contain meshes");
 
-            Vec3 center = Vec3::Zero();
-            std::size_t nVertices = visitVertices(
+            center = Vec3::Zero();
+            nVertices = visitVertices(
                 scene,
                 scene->mRootNode,
                 Transform::Identity(),
@@ -192,16 +220,20 @@ namespace mpt_demo::impl {
             if (shiftToCenter)
                 rootTransform *= Eigen::Translation<Scalar, 3>(-center);
 
-            model_.beginModel();
+            std::vector<Scalar> triangles;
             std::size_t nTris = visitTriangles(
                 scene,
                 scene->mRootNode,
                 rootTransform,
                 [&] (const Vec3& a, const Vec3& b, const Vec3& c) {
                     model_.addTriangle(a, b, c);
+                    if (cache.enabled())
+                        triangles.insert(triangles.end(), {
+                                a[0], a[1], a[2], b[0], b[1], b[2], c[0], c[1], c[2] });
                 });
             model_.endModel();
             model_.computeLocalAABB();
+            cache.store(triangles, nVertices, center);
 
             MPT_LOG(INFO) << "Loaded mesh '" << name << "' (" << nVertices << " vertices, " << nTris
                           << " triangles, center=" << center << ")";
@@ -220,6 +252,34 @@ namespace mpt_demo::impl {
         }
 
         const fcl::CollisionGeometry<Scalar>* geom() const { return &model_; }
+
+        // distance from the origin to the farthest vertex
+        Scalar radius() const {
+            Scalar r = 0;
+            for (int i=0 ; i<model_.num_vertices ; ++i)
+                r = std::max(r, model_.vertices[i].norm());
+            return r;
+        }
+
+        // FCL's collision objects hold their geometry through a
+        // shared_ptr to non-const.  owner must own this mesh.  Note:
+        // constructing a CollisionObject recomputes the geometry's
+        // local AABB (to the same values), thus it must not happen
+        // concurrently with collision checks using this mesh.
+        template <typename Owner>
+        std::shared_ptr<fcl::CollisionGeometry<Scalar>> geometry(const std::shared_ptr<Owner>& owner) const {
+            return std::shared_ptr<fcl::CollisionGeometry<Scalar>>(
+                owner, const_cast<fcl::BVHModel<fcl::OBBRSS<Scalar>>*>(&model_));
+        }
+
+        TriangleMesh<Scalar> triangleMesh() const {
+            TriangleMesh<Scalar> mesh;
+            for (int i=0 ; i<model_.num_tris ; ++i) {
+                const fcl::Triangle& t = model_.tri_indices[i];
+                mesh.addTriangle(model_.vertices[t[0]], model_.vertices[t[1]], model_.vertices[t[2]]);
+            }
+            return mesh;
+        }
     };
 
     template <auto>
@@ -235,6 +295,96 @@ namespace mpt_demo::impl {
         template <typename ... Args>
         decltype(auto) operator() (Args&& ... args) const { return (obj_.*fn)(std::forward<Args>(args)...); }
     };
+
+    // The configuration space of nParts rigid bodies moving
+    // independently.  A single body uses SE3Space directly, multiple
+    // bodies use the Cartesian product of their SE3Spaces, with each
+    // body sharing the same translation bounds.
+    template <typename Scalar, typename Indices>
+    struct SE3BodiesImpl;
+
+    template <typename Scalar, int nParts>
+    struct SE3Bodies : SE3BodiesImpl<Scalar, std::make_index_sequence<nParts>> {};
+
+    template <typename Scalar>
+    struct SE3Bodies<Scalar, 1> {
+        using Space = unc::robotics::mpt::SE3Space<Scalar, SO3_WEIGHT>;
+        using Bounds = std::tuple<unc::robotics::mpt::Unbounded, unc::robotics::mpt::BoxBounds<Scalar, 3>>;
+        using Body = typename Space::Type;
+
+        static const Body& body(const Body& q, std::size_t) { return q; }
+        static const Bounds& bounds(const Bounds& b) { return b; }
+    };
+
+    template <typename> struct space_metric;
+    template <typename T, typename M>
+    struct space_metric<unc::robotics::mpt::Space<T, M>> { using type = M; };
+
+    template <typename Scalar, std::size_t ... I>
+    struct SE3BodiesImpl<Scalar, std::index_sequence<I...>> {
+    private:
+        using Single = SE3Bodies<Scalar, 1>;
+        template <std::size_t> using BodyType = typename Single::Body;
+        template <std::size_t> using BodyMetric = typename space_metric<typename Single::Space>::type;
+        template <std::size_t> using BodyBounds = typename Single::Bounds;
+        template <std::size_t> static const auto& same(const typename Single::Bounds& b) { return b; }
+
+    public:
+        using Body = typename Single::Body;
+        using Space = unc::robotics::mpt::Space<std::tuple<BodyType<I>...>, unc::robotics::mpt::Cartesian<BodyMetric<I>...>>;
+        using Bounds = std::tuple<BodyBounds<I>...>;
+
+        static const Body& body(const typename Space::Type& q, std::size_t i) {
+            return *std::array<const Body*, sizeof...(I)>{{ &std::get<I>(q)... }}[i];
+        }
+
+        static Bounds bounds(const typename Single::Bounds& b) {
+            return Bounds(same<I>(b)...);
+        }
+    };
+
+    // How SE3RigidBodyScenario::link checks motions.  kDiscrete checks
+    // states along the motion at the scenario's check resolution, and
+    // may miss obstacles thinner than the step.  kContinuous uses FCL's
+    // conservative advancement over the interpolated motion, which
+    // misses nothing and takes fewer steps on motions far from
+    // obstacles.
+    enum class MotionCheck {
+        kDiscrete,
+        kContinuous,
+    };
+
+    inline MotionCheck parseMotionCheck(const std::string& name) {
+        if (name == "discrete")
+            return MotionCheck::kDiscrete;
+        if (name == "continuous")
+            return MotionCheck::kContinuous;
+        throw std::invalid_argument("invalid motion check: " + name);
+    }
+
+    // A broadphase over the (static) environment, built once and
+    // shared by the copies of the scenario.
+    template <typename Scalar>
+    class EnvironmentBroadphase {
+        fcl::CollisionObject<Scalar> object_;
+        fcl::DynamicAABBTreeCollisionManager<Scalar> manager_;
+
+    public:
+        explicit EnvironmentBroadphase(std::shared_ptr<fcl::CollisionGeometry<Scalar>> geom)
+            : object_(std::move(geom))
+        {
+            manager_.registerObject(&object_);
+            manager_.setup();
+        }
+
+        EnvironmentBroadphase(const EnvironmentBroadphase&) = delete;
+        EnvironmentBroadphase& operator = (const EnvironmentBroadphase&) = delete;
+
+        template <typename Data>
+        void collide(fcl::CollisionObject<Scalar>* obj, Data *data, fcl::CollisionCallBack<Scalar> callback) const {
+            manager_.collide(obj, data, callback);
+        }
+    };
 }
 
 namespace mpt_demo {
@@ -242,18 +392,22 @@ namespace mpt_demo {
 
     template <typename Scalar, int nParts = 1, bool selfCollision = false>
     class SE3RigidBodyScenario {
+        static_assert(nParts >= 1, "must have at least one body");
 
-        static_assert(nParts == 1, "only single body motions are supported currently (TODO: add multibody)");
+        using Bodies = impl::SE3Bodies<Scalar, nParts>;
 
     public:
 
-        using Space = mpt::SE3Space<Scalar, impl::SO3_WEIGHT>; // weight SO(3) by 50
-        using Bounds = std::tuple<mpt::Unbounded, mpt::BoxBounds<Scalar, 3>>;
+        using Space = typename Bodies::Space; // weight SO(3) by 50
+        using Bounds = typename Bodies::Bounds;
         using State = typename Space::Type;
         using Distance = typename Space::Distance;
         using Goal = mpt::GoalState<Space>;
         using TravelTime = Scalar;
 
+        // pairs of body indices
+        using BodyPairs = std::vector<std::pair<std::size_t, std::size_t>>;
+
         // TODO: remove explicit Nearest and use default
         using Nearest = unc::robotics::nigh::KDTreeBatch<8>;
 
@@ -266,57 +420,347 @@ namespace mpt_demo {
         // so it seems unlikely to change, but regardless, we use
         // fcl's alias for it instead of directly using Eigen's type.
         using Transform = fcl::Transform3<Scalar>;
+        using Object = fcl::CollisionObject<Scalar>;
 
-        // The meshes are immutable and can be rather large.  Since
-        // scenarios are copied to each thread, we use a shared
-        // pointer to avoid copying the environment and robot meshes.
-        std::shared_ptr<impl::Mesh<Scalar>> environment_;
-        std::shared_ptr<std::vector<impl::Mesh<Scalar>>> robot_;
+        static constexpr bool checkSelfCollision = selfCollision && nParts > 1;
 
-        Space space_;
-        Bounds bounds_;
+        // The immutable data of the scenario, shared by all of its
+        // copies (see mpt::ScenarioData).  The meshes and precomputed
+        // data are in turn held by shared pointers, so that the
+        // setters below can cheaply make a modified copy.
+        struct Shared {
+            std::shared_ptr<impl::Mesh<Scalar>> environment;
+            std::shared_ptr<std::vector<impl::Mesh<Scalar>>> robot;
+            std::shared_ptr<const impl::EnvironmentBroadphase<Scalar>> envBroadphase;
 
-        static constexpr Distance goalRadius = 1e-6;
-        Goal goal_;
+            // Distance field of the environment and bounding spheres
+            // of each robot mesh, to skip FCL for states that are
+            // clearly free or clearly in collision (see
+            // distance_field.hpp).  null when disabled.
+            std::shared_ptr<const impl::DistanceField<Scalar>> field;
+            std::shared_ptr<const std::vector<impl::RobotProbes<Scalar>>> probes;
+
+            // distance from each robot mesh's origin to its farthest
+            // vertex, bounding how far a rotation moves it.
+            std::shared_ptr<const std::vector<Scalar>> radii;
 
-        static Transform stateToTransform(const Config& q) {
+            // nParts x nParts matrix of the pairs of bodies allowed
+            // to collide with each other.
+            std::vector<bool> allowed;
+
+            impl::MotionCheck motionCheck{impl::MotionCheck::kDiscrete};
+
+            Space space;
+            Distance stepSize;
+
+            void allowCollision(std::size_t i, std::size_t j) {
+                allowed[i*nParts + j] = allowed[j*nParts + i] = true;
+            }
+        };
+
+        struct CollisionData {
+            const std::vector<bool>* allowed;
+            fcl::CollisionRequest<Scalar> req;
+            fcl::CollisionResult<Scalar> res;
+            bool collision{false};
+        };
+
+        static bool environmentCallback(Object* a, Object* b, void* data) {
+            CollisionData& d = *static_cast<CollisionData*>(data);
+            return d.collision = fcl::collide(a, b, d.req, d.res) > 0;
+        }
+
+        static bool selfCallback(Object* a, Object* b, void* data) {
+            CollisionData& d = *static_cast<CollisionData*>(data);
+            std::size_t i = reinterpret_cast<std::uintptr_t>(a->getUserData());
+            std::size_t j = reinterpret_cast<std::uintptr_t>(b->getUserData());
+            if ((*d.allowed)[i*nParts + j])
+                return false;
+            return d.collision = fcl::collide(a, b, d.req, d.res) > 0;
+        }
+
+        static Transform stateToTransform(const typename Bodies::Body& q) {
             return Eigen::Translation<Scalar, 3>(std::get<1>(q))
                 * Eigen::Quaternion(std::get<0>(q));
         }
 
-    public:
-        bool valid(const Config& q) const {
-            fcl::CollisionRequest<Scalar> req;
-            fcl::CollisionResult<Scalar> res;
+        // the body that robot mesh i is attached to.  With a single
+        // body, all meshes are parts of it.
+        static std::size_t bodyOf(std::size_t i) {
+            return nParts == 1 ? 0 : i;
+        }
+
+        // The per-thread part of the scenario: a collision object per
+        // robot mesh and, with multiple bodies and self collision, a
+        // broadphase over them, whose transforms valid() updates, and
+        // the motion validator bound to them.
+        class Context {
+            const Shared& shared_;
+            std::vector<std::unique_ptr<Object>> objects_;
+            std::unique_ptr<fcl::DynamicAABBTreeCollisionManager<Scalar>> selfBroadphase_;
+
+        public:
+            explicit Context(const Shared& shared)
+                : shared_(shared)
+                , link_(shared.space, shared.stepSize, Validator(*this))
+            {
+                const auto& robot = shared_.robot;
+                objects_.reserve(robot->size());
+                for (std::size_t i=0 ; i<robot->size() ; ++i) {
+                    objects_.push_back(std::make_unique<Object>((*robot)[i].geometry(robot)));
+                    objects_.back()->setUserData(reinterpret_cast<void*>(std::uintptr_t(bodyOf(i))));
+                }
+
+                if constexpr (checkSelfCollision) {
+                    selfBroadphase_ = std::make_unique<fcl::DynamicAABBTreeCollisionManager<Scalar>>();
+                    for (auto& obj : objects_)
+                        selfBroadphase_->registerObject(obj.get());
+                    selfBroadphase_->setup();
+                }
+            }
+
+            Context(const Context&) = delete;
+            Context& operator = (const Context&) = delete;
+
+            bool valid(const Config& q) {
+                CollisionData data{&shared_.allowed};
+
+                for (std::size_t i=0 ; i<objects_.size() ; ++i) {
+                    Transform tf = stateToTransform(Bodies::body(q, bodyOf(i)));
+                    objects_[i]->setTransform(tf);
+                    objects_[i]->computeAABB();
+
+                    if (shared_.field) {
+                        impl::Prefilter p = shared_.field->classify((*shared_.probes)[i], tf);
+                        if (p == impl::Prefilter::kFree)
+                            continue;
+                        if (p == impl::Prefilter::kCollision)
+                            return false;
+                    }
+
+                    shared_.envBroadphase->collide(objects_[i].get(), &data, &environmentCallback);
+                    if (data.collision)
+                        return false;
+                }
+
+                if constexpr (checkSelfCollision) {
+                    selfBroadphase_->update();
+                    selfBroadphase_->collide(&data, &selfCallback);
+                    if (data.collision)
+                        return false;
+                }
+
+                return true;
+            }
 
-            for (const auto& robot : *robot_) {
-                // for (std::size_t i=0 ; i<robot_->size() ; ++i) {
-                Transform tf = stateToTransform(q); // TODO: get the ith state
-                if (fcl::collide(robot.geom(), tf, environment_->geom(), Transform::Identity(), req, res))
+            // The pairs of bodies (i < j) in collision with each other
+            // at q that are not allowed to collide.
+            BodyPairs bodiesInCollision(const Config& q) {
+                BodyPairs pairs;
+                for (std::size_t i=0 ; i<objects_.size() ; ++i)
+                    objects_[i]->setTransform(stateToTransform(Bodies::body(q, bodyOf(i))));
+                for (std::size_t i=0 ; i<objects_.size() ; ++i) {
+                    for (std::size_t j=i ; ++j<objects_.size() ; ) {
+                        if (shared_.allowed[i*nParts + j])
+                            continue;
+                        fcl::CollisionRequest<Scalar> req;
+                        fcl::CollisionResult<Scalar> res;
+                        if (fcl::collide(objects_[i].get(), objects_[j].get(), req, res) > 0)
+                            pairs.emplace_back(i, j);
+                    }
+                }
+                return pairs;
+            }
+
+            // Checks the motion from a (assumed valid) to b using
+            // conservative advancement.  FCL's linear motion
+            // interpolates the translation of the origin linearly and
+            // the rotation at a constant angular velocity, matching
+            // SE3Space's interpolation.  Robot meshes that cannot move
+            // farther than their clearance from the environment at a
+            // skip FCL.
+            bool continuousLink(const Config& a, const Config& b) {
+                if (!valid(b))
                     return false;
+
+                fcl::ContinuousCollisionRequest<Scalar> req;
+                req.ccd_motion_type = fcl::CCDM_LINEAR;
+                req.ccd_solver_type = fcl::CCDC_CONSERVATIVE_ADVANCEMENT;
+                fcl::ContinuousCollisionResult<Scalar> res;
+
+                const auto& robot = *shared_.robot;
+                for (std::size_t i=0 ; i<robot.size() ; ++i) {
+                    const auto& qa = Bodies::body(a, bodyOf(i));
+                    const auto& qb = Bodies::body(b, bodyOf(i));
+                    Transform tfA = stateToTransform(qa);
+                    Transform tfB = stateToTransform(qb);
+
+                    if (shared_.field) {
+                        Scalar sweep = (std::get<1>(qb) - std::get<1>(qa)).norm()
+                            + std::get<0>(qa).angularDistance(std::get<0>(qb)) * (*shared_.radii)[i];
+                        if (sweep < shared_.field->clearance((*shared_.probes)[i], tfA))
+                            continue;
+                    }
+
+                    fcl::continuousCollide(
+                        robot[i].geom(), tfA, tfB,
+                        shared_.environment->geom(), Transform::Identity(), Transform::Identity(),
+                        req, res);
+                    if (res.is_collide)
+                        return false;
+                }
+
+                if constexpr (checkSelfCollision) {
+                    // Every point of body i stays within its radius of
+                    // its origin, which moves along the segment between
+                    // its positions at a and b, thus the box around the
+                    // segment expanded by the radius bounds the volume
+                    // the body sweeps.  Only pairs whose swept boxes
+                    // overlap can collide and reach FCL.
+                    std::array<Eigen::AlignedBox<Scalar, 3>, nParts> swept;
+                    std::array<Transform, nParts> tfA, tfB;
+                    for (std::size_t i=0 ; i<robot.size() ; ++i) {
+                        const auto& qa = Bodies::body(a, i);
+                        const auto& qb = Bodies::body(b, i);
+                        tfA[i] = stateToTransform(qa);
+                        tfB[i] = stateToTransform(qb);
+                        Scalar r = (*shared_.radii)[i];
+                        swept[i] = Eigen::AlignedBox<Scalar, 3>(
+                            std::get<1>(qa).cwiseMin(std::get<1>(qb)).array() - r,
+                            std::get<1>(qa).cwiseMax(std::get<1>(qb)).array() + r);
+                    }
+
+                    for (std::size_t i=0 ; i<robot.size() ; ++i) {
+                        for (std::size_t j=i ; ++j<robot.size() ; ) {
+                            if (shared_.allowed[i*nParts + j] || !swept[i].intersects(swept[j]))
+                                continue;
+                            fcl::continuousCollide(
+                                robot[i].geom(), tfA[i], tfB[i],
+                                robot[j].geom(), tfA[j], tfB[j],
+                                req, res);
+                            if (res.is_collide)
+                                return false;
+                        }
+                    }
+                }
+
+                return true;
             }
 
-            // TODO: when multibody is supported
-            // if (selfCollision) {
-            //     for (std::size_t i=0 ; i<robot_.size() ; ++i) {
-            //         Transform tfi = stateToTransform(q);
-            //         for (std::size_t j=i ; ++j<robot_.size() ; ) {
-            //             Transform tfj = stateToTransform(q);
-            //             if (fcl::collide(robot_[i], tfi, robot_[j], tfj, req, res) > 0)
-            //                 return false;
-            //         }
-            //     }
-            // }
-
-            return true;
+        private:
+            using Validator = impl::member_function<&Context::valid>;
+
+        public:
+            // The context is never moved (see mpt::ScenarioData),
+            // thus the validator can be bound to it.
+            const mpt::DiscreteMotionValidator<Space, Validator> link_;
+        };
+
+        using Data = mpt::ScenarioData<Shared, Context>;
+
+        Data data_;
+        Bounds bounds_;
+
+        static constexpr Distance goalRadius = 1e-6;
+        Goal goal_;
+
+        static void buildPrefilter(Shared& shared, int cells) {
+            auto start = std::chrono::steady_clock::now();
+            auto probes = std::make_shared<std::vector<impl::RobotProbes<Scalar>>>();
+            Scalar maxRadius = 0;
+            for (const auto& robot : *shared.robot) {
+                probes->emplace_back(robot.triangleMesh());
+                maxRadius = std::max(maxRadius, probes->back().maxRadius());
+            }
+            bool fromCache;
+            auto field = impl::cachedDistanceField(
+                shared.environment->triangleMesh(), cells, maxRadius, fromCache);
+            shared.probes = std::move(probes);
+
+            const Eigen::Array3i& dims = field->dims();
+            MPT_LOG(INFO) << (fromCache ? "Loaded " : "Built ") << (field->isSigned() ? "signed" : "unsigned")
+                          << " distance field " << dims[0] << "x" << dims[1] << "x" << dims[2]
+                          << " (" << field->memoryUsage() / 1024 << " KiB) in "
+                          << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+                          << " s";
+            shared.field = std::move(field);
         }
 
-    private:
-        using Validator = impl::member_function<&SE3RigidBodyScenario::valid>;
+        template <typename Min, typename Max>
+        static std::shared_ptr<const Shared> makeShared(
+            const std::string& envMesh,
+            const std::vector<std::string>& robotMeshes,
+            const Config& goal,
+            const Eigen::MatrixBase<Min>& min,
+            const Eigen::MatrixBase<Max>& max,
+            Scalar checkResolution,
+            const BodyPairs& allowedCollisions,
+            int prefilterCells)
+        {
+            if (nParts > 1 && robotMeshes.size() != std::size_t(nParts))
+                throw std::invalid_argument("expected one robot mesh per body");
+            for (auto [i, j] : allowedCollisions)
+                if (i >= std::size_t(nParts) || j >= std::size_t(nParts) || i == j)
+                    throw std::invalid_argument("invalid pair of bodies allowed to collide");
+
+            auto shared = std::make_shared<Shared>();
+            shared->environment = std::make_shared<impl::Mesh<Scalar>>(envMesh, false);
+            shared->envBroadphase = std::make_shared<impl::EnvironmentBroadphase<Scalar>>(
+                shared->environment->geometry(shared->environment));
+            shared->allowed.assign(nParts*nParts, false);
+            // shared->stepSize = environment_->extents()*checkResolution;
+            shared->stepSize = nParts*((max - min).norm() + Scalar(impl::SO3_WEIGHT*M_PI/2))*checkResolution;
+
+            auto robot = std::make_shared<std::vector<impl::Mesh<Scalar>>>();
+            auto radii = std::make_shared<std::vector<Scalar>>();
+            robot->reserve(robotMeshes.size());
+            for (const std::string& mesh : robotMeshes) {
+                robot->emplace_back(mesh, true);
+                radii->push_back(robot->back().radius());
+            }
+            shared->robot = std::move(robot);
+            shared->radii = std::move(radii);
+
+            // prefilterCells is the resolution of the distance field
+            // along the environment's longest axis, 0 disables it.
+            if (prefilterCells > 0)
+                buildPrefilter(*shared, prefilterCells);
+
+            for (auto [i, j] : allowedCollisions)
+                shared->allowCollision(i, j);
+
+            Context context(*shared);
+            if (!context.valid(goal)) {
+                std::string what = "goal is in collision";
+                if constexpr (checkSelfCollision) {
+                    for (auto [i, j] : context.bodiesInCollision(goal))
+                        what += ", bodies " + std::to_string(i) + " and " + std::to_string(j) + " collide";
+                }
+                throw std::invalid_argument(what);
+            }
 
-    public:
-        const mpt::DiscreteMotionValidator<Space, Validator> link_;
+            MPT_LOG(DEBUG) << "Volume min: " << min.transpose();
+            MPT_LOG(DEBUG) << "Volume max: " << max.transpose();
 
+            return shared;
+        }
+
+        // Replaces the shared data with a modified copy, leaving
+        // existing copies of the scenario unaffected.
+        template <typename Fn>
+        void modifyShared(Fn fn) {
+            auto shared = std::make_shared<Shared>(data_.shared());
+            fn(*shared);
+            data_ = Data(std::move(shared));
+        }
+
+    public:
+        // With multiple bodies, robotMeshes has one mesh per body, and
+        // min and max bound the translation of every body.  With self
+        // collision, allowedCollisions lists the pairs of bodies that
+        // are not checked against each other (e.g., because they are
+        // always in contact).  Throws std::invalid_argument if the goal
+        // is in collision.
         template <typename Min, typename Max>
         SE3RigidBodyScenario(
             const std::string& envMesh,
@@ -324,24 +768,51 @@ namespace mpt_demo {
             const Config& goal,
             const Eigen::MatrixBase<Min>& min,
             const Eigen::MatrixBase<Max>& max,
-            Scalar checkResolution)
-            : environment_(std::make_shared<impl::Mesh<Scalar>>(envMesh, false))
-            , robot_(std::make_shared<std::vector<impl::Mesh<Scalar>>>())
-            , bounds_(mpt::Unbounded{}, mpt::BoxBounds<Scalar, 3>(min, max)) // environment_.minBounds(), environment_.maxBounds())),
+            Scalar checkResolution,
+            const BodyPairs& allowedCollisions = {},
+            int prefilterCells = 64)
+            : data_(makeShared(envMesh, robotMeshes, goal, min, max, checkResolution,
+                               allowedCollisions, prefilterCells))
+            , bounds_(Bodies::bounds({mpt::Unbounded{}, mpt::BoxBounds<Scalar, 3>(min, max)})) // environment_.minBounds(), environment_.maxBounds())),
             , goal_(goalRadius, goal)
-            // , link_(space_, environment_->extents()*checkResolution, Validator(*this))
-            , link_(space_, ((max - min).norm() + Scalar(impl::SO3_WEIGHT*M_PI/2))*checkResolution, Validator(*this))
         {
-            robot_->reserve(robotMeshes.size());
-            for (const std::string& mesh : robotMeshes)
-                robot_->emplace_back(mesh, true);
+        }
 
-            MPT_LOG(DEBUG) << "Volume min: " << min.transpose();
-            MPT_LOG(DEBUG) << "Volume max: " << max.transpose();
+        bool valid(const Config& q) const {
+            return data_.context().valid(q);
+        }
+
+        // A lower bound on the distance between the robot and the
+        // environment at q, for conservative advancement along a
+        // motion: no motion that moves every point of the robot less
+        // than the clearance can collide.  0 when they may touch, or
+        // when the prefilter is disabled.
+        Scalar clearance(const Config& q) const {
+            const Shared& shared = data_.shared();
+            if (!shared.field)
+                return 0;
+
+            Scalar c = std::numeric_limits<Scalar>::infinity();
+            for (std::size_t i=0 ; i<shared.probes->size() ; ++i)
+                c = std::min(c, shared.field->clearance((*shared.probes)[i], stateToTransform(Bodies::body(q, bodyOf(i)))));
+            return c;
+        }
+
+        // Selects how link() checks motions.  Must be called before the
+        // scenario is copied to the planner.
+        void setMotionCheck(impl::MotionCheck check) {
+            modifyShared([&] (Shared& shared) { shared.motionCheck = check; });
+        }
+
+        // Allows bodies i and j to collide with each other, in addition
+        // to the pairs passed to the constructor.  Must be called
+        // before the scenario is copied to the planner.
+        void allowCollision(std::size_t i, std::size_t j) {
+            modifyShared([&] (Shared& shared) { shared.allowCollision(i, j); });
         }
 
         const Space& space() const {
-            return space_;
+            return data_.shared().space;
         }
 
         const Bounds& bounds() const {
@@ -358,11 +829,13 @@ namespace mpt_demo {
         }
 
         bool link(const Config& a, const Config& b) const {
-            return link_(a, b);
+            Context& context = data_.context();
+            if (data_.shared().motionCheck == impl::MotionCheck::kContinuous)
+                return context.continuousLink(a, b);
+            return context.link_(a, b);
         }
 
         // TODO: this shouldn't be necessary
         TravelTime travelTime(Distance dist, bool) const { return dist; }
     };
 }
-
@@ -0,0 +1,216 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#ifndef SHAPE_GRID
+#define SHAPE_GRID
+
+#include "shape_hierarchy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace shape
+{
+    // A uniform grid over Circle and Rect obstacles, built once, so
+    // that collision checks only test the shapes near the query
+    // instead of all of them.  Each cell lists the shapes whose
+    // bounding boxes overlap it (in one flat array, indexed by the
+    // cells' offsets).  A point query tests the shapes of its cell,
+    // and a segment query walks the cells the segment passes through,
+    // one row of cells at a time.
+    //
+    // The shapes' own tests decide validity, thus the results are the
+    // same as testing every shape.  A shape overlapping several cells
+    // may be tested more than once by a segment query.
+    template <typename Scalar>
+    class ShapeGrid
+    {
+    public:
+        using State = Eigen::Matrix<Scalar, 2, 1>;
+
+    private:
+        std::vector<Circle<Scalar>> circles_;
+        std::vector<Rect<Scalar>> rects_;
+
+        State min_;
+        Scalar cellSize_;
+        int cols_;
+        int rows_;
+
+        // the shapes of cell i are shapes_[cellStart_[i] ..
+        // cellStart_[i+1]), with circles first, then rects offset by
+        // the number of circles.
+        std::vector<std::uint32_t> cellStart_;
+        std::vector<std::uint32_t> shapes_;
+
+        int col(Scalar x) const
+        {
+            return std::clamp(int(std::floor((x - min_[0]) / cellSize_)), 0, cols_ - 1);
+        }
+
+        int row(Scalar y) const
+        {
+            return std::clamp(int(std::floor((y - min_[1]) / cellSize_)), 0, rows_ - 1);
+        }
+
+        template <typename Fn>
+        void forEachBox(Fn &&fn) const
+        {
+            for (const auto &c : circles_)
+                fn(State(c.cx() - c.r(), c.cy() - c.r()), State(c.cx() + c.r(), c.cy() + c.r()));
+            for (const auto &r : rects_)
+                fn(r.p0(), r.p1());
+        }
+
+        bool shapeIsValid(std::uint32_t i, const State &a, const State &b) const
+        {
+            return i < circles_.size()
+                ? circles_[i].segmentIsValid(a, b)
+                : rects_[i - circles_.size()].segmentIsValid(a, b);
+        }
+
+        bool cellIsValid(int r, int c, const State &a, const State &b) const
+        {
+            std::size_t cell = std::size_t(r) * cols_ + c;
+            for (std::uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i)
+                if (!shapeIsValid(shapes_[i], a, b))
+                    return false;
+            return true;
+        }
+
+    public:
+        // Builds the grid over the rectangle from min to max, which
+        // should cover the space that will be queried (queries and
+        // shapes outside of it fall in the border cells).  By default
+        // the cells are sized to hold about one shape each, but no
+        // smaller than the average shape.
+        ShapeGrid(
+            const std::vector<Circle<Scalar>> &circles,
+            const std::vector<Rect<Scalar>> &rects,
+            const State &min,
+            const State &max)
+            : circles_(circles), rects_(rects), min_(min)
+        {
+            State extent = (max - min).cwiseMax(State::Constant(Scalar(1e-9)));
+            std::size_t n = circles_.size() + rects_.size();
+            Scalar averageSize = 0;
+            forEachBox([&](const State &lo, const State &hi) {
+                averageSize += (hi - lo).maxCoeff();
+            });
+            if (n)
+                averageSize /= n;
+            cellSize_ = std::max(std::sqrt(extent.prod() / std::max(n, std::size_t(1))), averageSize);
+            cols_ = std::max(1, int(std::ceil(extent[0] / cellSize_)));
+            rows_ = std::max(1, int(std::ceil(extent[1] / cellSize_)));
+
+            // count, then fill, the shapes of each cell
+            cellStart_.assign(std::size_t(rows_) * cols_ + 1, 0);
+            forEachBox([&](const State &lo, const State &hi) {
+                for (int r = row(lo[1]); r <= row(hi[1]); ++r)
+                    for (int c = col(lo[0]); c <= col(hi[0]); ++c)
+                        ++cellStart_[std::size_t(r) * cols_ + c + 1];
+            });
+            for (std::size_t i = 1; i < cellStart_.size(); ++i)
+                cellStart_[i] += cellStart_[i - 1];
+            shapes_.resize(cellStart_.back());
+            std::vector<std::uint32_t> next(cellStart_.begin(), cellStart_.end() - 1);
+            std::uint32_t id = 0;
+            forEachBox([&](const State &lo, const State &hi) {
+                for (int r = row(lo[1]); r <= row(hi[1]); ++r)
+                    for (int c = col(lo[0]); c <= col(hi[0]); ++c)
+                        shapes_[next[std::size_t(r) * cols_ + c]++] = id;
+                ++id;
+            });
+        }
+
+        bool pointIsValid(const State &p) const
+        {
+            std::size_t cell = std::size_t(row(p[1])) * cols_ + col(p[0]);
+            for (std::uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i)
+            {
+                std::uint32_t s = shapes_[i];
+                if (s < circles_.size() ? !circles_[s].pointIsValid(p) : !rects_[s - circles_.size()].pointIsValid(p))
+                    return false;
+            }
+            return true;
+        }
+
+        bool segmentIsValid(const State &a, const State &b) const
+        {
+            // for each row of cells, the cells between the smallest
+            // and largest x of the segment within the row's (closed)
+            // band of y.
+            int r0 = row(std::min(a[1], b[1]));
+            int r1 = row(std::max(a[1], b[1]));
+            for (int r = r0; r <= r1; ++r)
+            {
+                Scalar x0 = std::min(a[0], b[0]);
+                Scalar x1 = std::max(a[0], b[0]);
+                if (r0 != r1)
+                {
+                    // clip to the band, except beyond the first and
+                    // last rows, which also hold any part of the
+                    // segment outside the grid
+                    Scalar y0 = r == r0 ? std::min(a[1], b[1]) : min_[1] + r * cellSize_;
+                    Scalar y1 = r == r1 ? std::max(a[1], b[1]) : min_[1] + (r + 1) * cellSize_;
+                    Scalar t0 = (y0 - a[1]) / (b[1] - a[1]);
+                    Scalar t1 = (y1 - a[1]) / (b[1] - a[1]);
+                    Scalar xa = a[0] + (b[0] - a[0]) * std::clamp(t0, Scalar(0), Scalar(1));
+                    Scalar xb = a[0] + (b[0] - a[0]) * std::clamp(t1, Scalar(0), Scalar(1));
+                    x0 = std::min(xa, xb);
+                    x1 = std::max(xa, xb);
+                }
+                for (int c = col(x0); c <= col(x1); ++c)
+                    if (!cellIsValid(r, c, a, b))
+                        return false;
+            }
+            return true;
+        }
+
+        int cols() const
+        {
+            return cols_;
+        }
+
+        int rows() const
+        {
+            return rows_;
+        }
+    };
+}
+
+#endif
@@ -181,6 +181,16 @@ namespace shape
             return !(px >= p0_[0] && px <= p1_[0] && py >= p0_[1] && py <= p1_[1]);
         }
 
+        const State &p0() const
+        {
+            return p0_;
+        }
+
+        const State &p1() const
+        {
+            return p1_;
+        }
+
         bool segmentIsValid(const State &a, const State &b) const
         {
             if (!pointIsValid(a) || !pointIsValid(b))
@@ -0,0 +1,295 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_DEMO_SYNTHETIC_SCENARIO_HPP
+#define MPT_DEMO_SYNTHETIC_SCENARIO_HPP
+
+#include <mpt/box_bounds.hpp>
+#include <mpt/goal_state.hpp>
+#include <mpt/impl/constants.hpp>
+#include <mpt/log.hpp>
+#include <mpt/lp_space.hpp>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace mpt_demo {
+    using namespace unc::robotics::mpt;
+
+    struct SyntheticScenarioParams {
+        // number of random hypersphere obstacles
+        unsigned obstacleCount{20};
+
+        // fraction of the workspace volume covered by the obstacles
+        // (ignoring overlaps).  This determines the obstacle radius.
+        double obstacleDensity{0.2};
+
+        // width of the passage through the wall between the start
+        // and goal.  0 removes the wall.
+        double passageWidth{0.2};
+
+        // thickness of the wall along the first axis
+        double wallThickness{0.1};
+
+        // iterations of synthetic busy-work per state checked,
+        // emulating the cost of a collision checker such as FCL.  0
+        // disables the busy-work.
+        unsigned checkCost{0};
+
+        // states per unit length checked along a motion.  With
+        // checkCost > 0, a motion costs as many state checks as a
+        // discrete motion validator at this resolution would make.
+        double linkResolution{100};
+
+        // seed for the obstacle placement
+        std::uint32_t seed{1};
+    };
+
+    // A synthetic scenario for dimension-scaling studies, based upon
+    // the test's BasicScenario.  The configuration space is the
+    // [-1,1]^dimensions box.  The start and the goal are on opposite
+    // sides of a wall perpendicular to the first axis, with a single
+    // slot-shaped passage through it that is offset from the
+    // straight line between them.  Random hypersphere obstacles are
+    // scattered throughout.  All collision checks are exact, the
+    // optional busy-work only adds cost.
+    template <typename Scalar, int dimensions>
+    class SyntheticScenario {
+        static_assert(dimensions >= 2, "must be 2D or greater");
+
+    public:
+        using Space = L2Space<Scalar, dimensions>;
+        using Bounds = BoxBounds<Scalar, dimensions>;
+        using State = typename Space::Type;
+        using Distance = typename Space::Distance;
+        using Goal = GoalState<Space>;
+
+        struct Sphere {
+            State center_;
+            Scalar radiusSquared_;
+        };
+
+    private:
+        Space space_;
+        Bounds bounds_;
+        Goal goal_;
+
+        // obstacles are immutable after construction, and shared
+        // between the copies each worker makes of the scenario.
+        std::shared_ptr<const std::vector<Sphere>> spheres_;
+
+        bool wall_;
+        Scalar wallHalfThickness_;
+        Scalar passageHalfWidth_;
+        Scalar passageCenter_;
+
+        unsigned checkCost_;
+        Scalar linkResolution_;
+
+        static State makePoint(Scalar x0, Scalar x1) {
+            State q = State::Zero();
+            q[0] = x0;
+            q[1] = x1;
+            return q;
+        }
+
+        static Bounds makeBounds() {
+            return Bounds(State::Constant(-1), State::Constant(1));
+        }
+
+        // radius of a hypersphere with the given volume
+        static Scalar sphereRadius(double volume) {
+            // volume of the unit d-ball is pi^(d/2) / Gamma(d/2 + 1)
+            using unc::robotics::mpt::impl::PI;
+            double unitVolume = std::exp(dimensions / 2.0 * std::log(PI<double>) - std::lgamma(dimensions / 2.0 + 1));
+            return static_cast<Scalar>(std::pow(volume / unitVolume, 1.0 / dimensions));
+        }
+
+        template <typename Pt, typename S0, typename S1>
+        static Scalar distPointSegmentSquared(const Pt& pt, const S0& s0, const S1& s1) {
+            State v = s1 - s0;
+            State w = pt - s0;
+            Scalar c1 = v.dot(w);
+            if (c1 <= 0)
+                return w.squaredNorm();
+            Scalar c2 = v.squaredNorm();
+            if (c2 <= c1)
+                return (pt - s1).squaredNorm();
+            return (s0 - pt + v * (c1 / c2)).squaredNorm();
+        }
+
+        // true if q is in the passage's cross section (ignoring the
+        // first coordinate).  The passage is only narrow along the
+        // second axis, so that the fraction of the wall it covers
+        // does not shrink with the dimension.
+        bool inPassage(const State& q) const {
+            return std::abs(q[1] - passageCenter_) <= passageHalfWidth_;
+        }
+
+        bool wallClear(const State& q) const {
+            return !wall_ || std::abs(q[0]) > wallHalfThickness_ || inPassage(q);
+        }
+
+        bool wallClear(const State& a, const State& b) const {
+            if (!wall_)
+                return true;
+
+            // clip the segment to the wall's slab
+            Scalar t0 = 0, t1 = 1;
+            Scalar d = b[0] - a[0];
+            if (d == 0) {
+                if (std::abs(a[0]) > wallHalfThickness_)
+                    return true;
+            } else {
+                Scalar s0 = (-wallHalfThickness_ - a[0]) / d;
+                Scalar s1 = ( wallHalfThickness_ - a[0]) / d;
+                if (s0 > s1) std::swap(s0, s1);
+                t0 = std::max(t0, s0);
+                t1 = std::min(t1, s1);
+                if (t0 > t1)
+                    return true;
+            }
+
+            // the passage's cross section is convex, so the clipped
+            // segment is in the passage iff both its ends are.
+            return inPassage(a + (b - a) * t0) && inPassage(a + (b - a) * t1);
+        }
+
+        void busyWork(Scalar x, std::size_t iterations) const {
+            for (std::size_t i=0 ; i<iterations ; ++i)
+                x = x * Scalar(0.999999) + Scalar(1e-6);
+            volatile Scalar sink = x;
+            (void)sink;
+        }
+
+    public:
+        explicit SyntheticScenario(const SyntheticScenarioParams& params = SyntheticScenarioParams())
+            : bounds_(makeBounds())
+            , goal_(1e-6, goalState())
+            , wall_(params.passageWidth > 0)
+            , wallHalfThickness_(params.wallThickness / 2)
+            , passageHalfWidth_(params.passageWidth / 2)
+            , passageCenter_(0.5)
+            , checkCost_(params.checkCost)
+            , linkResolution_(params.linkResolution)
+        {
+            auto spheres = std::make_shared<std::vector<Sphere>>();
+            if (params.obstacleCount) {
+                Scalar r = sphereRadius(
+                    params.obstacleDensity * std::pow(2.0, dimensions) / params.obstacleCount);
+                State passage = makePoint(0, passageCenter_);
+
+                // place spheres uniformly, but keep them clear of
+                // the start, the goal, and the passage's entrance, so
+                // that most parameters give solvable scenarios.
+                std::mt19937 rng(params.seed);
+                std::uniform_real_distribution<Scalar> coord(-1, 1);
+                unsigned attempts = 100 * params.obstacleCount;
+                while (spheres->size() < params.obstacleCount && attempts--) {
+                    State c;
+                    for (int i=0 ; i<dimensions ; ++i)
+                        c[i] = coord(rng);
+                    if ((c - startState()).norm() < r + Scalar(0.05) ||
+                        (c - goalState()).norm() < r + Scalar(0.05) ||
+                        (c - passage).norm() < r + passageHalfWidth_ + wallHalfThickness_)
+                        continue;
+                    spheres->push_back(Sphere{c, r*r});
+                }
+
+                if (spheres->size() < params.obstacleCount)
+                    MPT_LOG(WARN) << "placed only " << spheres->size() << " of "
+                                  << params.obstacleCount << " obstacles of radius " << r;
+                MPT_LOG(DEBUG) << dimensions << "D synthetic scenario with "
+                               << spheres->size() << " obstacles of radius " << r;
+            }
+            spheres_ = std::move(spheres);
+        }
+
+        static State startState() {
+            return makePoint(-0.9, -0.5);
+        }
+
+        static State goalState() {
+            return makePoint(0.9, -0.5);
+        }
+
+        const Space& space() const {
+            return space_;
+        }
+
+        const Bounds& bounds() const {
+            return bounds_;
+        }
+
+        const Goal& goal() const {
+            return goal_;
+        }
+
+        const std::vector<Sphere>& obstacles() const {
+            return *spheres_;
+        }
+
+        bool valid(const State& q) const {
+            if (checkCost_)
+                busyWork(q[0], checkCost_);
+
+            if (!wallClear(q))
+                return false;
+            for (const Sphere& s : *spheres_)
+                if ((q - s.center_).squaredNorm() <= s.radiusSquared_)
+                    return false;
+            return true;
+        }
+
+        bool link(const State& a, const State& b) const {
+            if (checkCost_) {
+                std::size_t steps = std::ceil((b - a).norm() * linkResolution_);
+                busyWork(a[0], checkCost_ * std::max(steps, std::size_t(1)));
+            }
+
+            if (!wallClear(a, b))
+                return false;
+            for (const Sphere& s : *spheres_)
+                if (distPointSegmentSquared(s.center_, a, b) <= s.radiusSquared_)
+                    return false;
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,404 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_ASYNC_LOG_HPP
+#define MPT_ASYNC_LOG_HPP
+
+#include "log.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+// Asynchronous logging for hot paths.
+//
+// MPT_LOG_ASYNC(LEVEL) << "message" << args...;
+//
+// Unlike MPT_LOG, the calling thread does not format the message,
+// allocate, or write to the output.  Instead the arguments are copied
+// (in binary form) into a fixed-size record in a per-thread ring
+// buffer.  A background thread periodically drains the ring buffers,
+// formats the records with the same formatting as MPT_LOG, and
+// outputs them through the same log queue.  Messages thus appear
+// after a short delay, with the time at which they were logged.
+//
+// Arguments must be trivially copyable (e.g., numbers, durations,
+// pointers), strings (which are copied), or fixed-size Eigen
+// matrices.  If a thread's ring buffer is full, its messages are
+// dropped (and the number dropped is reported) rather than blocking.
+// Similarly, arguments that do not fit in a record are truncated.
+
+namespace unc::robotics::mpt::log::detail {
+    using AsyncArgFormat = std::size_t (*)(Event&, const unsigned char*);
+
+    constexpr std::size_t asyncPad(std::size_t n) {
+        return (n + 7) & ~std::size_t(7);
+    }
+
+    struct AsyncRecord {
+        static constexpr std::size_t kArgBytes = 192;
+        static constexpr std::size_t kThreadNameSize = 16;
+
+        void (*write_)(const AsyncRecord&);
+        const char *file_;
+        int line_;
+        std::uint16_t size_;
+        bool truncated_;
+        std::chrono::system_clock::time_point when_;
+        char threadName_[kThreadNameSize];
+        alignas(8) unsigned char args_[kArgBytes];
+    };
+
+    template <typename Level>
+    void writeAsyncRecord(const AsyncRecord& record) {
+        Event evt(Level{}, record.file_, record.line_, record.when_,
+                  std::string_view(record.threadName_));
+        for (std::size_t i = 0 ; i < record.size_ ; ) {
+            AsyncArgFormat format;
+            std::memcpy(&format, record.args_ + i, sizeof(format));
+            i += sizeof(format);
+            i += format(evt, record.args_ + i);
+        }
+        if (record.truncated_)
+            evt << "...";
+    }
+
+    // Single-producer, single-consumer ring buffer of records.  The
+    // producer is the logging thread, and the consumer is whichever
+    // thread holds the AsyncLogger's drain lock.
+    class AsyncLogBuffer {
+        static constexpr std::size_t kCapacity = 1024;
+        static_assert((kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of 2");
+
+        alignas(64) std::atomic<std::size_t> head_{0};
+        std::atomic<std::size_t> dropped_{0};
+        alignas(64) std::atomic<std::size_t> tail_{0};
+        std::size_t reportedDrops_{0};
+
+        std::atomic_bool inUse_{true};
+        AsyncLogBuffer *next_{nullptr};
+
+        AsyncRecord records_[kCapacity];
+
+        friend class AsyncLogger;
+
+    public:
+        // Returns the next record to fill, or nullptr if the buffer
+        // is full.  Only called by the producer.
+        AsyncRecord* claim() {
+            std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) < kCapacity)
+                return &records_[head & (kCapacity - 1)];
+
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        // Publishes the record returned by claim().
+        void commit() {
+            head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // Writes out all published records.  Only called by the
+        // consumer.
+        void drain() {
+            std::size_t tail = tail_.load(std::memory_order_relaxed);
+            std::size_t head = head_.load(std::memory_order_acquire);
+            for ( ; tail != head ; ++tail) {
+                const AsyncRecord& record = records_[tail & (kCapacity - 1)];
+                record.write_(record);
+                tail_.store(tail + 1, std::memory_order_release);
+            }
+
+            std::size_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (dropped != reportedDrops_) {
+                MPT_LOG(WARN) << "async log buffer full, dropped "
+                              << (dropped - reportedDrops_) << " messages";
+                reportedDrops_ = dropped;
+            }
+        }
+    };
+
+    // Owns the ring buffers and the background thread that drains
+    // them.  The logger and its ring buffers are never freed, since
+    // threads that exit during static destruction (e.g., those of
+    // ThreadPool::singleton()) release their buffers after the
+    // logger's static storage would be destroyed.  When a thread
+    // exits, its buffer is released to be reused by the next thread
+    // that logs, thus the number of buffers is bounded by the
+    // maximum number of concurrently logging threads.
+    class AsyncLogger {
+        static constexpr std::chrono::milliseconds kFlushInterval{2};
+
+        std::atomic<AsyncLogBuffer*> buffers_{nullptr};
+        std::atomic_bool done_{false};
+        std::mutex drainMutex_;
+        std::thread thread_;
+
+        AsyncLogger() {
+            // make sure the log queue outlives this logger, since the
+            // destructor drains into it.
+            LogQueue::instance();
+            thread_ = std::thread([&] {
+                setThreadName("log");
+                while (!done_.load(std::memory_order_relaxed)) {
+                    drain();
+                    std::this_thread::sleep_for(kFlushInterval);
+                }
+            });
+        }
+
+    public:
+        AsyncLogger(const AsyncLogger&) = delete;
+        AsyncLogger& operator = (const AsyncLogger&) = delete;
+
+        // Stops the background thread and writes out all pending
+        // messages at exit.  Messages logged afterwards remain in
+        // their buffers until the next call to drain().
+        class Shutdown {
+            AsyncLogger& logger_;
+        public:
+            explicit Shutdown(AsyncLogger& logger) : logger_(logger) {}
+            ~Shutdown() {
+                logger_.done_.store(true);
+                logger_.thread_.join();
+                logger_.drain();
+            }
+        };
+
+        static AsyncLogger& instance() {
+            static AsyncLogger& logger = *new AsyncLogger();
+            static Shutdown shutdown(logger);
+            return logger;
+        }
+
+        // Returns a buffer for the calling thread to use, reusing a
+        // released buffer if one is available.
+        AsyncLogBuffer* acquire() {
+            for (AsyncLogBuffer *b = buffers_.load(std::memory_order_acquire) ; b ; b = b->next_)
+                if (!b->inUse_.load(std::memory_order_relaxed) &&
+                    !b->inUse_.exchange(true, std::memory_order_acquire))
+                    return b;
+
+            AsyncLogBuffer *b = new AsyncLogBuffer();
+            b->next_ = buffers_.load(std::memory_order_relaxed);
+            while (!buffers_.compare_exchange_weak(b->next_, b, std::memory_order_release))
+                ;
+            return b;
+        }
+
+        void release(AsyncLogBuffer *buffer) {
+            buffer->inUse_.store(false, std::memory_order_release);
+        }
+
+        void drain() {
+            std::lock_guard<std::mutex> lock(drainMutex_);
+            for (AsyncLogBuffer *b = buffers_.load(std::memory_order_acquire) ; b ; b = b->next_)
+                b->drain();
+        }
+    };
+
+    class AsyncLogHandle {
+        AsyncLogBuffer *buffer_;
+
+    public:
+        AsyncLogHandle()
+            : buffer_(AsyncLogger::instance().acquire())
+        {
+        }
+
+        ~AsyncLogHandle() {
+            AsyncLogger::instance().release(buffer_);
+        }
+
+        static AsyncLogBuffer& buffer() {
+            thread_local AsyncLogHandle handle;
+            return *handle.buffer_;
+        }
+    };
+
+    template <typename T>
+    std::size_t formatAsyncValue(Event& evt, const unsigned char *p) {
+        evt << *std::launder(reinterpret_cast<const T*>(p));
+        return asyncPad(sizeof(T));
+    }
+
+    inline std::size_t formatAsyncString(Event& evt, const unsigned char *p) {
+        std::uint16_t n;
+        std::memcpy(&n, p, sizeof(n));
+        evt << std::string_view(reinterpret_cast<const char*>(p + sizeof(n)), n);
+        return asyncPad(sizeof(n) + n);
+    }
+
+    template <typename Scalar, int rows, int cols>
+    std::size_t formatAsyncMatrix(Event& evt, const unsigned char *p) {
+        evt << Eigen::Map<const Eigen::Matrix<Scalar, rows, cols>>(
+            reinterpret_cast<const Scalar*>(p));
+        return asyncPad(sizeof(Scalar) * rows * cols);
+    }
+
+    template <typename T>
+    constexpr bool is_async_loggable_v =
+        std::is_trivially_copyable_v<T> &&
+        !std::is_array_v<T> &&
+        !std::is_same_v<T, char*> &&
+        !std::is_same_v<T, const char*> &&
+        alignof(T) <= 8;
+}
+
+namespace unc::robotics::mpt::log {
+    class AsyncEvent {
+        using Record = detail::AsyncRecord;
+
+        detail::AsyncLogBuffer& buffer_;
+        Record *record_;
+
+        unsigned char* reserve(detail::AsyncArgFormat format, std::size_t bytes) {
+            if (record_ == nullptr || record_->truncated_)
+                return nullptr;
+
+            std::size_t need = sizeof(format) + detail::asyncPad(bytes);
+            if (record_->size_ + need > Record::kArgBytes) {
+                record_->truncated_ = true;
+                return nullptr;
+            }
+
+            unsigned char *p = record_->args_ + record_->size_;
+            std::memcpy(p, &format, sizeof(format));
+            record_->size_ += need;
+            return p + sizeof(format);
+        }
+
+    public:
+        template <typename Level>
+        AsyncEvent(const Level&, const char *file, int line)
+            : buffer_(detail::AsyncLogHandle::buffer())
+            , record_(buffer_.claim())
+        {
+            if (record_) {
+                record_->write_ = &detail::writeAsyncRecord<Level>;
+                record_->file_ = file;
+                record_->line_ = line;
+                record_->size_ = 0;
+                record_->truncated_ = false;
+                record_->when_ = std::chrono::system_clock::now();
+
+                const std::string& name = getThreadName();
+                std::size_t n = std::min(name.size(), Record::kThreadNameSize - 1);
+                std::memcpy(record_->threadName_, name.data(), n);
+                record_->threadName_[n] = '\0';
+            }
+        }
+
+        AsyncEvent(const AsyncEvent&) = delete;
+
+        ~AsyncEvent() {
+            if (record_)
+                buffer_.commit();
+        }
+
+        template <typename T>
+        std::enable_if_t<detail::is_async_loggable_v<T>, AsyncEvent&>
+        operator << (const T& arg) {
+            if (unsigned char *p = reserve(&detail::formatAsyncValue<T>, sizeof(T)))
+                new (p) T(arg);
+            return *this;
+        }
+
+        AsyncEvent& operator << (std::string_view str) {
+            if (record_ == nullptr || record_->truncated_)
+                return *this;
+
+            // copy as much of the string as fits in the record.
+            constexpr std::size_t overhead = sizeof(detail::AsyncArgFormat) + sizeof(std::uint16_t);
+            std::size_t avail = Record::kArgBytes - record_->size_;
+            std::uint16_t n = avail > overhead ? std::min(str.size(), avail - overhead) : 0;
+            if (unsigned char *p = reserve(&detail::formatAsyncString, sizeof(n) + n)) {
+                std::memcpy(p, &n, sizeof(n));
+                std::memcpy(p + sizeof(n), str.data(), n);
+                if (n < str.size())
+                    record_->truncated_ = true;
+            }
+            return *this;
+        }
+
+        AsyncEvent& operator << (const char *str) {
+            return *this << std::string_view(str);
+        }
+
+        AsyncEvent& operator << (const std::string& str) {
+            return *this << std::string_view(str);
+        }
+
+        template <typename Scalar, int rows, int cols, int options, int maxRows, int maxCols>
+        std::enable_if_t<(rows > 0 && cols > 0), AsyncEvent&>
+        operator << (const Eigen::Matrix<Scalar, rows, cols, options, maxRows, maxCols>& m) {
+            static_assert(detail::is_async_loggable_v<Scalar>);
+            // copied in column-major order to match the Map used to
+            // format it.
+            if (unsigned char *p = reserve(
+                    &detail::formatAsyncMatrix<Scalar, rows, cols>, sizeof(Scalar) * rows * cols))
+            {
+                Scalar *q = reinterpret_cast<Scalar*>(p);
+                for (int j = 0 ; j < cols ; ++j)
+                    for (int i = 0 ; i < rows ; ++i)
+                        *q++ = m(i, j);
+            }
+            return *this;
+        }
+
+        // See Event::operator bool
+        inline constexpr operator bool () const { return false; }
+    };
+
+    // Blocks until all asynchronous log messages logged before this
+    // call are written.
+    inline void flushAsync() {
+        detail::AsyncLogger::instance().drain();
+    }
+}
+
+#define MPT_LOG_ASYNC(LVL)                                              \
+    ::unc::robotics::mpt::log::is_enabled< ::unc::robotics::mpt::log::level::LVL >::value && \
+    ::unc::robotics::mpt::log::AsyncEvent( ::unc::robotics::mpt::log::level::LVL {}, __FILE__, __LINE__)
+
+#endif
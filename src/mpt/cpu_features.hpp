@@ -0,0 +1,99 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_CPU_FEATURES_HPP
+#define MPT_CPU_FEATURES_HPP
+
+namespace unc::robotics::mpt {
+    // Instruction set levels that a planner may be compiled for.  The
+    // planners are header-only templates, thus the vector
+    // instructions used for the distance computations and collision
+    // checks of a planner are determined by the compiler flags of the
+    // translation unit it is instantiated in.  A program can
+    // instantiate the same planners once per level and pick the one
+    // for the CPU it is running on.  The instantiations must be kept
+    // in separately linked modules (e.g., shared objects with hidden
+    // visibility), since the linker otherwise merges the inline
+    // functions common to all levels.  Each level implies the ones
+    // before it.
+    enum class InstructionSet {
+        kGeneric,
+        kAVX2,   // AVX2 and FMA (x86-64-v3)
+        kAVX512, // AVX-512 F, CD, BW, DQ, VL (x86-64-v4)
+    };
+
+    inline const char* instructionSetName(InstructionSet isa) {
+        switch (isa) {
+        case InstructionSet::kAVX2: return "avx2";
+        case InstructionSet::kAVX512: return "avx512";
+        default: return "generic";
+        }
+    }
+
+    // The instruction set level of the current translation unit.
+    constexpr InstructionSet compiledInstructionSet() {
+#if defined(__AVX512F__) && defined(__AVX512CD__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+        return InstructionSet::kAVX512;
+#elif defined(__AVX2__) && defined(__FMA__)
+        return InstructionSet::kAVX2;
+#else
+        return InstructionSet::kGeneric;
+#endif
+    }
+
+    // The highest instruction set level supported by the CPU (and
+    // operating system) running the program.
+    inline InstructionSet hostInstructionSet() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+        static const InstructionSet isa = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") &&
+                __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq") &&
+                __builtin_cpu_supports("avx512vl"))
+                return InstructionSet::kAVX512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return InstructionSet::kAVX2;
+            return InstructionSet::kGeneric;
+        }();
+        return isa;
+#else
+        return InstructionSet::kGeneric;
+#endif
+    }
+}
+
+#endif
@@ -0,0 +1,152 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_IMPL_MEMORY_COUNTER_HPP
+#define MPT_IMPL_MEMORY_COUNTER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace unc::robotics::mpt::impl {
+    // MemoryCounter is a byte count that is updated by a single
+    // thread (the owner, typically a worker), but may be read at any
+    // time by other threads.  Since there is only one writer, the
+    // update does not require an atomic read-modify-write, just a
+    // relaxed load and store, which compiles to plain moves on most
+    // architectures.
+    class MemoryCounter {
+        std::atomic<std::size_t> bytes_{0};
+
+    public:
+        MemoryCounter() = default;
+
+        MemoryCounter(const MemoryCounter& other)
+            : bytes_(other.load())
+        {
+        }
+
+        std::size_t load() const {
+            return bytes_.load(std::memory_order_relaxed);
+        }
+
+        void store(std::size_t bytes) {
+            bytes_.store(bytes, std::memory_order_relaxed);
+        }
+
+        // Stores bytes only when it differs from the count, sparing
+        // the write (and the readers' cached copy of the counter)
+        // when a scratch buffer is reused without growing.
+        void update(std::size_t bytes) {
+            if (load() != bytes)
+                store(bytes);
+        }
+
+        MemoryCounter& operator += (std::size_t bytes) {
+            store(load() + bytes);
+            return *this;
+        }
+
+        MemoryCounter& operator -= (std::size_t bytes) {
+            store(load() - bytes);
+            return *this;
+        }
+    };
+
+    // heapBytes(value) returns the number of bytes of heap memory
+    // owned by the value, not including sizeof(value) itself.  It is
+    // used to account for the trajectories returned by link().
+    // Unknown types are assumed to not own heap memory.  Raw
+    // pointers are not owned by the planner and thus count as 0.
+    template <typename T>
+    std::size_t heapBytes(const T&) {
+        return 0;
+    }
+
+    template <typename T, typename A>
+    std::size_t heapBytes(const std::vector<T, A>& v);
+
+    template <typename T>
+    std::size_t heapBytes(const std::shared_ptr<T>& p);
+
+    template <typename T, typename D>
+    std::size_t heapBytes(const std::unique_ptr<T, D>& p);
+
+    template <typename T, typename A>
+    std::size_t heapBytes(const std::vector<T, A>& v) {
+        std::size_t bytes = v.capacity() * sizeof(T);
+        if constexpr (!std::is_trivially_copyable_v<T>)
+            for (const T& e : v)
+                bytes += heapBytes(e);
+        return bytes;
+    }
+
+    // A shared pointer's bytes are counted in full.  The planners
+    // count a trajectory once when link() creates it and not again
+    // when it is shared between edges.
+    template <typename T>
+    std::size_t heapBytes(const std::shared_ptr<T>& p) {
+        return p ? sizeof(T) + heapBytes(*p) : 0;
+    }
+
+    template <typename T, typename D>
+    std::size_t heapBytes(const std::unique_ptr<T, D>& p) {
+        return p ? sizeof(T) + heapBytes(*p) : 0;
+    }
+
+    template <typename NN, typename = void>
+    struct nearest_has_memory_usage : std::false_type {};
+
+    template <typename NN>
+    struct nearest_has_memory_usage<NN, std::void_t<decltype(std::declval<const NN&>().memoryUsage())>>
+        : std::true_type {};
+
+    // Returns the memory used by a nearest neighbor structure.  If
+    // the structure does not report its own usage, this is a lower
+    // bound of one pointer per element.
+    template <typename T, typename NN>
+    std::size_t nearestMemoryUsage(const NN& nn) {
+        if constexpr (nearest_has_memory_usage<NN>::value)
+            return nn.memoryUsage();
+        else
+            return nn.size() * sizeof(T);
+    }
+}
+
+#endif
@@ -37,6 +37,8 @@
 #ifndef MPT_IMPL_OBJECT_POOL_HPP
 #define MPT_IMPL_OBJECT_POOL_HPP
 
+#include "memory_counter.hpp"
+#include "../memory_usage.hpp"
 #include <deque>
 #include <forward_list>
 
@@ -51,14 +53,21 @@ namespace unc::robotics::mpt::impl {
     // (e.g. the graph of a planner).
     //
     // Once an object is allocated from the pool it will remain valid,
-    // until the pool is destroyed.  Thus the only exposed methods of
-    // a pool are guaranteed to keep pointers valid.  It also means
+    // until the pool is destroyed or cleared.  Thus the only exposed
+    // methods of a pool, other than clear(), are guaranteed to keep
+    // pointers valid.  It also means
     // that ObjectPools are movable, but not copiable, as copying
     // would have ill-defined semantics when it comes to the resulting
     // pointers.
     //
     // ObjectPools that are block-allocated can also provide a
     // performance boost over individually allocated objects.
+    //
+    // Pools keep a count of the objects allocated that can be read
+    // concurrently with the owning thread's allocations, so that
+    // memoryUsage() can be queried while a planner is solving.  The
+    // pool's allocations are attributed to its AllocationSite (see
+    // memory_usage.hpp), kNodes unless specified otherwise.
     template <typename T, bool block = true, class Allocator = std::allocator<T>>
     class ObjectPool;
 
@@ -69,26 +78,65 @@ namespace unc::robotics::mpt::impl {
     template <typename T, class Allocator>
     class ObjectPool<T, true, Allocator> : std::deque<T, Allocator> {
         using Base = std::deque<T, Allocator>;
+
+        // The number of objects std::deque stores per block.  This
+        // mirrors the standard library implementations (libc++ uses
+        // 4096 byte blocks, libstdc++ uses 512 byte blocks).
+#ifdef _LIBCPP_VERSION
+        static constexpr std::size_t kBlockSize = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+#else
+        static constexpr std::size_t kBlockSize = sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+#endif
+
+        MemoryCounter size_;
+        AllocationSite site_;
+
     public:
         // Delete the copy constructor--it does not typically make
         // sense under intended usage since the resulting copy will
         // have invalid pointers.
         ObjectPool(const ObjectPool&) = delete;
 
-        ObjectPool() {
+        explicit ObjectPool(AllocationSite site = AllocationSite::kNodes)
+            : site_(site)
+        {
         }
 
         ObjectPool(ObjectPool&& other)
             : Base(std::move(other))
+            , size_(other.size_)
+            , site_(other.site_)
         {
         }
 
         template <typename ... Args>
         T* allocate(Args&& ... args) {
+            AllocationScope scope(site_);
             Base::emplace_back(std::forward<Args>(args)...);
+            size_ += 1;
             return &Base::back();
         }
 
+        std::size_t size() const {
+            return size_.load();
+        }
+
+        // Destroys all objects allocated from the pool, invalidating
+        // all pointers to them.
+        void clear() {
+            Base::clear();
+            size_.store(0);
+        }
+
+        // Estimated bytes used by the pool's blocks and the deque's
+        // map of block pointers, 0 for an empty pool.
+        std::size_t memoryUsage() const {
+            if (size() == 0)
+                return 0;
+            std::size_t blocks = size() / kBlockSize + 1;
+            return blocks * (kBlockSize * sizeof(T) + sizeof(T*));
+        }
+
         using Base::begin;
         using Base::end;
     };
@@ -98,23 +146,54 @@ namespace unc::robotics::mpt::impl {
     template <typename T, class Allocator>
     class ObjectPool<T, false, Allocator> : std::forward_list<T, Allocator> {
         using Base = std::forward_list<T, Allocator>;
+
+        // matches the layout of a std::forward_list node.
+        struct ListNode {
+            void *next_;
+            T value_;
+        };
+
+        MemoryCounter size_;
+        AllocationSite site_;
+
     public:
         ObjectPool(const ObjectPool&) = delete;
 
-        ObjectPool() {
+        explicit ObjectPool(AllocationSite site = AllocationSite::kNodes)
+            : site_(site)
+        {
         }
 
         ObjectPool(ObjectPool&& other)
             : Base(std::move(other))
+            , size_(other.size_)
+            , site_(other.site_)
         {
         }
 
         template <typename ... Args>
         T* allocate(Args&& ... args) {
+            AllocationScope scope(site_);
             Base::emplace_front(std::forward<Args>(args)...);
+            size_ += 1;
             return &Base::front();
         }
 
+        std::size_t size() const {
+            return size_.load();
+        }
+
+        void clear() {
+            Base::clear();
+            size_.store(0);
+        }
+
+        // Estimated bytes used by the individually allocated list
+        // nodes.
+        std::size_t memoryUsage() const {
+            return size() * sizeof(ListNode);
+        }
+
         using Base::begin;
         using Base::end;
     };
@@ -74,15 +74,10 @@ namespace unc::robotics::mpt::impl::pprm {
             return c;
         }
 
-        Component* addEdge(Edge<State, Distance, Traj> *edge) {
-            Edge<State, Distance, Traj> *head = edges_.load(std::memory_order_relaxed);
-            do {
-                edge->setNext(head, std::memory_order_relaxed);
-            } while (edges_.compare_exchange_weak(
-                         head, edge,
-                         std::memory_order_release,
-                         std::memory_order_relaxed));
-            return component();
+        // Adds the edge to this node's edge list.  Returns the number
+        // of CAS retries required to link it in.
+        unsigned addEdge(Edge<State, Distance, Traj> *edge) {
+            return linkEdge(edges_, edge);
         }
     };
 
@@ -43,16 +43,21 @@
 #include "../djikstras.hpp"
 #include "../goal_has_sampler.hpp"
 #include "../link_trajectory.hpp"
+#include "../memory_counter.hpp"
 #include "../object_pool.hpp"
 #include "../planner_base.hpp"
+#include "../retry_stat.hpp"
 #include "../scenario_goal.hpp"
 #include "../scenario_goal_sampler.hpp"
 #include "../scenario_link.hpp"
 #include "../scenario_rng.hpp"
 #include "../scenario_sampler.hpp"
 #include "../scenario_space.hpp"
+#include "../timer_stat.hpp"
 #include "../worker_pool.hpp"
+#include "../../async_log.hpp"
 #include "../../goal_sampler.hpp"
+#include "../../memory_usage.hpp"
 #include "../../random_device_seed.hpp"
 #include <mutex>
 #include <atomic>
@@ -62,8 +67,63 @@
 
 namespace unc::robotics::mpt::impl::pprm {
 
-    template <typename Scenario, int maxThreads, bool reportStats, typename NNStrategy>
-    class PPRM : public PlannerBase<PPRM<Scenario, maxThreads, reportStats, NNStrategy>> {
+    template <bool enable, int sampleRate>
+    struct WorkerStats;
+
+    template <int sampleRate>
+    struct WorkerStats<false, sampleRate> {
+        void countIteration() const {}
+        auto& validMotion() { return TimerStat<void>::instance(); }
+        auto& nearest() { return TimerStat<void>::instance(); }
+        auto& edgeListRetries() { return RetryStat<false>::instance(); }
+        auto& mergeRetries() { return RetryStat<false>::instance(); }
+    };
+
+    template <int sampleRate>
+    struct WorkerStats<true, sampleRate> {
+        using TimeStat = TimerStat<std::chrono::steady_clock, sampleRate>;
+
+        mutable std::size_t iterations_{0};
+        mutable TimeStat validMotion_;
+        mutable TimeStat nearest_;
+        mutable RetryStat<> edgeListRetries_;
+        mutable RetryStat<> mergeRetries_;
+
+        void countIteration() const { ++iterations_; }
+        TimeStat& validMotion() const { return validMotion_; }
+        TimeStat& nearest() const { return nearest_; }
+        RetryStat<>& edgeListRetries() const { return edgeListRetries_; }
+        RetryStat<>& mergeRetries() const { return mergeRetries_; }
+
+        WorkerStats& operator += (const WorkerStats& other) {
+            iterations_ += other.iterations_;
+            validMotion_ += other.validMotion_;
+            nearest_ += other.nearest_;
+            edgeListRetries_ += other.edgeListRetries_;
+            mergeRetries_ += other.mergeRetries_;
+            return *this;
+        }
+
+        std::size_t iterations() const { return iterations_; }
+
+        // Calls fn(name, timer) for each timed phase of an iteration.
+        template <typename Fn>
+        void visitTimers(Fn&& fn) const {
+            fn("valid motion", validMotion_);
+            fn("nearest", nearest_);
+        }
+
+        void print() const {
+            MPT_LOG(INFO) << "iterations: " << iterations_;
+            MPT_LOG(INFO) << "valid motion: " << validMotion_;
+            MPT_LOG(INFO) << "nearest: " << nearest_;
+            MPT_LOG(INFO) << "edge list CAS: " << edgeListRetries_;
+            MPT_LOG(INFO) << "component merge CAS: " << mergeRetries_;
+        }
+    };
+
+    template <typename Scenario, int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
+    class PPRM : public PlannerBase<PPRM<Scenario, maxThreads, reportStats, statsSampleRate, NNStrategy>> {
         using Planner = PPRM;
         using Base = PlannerBase<PPRM>;
         using Space = scenario_space_t<Scenario>;
@@ -107,7 +167,7 @@ namespace unc::robotics::mpt::impl::pprm {
         void solutionFound() {
             bool wasSolved = solved_.load(std::memory_order_relaxed);
             if (!wasSolved && solved_.compare_exchange_strong(wasSolved, true, std::memory_order_relaxed))
-                MPT_LOG(INFO) << "solution found";
+                MPT_LOG_ASYNC(INFO) << "solution found";
         }
 
         // Functor used by shortest path algorithm
@@ -239,9 +299,33 @@ namespace unc::robotics::mpt::impl::pprm {
                 });
         }        
         
+        // Returns the estimated memory used by the planner, broken
+        // down by component.  This may be called while solving.
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            for (const Worker& w : workers_)
+                usage += w.memoryUsage();
+            usage.nearest = nearestMemoryUsage<Node*>(nn_);
+            return usage;
+        }
+
+        // Returns the statistics of all workers combined.  This
+        // requires report_stats<true>, and should only be called
+        // when not solving.
+        WorkerStats<true, statsSampleRate> stats() const {
+            static_assert(reportStats, "stats() requires report_stats<true>");
+            WorkerStats<true, statsSampleRate> stats;
+            for (unsigned i=0 ; i<workers_.size() ; ++i)
+                stats += workers_[i];
+            return stats;
+        }
+
         void printStats() const {
             MPT_LOG(INFO) << "nodes in graph: " << nn_.size();
+            MPT_LOG(INFO) << "memory: " << memoryUsage();
             // MPT_LOG(INFO) << "component count: " << componentCount_.load();
+            if constexpr (reportStats)
+                stats().print();
         }
 
         template <typename Visitor>
@@ -251,18 +335,25 @@ namespace unc::robotics::mpt::impl::pprm {
         }
     };
 
-    template <typename Scenario, int maxThreads, bool reportStats, typename NNStrategy>
-    class PPRM<Scenario, maxThreads, reportStats, NNStrategy>::Worker {
+    template <typename Scenario, int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
+    class PPRM<Scenario, maxThreads, reportStats, statsSampleRate, NNStrategy>::Worker
+        : public WorkerStats<reportStats, statsSampleRate>
+    {
+        using Stats = WorkerStats<reportStats, statsSampleRate>;
+
         unsigned no_;
         Scenario scenario_;
         RNG rng_;
 
         ObjectPool<Node> nodePool_;
-        ObjectPool<EdgePair> edgePool_;
-        ObjectPool<Component> componentPool_;
+        ObjectPool<EdgePair> edgePool_{AllocationSite::kEdges};
+        ObjectPool<Component> componentPool_{AllocationSite::kComponents};
 
         std::vector<std::tuple<Distance, Node*>> nbh_;
 
+        MemoryCounter trajectoryBytes_;
+        MemoryCounter scratchBytes_;
+
     public:
         Worker(Worker&& other)
             : no_(other.no_)
@@ -284,6 +375,16 @@ namespace unc::robotics::mpt::impl::pprm {
             return scenario_.space();
         }
 
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            usage.nodes = nodePool_.memoryUsage();
+            usage.edges = edgePool_.memoryUsage();
+            usage.components = componentPool_.memoryUsage();
+            usage.trajectories = trajectoryBytes_.load();
+            usage.scratch = scratchBytes_.load();
+            return usage;
+        }
+
         void sampleGoals(Planner& planner) {
             // TODO: more than one sample when appropriate
             scenario_goal_sampler_t<Scenario, RNG> goalSampler(scenario_);
@@ -301,7 +402,10 @@ namespace unc::robotics::mpt::impl::pprm {
 
             Distance logSizePlus1 = std::log(planner.nn_.size() + 1);
             int k = std::ceil(planner.kRRG_ * logSizePlus1);
-            planner.nn_.nearest(nbh_, q, k);
+            {
+                Timer timer(Stats::nearest());
+                planner.nn_.nearest(nbh_, q, k);
+            }
 
             Distance minDist = std::numeric_limits<Distance>::epsilon();
             if (!nbh_.empty() && std::get<Distance>(nbh_[0]) < minDist)
@@ -325,43 +429,59 @@ namespace unc::robotics::mpt::impl::pprm {
             for (auto [d, nbr] : nbh_) {
                 if (auto traj = validMotion(q, nbr->state())) {
                     EdgePair *pair = edgePool_.allocate(n, nbr, d, linkTrajectory(traj));
-                    Component *c0 = n->addEdge(pair->get(0));
-                    Component *c1 = nbr->addEdge(pair->get(1));
-                    Component *cm = merge(planner, c0, c1);
+                    trajectoryBytes_ += heapBytes(pair->link());
+                    Stats::edgeListRetries() += n->addEdge(pair->get(0));
+                    Stats::edgeListRetries() += nbr->addEdge(pair->get(1));
+                    Component *cm = merge(planner, n->component(), nbr->component());
 
                     if (cm->isSolution())
                         planner.solutionFound();
                 }
             }
 
+            scratchBytes_.update(nbh_.capacity() * sizeof(typename decltype(nbh_)::value_type));
+
+            AllocationScope scope(AllocationSite::kNearest);
             planner.nn_.insert(n);
             return n;
         }
 
         Component *merge(Planner& planner, Component *a, Component *b) {
+            unsigned casFailures = 0;
             Component *t;
-            do {
+            for (;;) {
                 while ((t = a->next()) != nullptr) a = t;
                 while ((t = b->next()) != nullptr) b = t;
-                if (a == b) return a; // same component already
+                if (a == b) {
+                    // same component already
+                    Stats::mergeRetries() += casFailures;
+                    return a;
+                }
                 if (a->size() > b->size())
                     std::swap(a, b);
                 assert(t == nullptr);
-            } while (!a->casNext(t, b, std::memory_order_relaxed));
+                if (a->casNext(t, b, std::memory_order_relaxed))
+                    break;
+                ++casFailures;
+            }
             
             // component merged
             // --planner.componentCount_;
 
             Component *m = componentPool_.allocate(a, b);
             while (!b->casNext(t, m, std::memory_order_relaxed)) {
+                ++casFailures;
                 while ((t = b->next()) != nullptr) b = t;
                 m->update(a, b);
             }
 
+            Stats::mergeRetries() += casFailures;
             return m;
         }
 
         decltype(auto) validMotion(const State& a, const State& b) {
+            Timer timer(Stats::validMotion());
+            AllocationScope scope(AllocationSite::kTrajectories);
             return scenario_.link(a, b);
         }
 
@@ -371,6 +491,7 @@ namespace unc::robotics::mpt::impl::pprm {
 
             Sampler sampler(scenario_);
             while (!done()) {
+                Stats::countIteration();
                 addSample(planner, sampler(rng_), Component::kNone);
             }
 
@@ -126,15 +126,21 @@ namespace unc::robotics::mpt::impl::pprm_irs {
         }
     };
 
+    // Pushes an edge onto the front of a lock-free intrusive edge
+    // list.  Returns the number of times the CAS had to be retried.
     template <typename Edge>
-    static void linkEdge(std::atomic<Edge*>& head, Edge *edge) {
+    static unsigned linkEdge(std::atomic<Edge*>& head, Edge *edge) {
+        unsigned retries = 0;
         Edge* oldHead = head.load(std::memory_order_relaxed);
-        do {
+        for (;;) {
             edge->setNext(oldHead, std::memory_order_relaxed);
-        } while (head.compare_exchange_weak(
-                     oldHead, edge,
-                     std::memory_order_release,
-                     std::memory_order_relaxed));
+            if (head.compare_exchange_weak(
+                    oldHead, edge,
+                    std::memory_order_release,
+                    std::memory_order_relaxed))
+                return retries;
+            ++retries;
+        }
     }
 }
 
@@ -65,8 +65,9 @@ namespace unc::robotics::mpt::impl::pprm_irs {
             return sparseHead_.load(order);
         }
 
-        void addSparseEdge(Edge *edge) {
-            linkEdge(sparseHead_, edge);
+        // returns the number of CAS retries
+        unsigned addSparseEdge(Edge *edge) {
+            return linkEdge(sparseHead_, edge);
         }
 
         Component *component() {
@@ -97,8 +98,9 @@ namespace unc::robotics::mpt::impl::pprm_irs {
     public:
         using NodeBase<State, Distance, Traj, true>::NodeBase;
 
-        void addDenseEdge(Edge *edge) {
-            linkEdge(denseHead_, edge);
+        // returns the number of CAS retries
+        unsigned addDenseEdge(Edge *edge) {
+            return linkEdge(denseHead_, edge);
         }
     };
 
@@ -44,19 +44,51 @@
 #include "../djikstras.hpp"
 #include "../goal_has_sampler.hpp"
 #include "../link_trajectory.hpp"
+#include "../memory_counter.hpp"
 #include "../object_pool.hpp"
 #include "../planner_base.hpp"
+#include "../retry_stat.hpp"
 #include "../scenario_goal.hpp"
 #include "../scenario_goal_sampler.hpp"
 #include "../scenario_link.hpp"
 #include "../scenario_rng.hpp"
 #include "../scenario_sampler.hpp"
 #include "../worker_pool.hpp"
+#include "../../memory_usage.hpp"
 #include "../../random_device_seed.hpp"
 #include <forward_list>
 #include <vector>
 
 namespace unc::robotics::mpt::impl::pprm_irs {
+    template <bool enable>
+    struct WorkerStats;
+
+    template <>
+    struct WorkerStats<false> {
+        auto& edgeListRetries() { return RetryStat<false>::instance(); }
+        auto& mergeRetries() { return RetryStat<false>::instance(); }
+    };
+
+    template <>
+    struct WorkerStats<true> {
+        mutable RetryStat<> edgeListRetries_;
+        mutable RetryStat<> mergeRetries_;
+
+        RetryStat<>& edgeListRetries() const { return edgeListRetries_; }
+        RetryStat<>& mergeRetries() const { return mergeRetries_; }
+
+        WorkerStats& operator += (const WorkerStats& other) {
+            edgeListRetries_ += other.edgeListRetries_;
+            mergeRetries_ += other.mergeRetries_;
+            return *this;
+        }
+
+        void print() const {
+            MPT_LOG(INFO) << "edge list CAS: " << edgeListRetries_;
+            MPT_LOG(INFO) << "component merge CAS: " << mergeRetries_;
+        }
+    };
+
     template <typename Scenario, int maxThreads, bool keepDense, bool reportStats, typename NNStrategy>
     class PPRMIRS : public PlannerBase<PPRMIRS<Scenario, maxThreads, keepDense, reportStats, NNStrategy>> {
         using Planner = PPRMIRS;
@@ -290,8 +322,25 @@ namespace unc::robotics::mpt::impl::pprm_irs {
         }
 #endif
         
+        // Returns the estimated memory used by the planner, broken
+        // down by component.  This may be called while solving.
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            for (const Worker& w : workers_)
+                usage += w.memoryUsage();
+            usage.nearest = nearestMemoryUsage<Node*>(nn_);
+            return usage;
+        }
+
         void printStats() const {
             MPT_LOG(INFO) << "nodes in graph: " << nn_.size();
+            MPT_LOG(INFO) << "memory: " << memoryUsage();
+            if constexpr (reportStats) {
+                WorkerStats<true> stats;
+                for (unsigned i=0 ; i<workers_.size() ; ++i)
+                    stats += workers_[i];
+                stats.print();
+            }
         }
 
         template <typename Visitor>
@@ -302,17 +351,24 @@ namespace unc::robotics::mpt::impl::pprm_irs {
     };
 
     template <typename Scenario, int maxThreads, bool keepDense, bool reportStats, typename NNStrategy>
-    class PPRMIRS<Scenario, maxThreads, keepDense, reportStats, NNStrategy>::Worker {
+    class PPRMIRS<Scenario, maxThreads, keepDense, reportStats, NNStrategy>::Worker
+        : public WorkerStats<reportStats>
+    {
+        using Stats = WorkerStats<reportStats>;
+
         unsigned no_;
         Scenario scenario_;
         RNG rng_;
 
         ObjectPool<Node> nodePool_;
-        ObjectPool<EdgePair> edgePool_;
-        ObjectPool<Component> componentPool_;
+        ObjectPool<EdgePair> edgePool_{AllocationSite::kEdges};
+        ObjectPool<Component> componentPool_{AllocationSite::kComponents};
 
         std::vector<std::tuple<Distance, Node*>> nbh_;
 
+        MemoryCounter trajectoryBytes_;
+        MemoryCounter scratchBytes_;
+
         ShortestPathCheck<Space, Traj, keepDense> shortestPathCheck_;
 
     public:
@@ -336,6 +392,16 @@ namespace unc::robotics::mpt::impl::pprm_irs {
             return scenario_.space();
         }
 
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            usage.nodes = nodePool_.memoryUsage();
+            usage.edges = edgePool_.memoryUsage();
+            usage.components = componentPool_.memoryUsage();
+            usage.trajectories = trajectoryBytes_.load();
+            usage.scratch = scratchBytes_.load();
+            return usage;
+        }
+
         void sampleGoals(Planner& planner) {
             // TODO: more than one sample when appropriate
             scenario_goal_sampler_t<Scenario, RNG> goalSampler(scenario_);
@@ -382,6 +448,11 @@ namespace unc::robotics::mpt::impl::pprm_irs {
                 if (auto link = validMotion(q, nbr->state()))
                     addEdge(planner, n, nbr, d, linkTrajectory(link));
 
+            scratchBytes_.store(
+                nbh_.capacity() * sizeof(typename decltype(nbh_)::value_type) +
+                shortestPathCheck_.memoryUsage());
+
+            AllocationScope scope(AllocationSite::kNearest);
             planner.nn_.insert(n);
             return n;
         }
@@ -391,12 +462,14 @@ namespace unc::robotics::mpt::impl::pprm_irs {
             if (shortestPathCheck_(from, to, stretchDist, scenario_.space())) {
                 // sparse
                 EdgePair *pair = edgePool_.allocate(from, to, d, std::move(traj));
-                from->addSparseEdge(pair->get(0));
-                to->addSparseEdge(pair->get(1));
+                trajectoryBytes_ += heapBytes(pair->link());
+                Stats::edgeListRetries() += from->addSparseEdge(pair->get(0));
+                Stats::edgeListRetries() += to->addSparseEdge(pair->get(1));
             } else if constexpr (keepDense) {
                 EdgePair *pair = edgePool_.allocate(from, to, d, std::move(traj));
-                from->addDenseEdge(pair->get(0));
-                to->addDenseEdge(pair->get(1));
+                trajectoryBytes_ += heapBytes(pair->link());
+                Stats::edgeListRetries() += from->addDenseEdge(pair->get(0));
+                Stats::edgeListRetries() += to->addDenseEdge(pair->get(1));
             } else {
                 return;
             }
@@ -407,26 +480,36 @@ namespace unc::robotics::mpt::impl::pprm_irs {
         }
 
         Component *merge(Component *a, Component *b) {
+            unsigned casFailures = 0;
             Component *t;
-            do {
+            for (;;) {
                 while ((t = a->next()) != nullptr) a = t;
                 while ((t = b->next()) != nullptr) b = t;
-                if (a == b) return a;
+                if (a == b) {
+                    Stats::mergeRetries() += casFailures;
+                    return a;
+                }
                 if (a->size() > b->size())
                     std::swap(a, b);
                 assert(t == nullptr);
-            } while (!a->casNext(t, b, std::memory_order_relaxed));
+                if (a->casNext(t, b, std::memory_order_relaxed))
+                    break;
+                ++casFailures;
+            }
 
             Component *m = componentPool_.allocate(a, b);
             while (!b->casNext(t, m, std::memory_order_relaxed)) {
+                ++casFailures;
                 while ((t = b->next()) != nullptr) b = t;
                 m->update(a, b);
             }
 
+            Stats::mergeRetries() += casFailures;
             return m;
         }
 
         decltype(auto) validMotion(const State& a, const State& b) {
+            AllocationScope scope(AllocationSite::kTrajectories);
             return scenario_.link(a, b);
         }
 
@@ -93,6 +93,19 @@ namespace unc::robotics::mpt::impl::pprm_irs {
             updateQueue(u, 0);
         }
 
+        // Estimated memory used by the path cost map and queue.  The
+        // map retains an entry for every node that the check has
+        // visited.
+        std::size_t memoryUsage() const {
+            struct HashNode {
+                void *next_;
+                std::pair<const Node*, PathCost> value_;
+            };
+            return pathCosts_.bucket_count() * sizeof(void*)
+                + pathCosts_.size() * sizeof(HashNode)
+                + pathQueue_.capacity() * sizeof(QueueItem);
+        }
+
         void updateQueue(const Node *n, Distance cost) {
             pathCosts_[n] = { cost, iter_ };
             // auto entry = pathCosts_.find(n);
@@ -0,0 +1,127 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+#pragma once
+#ifndef MPT_IMPL_PROGRESS_REPORTER_HPP
+#define MPT_IMPL_PROGRESS_REPORTER_HPP
+
+#include "../progress.hpp"
+#include <chrono>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace unc::robotics::mpt::impl {
+    // Holds a planner's progress callback and its interval.
+    //
+    // The planners report progress by wrapping the done predicate
+    // passed to the first worker (the one running on the thread that
+    // called solve()).  The first worker calls the predicate once per
+    // iteration, thus the wrapper can check the time and call the
+    // callback, without the other workers doing anything different.
+    template <typename Distance>
+    class ProgressReporter {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using Callback = std::function<bool(const Progress<Distance>&)>;
+
+    private:
+        Callback callback_;
+        Clock::duration interval_{};
+
+    public:
+        // The callback may either return void, or return bool, in
+        // which case returning true stops the solve.
+        template <typename Fn, typename Rep, typename Period>
+        void set(Fn&& fn, const std::chrono::duration<Rep, Period>& interval) {
+            using Result = std::invoke_result_t<Fn, const Progress<Distance>&>;
+            if constexpr (std::is_same_v<bool, Result>) {
+                callback_ = std::forward<Fn>(fn);
+            } else {
+                callback_ = [fn = std::forward<Fn>(fn)] (const Progress<Distance>& progress) {
+                    fn(progress);
+                    return false;
+                };
+            }
+            interval_ = std::chrono::duration_cast<Clock::duration>(interval);
+        }
+
+        void clear() {
+            callback_ = nullptr;
+        }
+
+        explicit operator bool () const {
+            return static_cast<bool>(callback_);
+        }
+
+        // Returns a done predicate that calls doneFn and reports
+        // progress once per interval.  Snapshot is called with a
+        // Progress to fill in the planner-specific size and best
+        // cost.
+        template <typename DoneFn, typename Snapshot>
+        auto wrap(DoneFn doneFn, Snapshot snapshot, Clock::time_point start) const {
+            Progress<Distance> initial;
+            snapshot(initial);
+
+            return [&callback = callback_, interval = interval_, doneFn, snapshot, start,
+                    next = start + interval_, prevTime = start, prevSize = initial.size,
+                    iterations = std::size_t(0)] () mutable -> bool
+            {
+                ++iterations;
+                if (doneFn())
+                    return true;
+
+                Clock::time_point now = Clock::now();
+                if (now < next)
+                    return false;
+
+                Progress<Distance> progress;
+                progress.elapsed = now - start;
+                progress.iterations = iterations;
+                snapshot(progress);
+                progress.samplesPerSecond = (progress.size - prevSize)
+                    / std::chrono::duration<double>(now - prevTime).count();
+
+                prevTime = now;
+                prevSize = progress.size;
+                next = now + interval;
+
+                return callback(progress);
+            };
+        }
+    };
+}
+
+#endif
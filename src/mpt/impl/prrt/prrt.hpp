@@ -42,8 +42,10 @@
 #include "../atom.hpp"
 #include "../goal_has_sampler.hpp"
 #include "../link_trajectory.hpp"
+#include "../memory_counter.hpp"
 #include "../object_pool.hpp"
 #include "../planner_base.hpp"
+#include "../progress_reporter.hpp"
 #include "../scenario_goal.hpp"
 #include "../scenario_goal_sampler.hpp"
 #include "../scenario_link.hpp"
@@ -52,37 +54,42 @@
 #include "../scenario_space.hpp"
 #include "../timer_stat.hpp"
 #include "../worker_pool.hpp"
+#include "../../async_log.hpp"
 #include "../../log.hpp"
+#include "../../memory_usage.hpp"
 #include "../../random_device_seed.hpp"
 #include <forward_list>
 #include <mutex>
+#include <new>
 #include <utility>
 
 namespace unc::robotics::mpt::impl::prrt {
 
-    template <bool enable>
+    template <bool enable, int sampleRate>
     struct WorkerStats;
 
-    template <>
-    struct WorkerStats<false> {
+    template <int sampleRate>
+    struct WorkerStats<false, sampleRate> {
         void countIteration() const {}
         void countBiasedSample() const {}
         auto& validMotion() { return TimerStat<void>::instance(); }
         auto& nearest() { return TimerStat<void>::instance(); }
     };
 
-    template <>
-    struct WorkerStats<true> {
+    template <int sampleRate>
+    struct WorkerStats<true, sampleRate> {
+        using TimeStat = TimerStat<std::chrono::steady_clock, sampleRate>;
+
         mutable std::size_t iterations_{0};
         mutable std::size_t biasedSamples_{0};
-        mutable TimerStat<> validMotion_;
-        mutable TimerStat<> nearest_;
+        mutable TimeStat validMotion_;
+        mutable TimeStat nearest_;
 
         void countIteration() const { ++iterations_; }
         void countBiasedSample() const { ++biasedSamples_; }
 
-        TimerStat<>& validMotion() const { return validMotion_; }
-        TimerStat<>& nearest() const { return nearest_; }
+        TimeStat& validMotion() const { return validMotion_; }
+        TimeStat& nearest() const { return nearest_; }
 
         WorkerStats& operator += (const WorkerStats& other) {
             iterations_ += other.iterations_;
@@ -92,6 +99,15 @@ namespace unc::robotics::mpt::impl::prrt {
             return *this;
         }
 
+        std::size_t iterations() const { return iterations_; }
+
+        // Calls fn(name, timer) for each timed phase of an iteration.
+        template <typename Fn>
+        void visitTimers(Fn&& fn) const {
+            fn("valid motion", validMotion_);
+            fn("nearest", nearest_);
+        }
+
         void print() const {
             MPT_LOG(INFO) << "iterations: " << iterations_;
             MPT_LOG(INFO) << "biased samples: " << biasedSamples_;
@@ -100,8 +116,8 @@ namespace unc::robotics::mpt::impl::prrt {
         }
     };
 
-    template <typename Scenario, int maxThreads, bool reportStats, typename NNStrategy>
-    class PRRT : public PlannerBase<PRRT<Scenario, maxThreads, reportStats, NNStrategy>> {
+    template <typename Scenario, int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
+    class PRRT : public PlannerBase<PRRT<Scenario, maxThreads, reportStats, statsSampleRate, NNStrategy>> {
         using Planner = PRRT;
         using Base = PlannerBase<Planner>;
         using Space = scenario_space_t<Scenario>;
@@ -119,9 +135,10 @@ namespace unc::robotics::mpt::impl::prrt {
 
         static constexpr bool concurrent = maxThreads != 1;
         using NNConcurrency = std::conditional_t<concurrent, nigh::Concurrent, nigh::NoThreadSafety>;
-        nigh::Nigh<Node*, Space, NodeKey, NNConcurrency, NNStrategy> nn_;
+        using NN = nigh::Nigh<Node*, Space, NodeKey, NNConcurrency, NNStrategy>;
+        NN nn_;
 
-        std::mutex mutex_;
+        mutable std::mutex mutex_;
         std::forward_list<Node*> goals_;
 
         // we could use goals_.size(), but the performance of check if
@@ -136,8 +153,10 @@ namespace unc::robotics::mpt::impl::prrt {
 
         WorkerPool<Worker, maxThreads> workers_;
 
+        ProgressReporter<Distance> progress_;
+
         void foundGoal(Node* node) {
-            MPT_LOG(INFO) << "found solution";
+            MPT_LOG_ASYNC(INFO) << "found solution";
             {
                 std::lock_guard<std::mutex> lock(mutex_);
                 goals_.push_front(node);
@@ -183,9 +202,45 @@ namespace unc::robotics::mpt::impl::prrt {
             std::lock_guard<std::mutex> lock(mutex_);
             Node *node = startNodes_.allocate(Traj{}, nullptr, std::forward<Args>(args)...);
             // TODO: workers_[0].connect(node);
+            AllocationScope scope(AllocationSite::kNearest);
             nn_.insert(node);
         }
 
+        // Sets a callback to be called with a Progress snapshot once
+        // every interval while solving.  The callback is called from
+        // the thread that called solve().  If the callback returns
+        // bool, returning true stops the solve.
+        template <typename Fn, typename Rep, typename Period>
+        void setProgressCallback(Fn&& fn, const std::chrono::duration<Rep, Period>& interval) {
+            progress_.set(std::forward<Fn>(fn), interval);
+        }
+
+        void clearProgressCallback() {
+            progress_.clear();
+        }
+
+        // Discards the graph, the solutions, and the statistics, and
+        // reseeds the workers, while keeping the settings and each
+        // worker's copy of the scenario.  This allows a planner to be
+        // reused for many trials without the cost of constructing it
+        // each time.  Start states must be added again before the
+        // next solve.  This must not be called while solving.
+        template <typename RNGSeed = RandomDeviceSeed<>>
+        void reset(const RNGSeed& seed = RNGSeed()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            goals_.clear();
+            goalCount_.store(0);
+
+            // nigh does not support removal, so the nearest neighbor
+            // structure is reconstructed in place.
+            nn_.~NN();
+            new (&nn_) NN(workers_[0].space());
+
+            startNodes_.clear();
+            for (Worker& w : workers_)
+                w.reset(seed);
+        }
+
         // required to get convenience methods
         using Base::solveFor;
         using Base::solveUntil;
@@ -197,7 +252,15 @@ namespace unc::robotics::mpt::impl::prrt {
             if (size() == 0)
                 throw std::runtime_error("there are no valid initial states");
 
-            workers_.solve(*this, doneFn);
+            if (progress_) {
+                workers_.solve(*this, progress_.wrap(doneFn, [&] (Progress<Distance>& progress) {
+                    progress.size = size();
+                    if (const Node *goal = bestSolution().first)
+                        progress.bestCost = pathCost(goal).first;
+                }, std::chrono::steady_clock::now()));
+            } else {
+                workers_.solve(*this, doneFn);
+            }
         }
 
         bool solved() const {
@@ -222,6 +285,8 @@ namespace unc::robotics::mpt::impl::prrt {
             Distance bestCost = std::numeric_limits<Distance>::infinity();
             std::size_t bestSize = 0;
             const Node* bestGoal = nullptr;
+            // goals_ may be concurrently modified while solving
+            std::lock_guard<std::mutex> lock(mutex_);
             for (const Node *goal : goals_) {
                 auto [cost, size] = pathCost(goal);
                 if (cost < bestCost || bestGoal == nullptr) {
@@ -284,17 +349,36 @@ namespace unc::robotics::mpt::impl::prrt {
                 solutionRecur(goal, fn);
         }
 
+        // Returns the estimated memory used by the planner, broken
+        // down by component.  This may be called while solving.
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            usage.nodes = startNodes_.memoryUsage();
+            for (const Worker& w : workers_)
+                usage += w.memoryUsage();
+            usage.nearest = nearestMemoryUsage<Node*>(nn_);
+            return usage;
+        }
+
+        // Returns the statistics of all workers combined.  This
+        // requires report_stats<true>, and should only be called
+        // when not solving.
+        WorkerStats<true, statsSampleRate> stats() const {
+            static_assert(reportStats, "stats() requires report_stats<true>");
+            WorkerStats<true, statsSampleRate> stats;
+            for (unsigned i=0 ; i<workers_.size() ; ++i)
+                stats += workers_[i];
+            return stats;
+        }
+
         void printStats() const {
             MPT_LOG(INFO) << "nodes in graph: " << nn_.size();
+            MPT_LOG(INFO) << "memory: " << memoryUsage();
             auto [cost, size] = bestSolution();
             MPT_LOG(INFO) << "solutions: " << goalCount_.load() << ", best cost=" << cost
                           << " over " << size << " waypoints";
-            if constexpr (reportStats) {
-                WorkerStats<true> stats;
-                for (unsigned i=0 ; i<workers_.size() ; ++i)
-                    stats += workers_[i];
-                stats.print();
-            }
+            if constexpr (reportStats)
+                stats().print();
         }
 
     private:
@@ -316,11 +400,11 @@ namespace unc::robotics::mpt::impl::prrt {
         }
     };
 
-    template <typename Scenario, int maxThreads, bool reportStats, typename NNStrategy>
-    class PRRT<Scenario, maxThreads, reportStats, NNStrategy>::Worker
-        : public WorkerStats<reportStats>
+    template <typename Scenario, int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
+    class PRRT<Scenario, maxThreads, reportStats, statsSampleRate, NNStrategy>::Worker
+        : public WorkerStats<reportStats, statsSampleRate>
     {
-        using Stats = WorkerStats<reportStats>;
+        using Stats = WorkerStats<reportStats, statsSampleRate>;
 
         unsigned no_;
         Scenario scenario_;
@@ -328,6 +412,8 @@ namespace unc::robotics::mpt::impl::prrt {
 
         ObjectPool<Node> nodePool_;
 
+        MemoryCounter trajectoryBytes_;
+
     public:
         Worker(Worker&& other)
             : no_(other.no_)
@@ -355,6 +441,21 @@ namespace unc::robotics::mpt::impl::prrt {
             return nodePool_;
         }
 
+        template <typename RNGSeed>
+        void reset(const RNGSeed& seed) {
+            static_cast<Stats&>(*this) = Stats();
+            rng_ = RNG(seed);
+            nodePool_.clear();
+            trajectoryBytes_.store(0);
+        }
+
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            usage.nodes = nodePool_.memoryUsage();
+            usage.trajectories = trajectoryBytes_.load();
+            return usage;
+        }
+
         template <typename DoneFn>
         void solve(Planner& planner, DoneFn done) {
             MPT_LOG(TRACE) << "worker running";
@@ -444,7 +545,11 @@ namespace unc::robotics::mpt::impl::prrt {
                 (void)goalDist; // mark unused (for now, may be used in approx solutions)
 
                 Node* newNode = nodePool_.allocate(linkTrajectory(traj), nearNode, newState);
-                planner.nn_.insert(newNode);
+                trajectoryBytes_ += heapBytes(newNode->edge().link());
+                {
+                    AllocationScope scope(AllocationSite::kNearest);
+                    planner.nn_.insert(newNode);
+                }
 
                 if (isGoal)
                     planner.foundGoal(newNode);
@@ -453,6 +558,7 @@ namespace unc::robotics::mpt::impl::prrt {
 
         decltype(auto) validMotion(const State& a, const State& b) {
             Timer timer(Stats::validMotion());
+            AllocationScope scope(AllocationSite::kTrajectories);
             return scenario_.link(a, b);
         }
     };
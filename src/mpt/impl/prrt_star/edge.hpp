@@ -60,14 +60,19 @@ namespace unc::robotics::mpt::impl::prrt_star {
         std::atomic<Edge*> firstChild_{nullptr};
         std::atomic<Edge*> nextSibling_{nullptr};
 
-        void addChild(Edge* child) {
+        // returns the number of times the CAS had to be retried.
+        unsigned addChild(Edge* child) {
+            unsigned retries = 0;
             Edge *next = firstChild_.load(std::memory_order_relaxed);
-            do {
+            for (;;) {
                 child->nextSibling_.store(next, std::memory_order_relaxed);
-            } while (!firstChild_.compare_exchange_weak(
-                         next, child,
-                         std::memory_order_release,
-                         std::memory_order_relaxed));
+                if (firstChild_.compare_exchange_weak(
+                        next, child,
+                        std::memory_order_release,
+                        std::memory_order_relaxed))
+                    return retries;
+                ++retries;
+            }
         }
         
     public:
@@ -88,7 +93,6 @@ namespace unc::robotics::mpt::impl::prrt_star {
             , parent_(parent)
             , cost_(cost)
         {
-            parent->addChild(this);
         }
 
         Edge(const Edge& old, Node *node, Edge *parent, Distance cost)
@@ -97,7 +101,6 @@ namespace unc::robotics::mpt::impl::prrt_star {
             , parent_(parent)
             , cost_(cost)
         {
-            parent->addChild(this);
         }
 
         Node* node() {
@@ -116,6 +119,16 @@ namespace unc::robotics::mpt::impl::prrt_star {
             return parent_;
         }
 
+        // Adds this edge to its parent's list of children.  This is
+        // separate from construction so that the caller can account
+        // for the contention on the parent's child list.  It must be
+        // called before the edge is published with Node::casEdge.
+        // Returns the number of CAS retries.
+        unsigned addToParent() {
+            assert(parent_ != nullptr);
+            return parent_->addChild(this);
+        }
+
         Edge *firstChild(std::memory_order order) {
             return firstChild_.load(order);
         }
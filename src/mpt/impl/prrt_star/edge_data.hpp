@@ -38,6 +38,7 @@
 #define MPT_IMPL_PRRT_STAR_EDGE_DATA_HPP
 
 #include "node.hpp"
+#include "../memory_counter.hpp"
 #include <atomic>
 #include <cassert>
 #include <variant>
@@ -50,6 +51,10 @@ namespace unc::robotics::mpt::impl::prrt_star {
     // 
     // The non-concurrent version of RRT* uses ScenarioLinkStore as it
     // does not make copies.
+    //
+    // payloadBytes() returns the heap memory of the stored link.
+    // Copies of an edge share the same payload, thus it should only
+    // be counted for the edge that was created from the link() call.
     template <typename T>
     class EdgeData {
         std::shared_ptr<T> link_;
@@ -62,6 +67,10 @@ namespace unc::robotics::mpt::impl::prrt_star {
         const T& link() const {
             return *link_;
         }
+
+        std::size_t payloadBytes() const {
+            return sizeof(T) + heapBytes(*link_);
+        }
     };
 
     // When link() returns a bool, there's nothing to store.
@@ -73,6 +82,10 @@ namespace unc::robotics::mpt::impl::prrt_star {
         std::monostate link() const {
             return {};
         }
+
+        std::size_t payloadBytes() const {
+            return 0;
+        }
     };
 
     // When link() returns a pointer, we have no additional reference
@@ -87,6 +100,10 @@ namespace unc::robotics::mpt::impl::prrt_star {
         const T* link() const {
             return link_;
         }
+
+        std::size_t payloadBytes() const {
+            return 0;
+        }
     };
 
     // When link() returns a shared_ptr<T>, we also store a shared
@@ -101,6 +118,10 @@ namespace unc::robotics::mpt::impl::prrt_star {
         const std::shared_ptr<T>& link() const {
             return link_;
         }
+
+        std::size_t payloadBytes() const {
+            return heapBytes(link_);
+        }
     };
 
     // For the std::unique_ptr<T> case, we need to keep multiple
@@ -117,6 +138,10 @@ namespace unc::robotics::mpt::impl::prrt_star {
         const T* link() const {
             return link_->get();
         }
+
+        std::size_t payloadBytes() const {
+            return heapBytes(link_);
+        }
     };
 
     // TODO:
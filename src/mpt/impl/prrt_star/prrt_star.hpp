@@ -44,8 +44,11 @@
 #include "../constants.hpp"
 #include "../goal_has_sampler.hpp"
 #include "../link_trajectory.hpp"
+#include "../memory_counter.hpp"
 #include "../object_pool.hpp"
 #include "../planner_base.hpp"
+#include "../progress_reporter.hpp"
+#include "../retry_stat.hpp"
 #include "../rrg_rewire_neighbors.hpp"
 #include "../scenario_goal.hpp"
 #include "../scenario_goal_sampler.hpp"
@@ -55,11 +58,14 @@
 #include "../scenario_space.hpp"
 #include "../timer_stat.hpp"
 #include "../worker_pool.hpp"
+#include "../../async_log.hpp"
 #include "../../log.hpp"
+#include "../../memory_usage.hpp"
 #include "../../random_device_seed.hpp"
 #include <nigh/nigh_forward.hpp>
 #include <forward_list>
 #include <mutex>
+#include <new>
 #include <omp.h>
 #include <optional>
 #include <queue>
@@ -102,11 +108,11 @@ namespace unc::robotics::mpt::impl::prrt_star {
     //     }
     // };
 
-    template <bool enable>
+    template <bool enable, int sampleRate>
     struct WorkerStats;
 
-    template <>
-    struct WorkerStats<false> {
+    template <int sampleRate>
+    struct WorkerStats<false, sampleRate> {
         void iteration() const {}
         void biasedSample() const {}
         void rewireTests(std::size_t) const {}
@@ -114,25 +120,36 @@ namespace unc::robotics::mpt::impl::prrt_star {
         auto& validMotion() { return TimerStat<void>::instance(); }
         auto& nearest1() { return TimerStat<void>::instance(); }
         auto& nearestK() { return TimerStat<void>::instance(); }
+        auto& edgeRetries() { return RetryStat<false>::instance(); }
+        auto& childRetries() { return RetryStat<false>::instance(); }
+        auto& solutionRetries() { return RetryStat<false>::instance(); }
     };
 
-    template <>
-    struct WorkerStats<true> {
+    template <int sampleRate>
+    struct WorkerStats<true, sampleRate> {
+        using TimeStat = TimerStat<std::chrono::steady_clock, sampleRate>;
+
         mutable std::size_t iterations_{0};
         mutable std::size_t biasedSamples_{0};
         mutable std::size_t rewireTests_{0};
         mutable std::size_t rewireCount_{0};
-        mutable TimerStat<> validMotion_;
-        mutable TimerStat<> nearest1_;
-        mutable TimerStat<> nearestK_;
+        mutable TimeStat validMotion_;
+        mutable TimeStat nearest1_;
+        mutable TimeStat nearestK_;
+        mutable RetryStat<> edgeRetries_;
+        mutable RetryStat<> childRetries_;
+        mutable RetryStat<> solutionRetries_;
 
         void iteration() const { ++iterations_; };
         void biasedSample() const { ++biasedSamples_; }
         void rewireTests(std::size_t n) const { rewireTests_ += n; }
         void rewireCount() const { ++rewireCount_; }
-        TimerStat<>& validMotion() const { return validMotion_; }
-        TimerStat<>& nearest1() const { return nearest1_; }
-        TimerStat<>& nearestK() const { return nearestK_; }
+        TimeStat& validMotion() const { return validMotion_; }
+        TimeStat& nearest1() const { return nearest1_; }
+        TimeStat& nearestK() const { return nearestK_; }
+        RetryStat<>& edgeRetries() const { return edgeRetries_; }
+        RetryStat<>& childRetries() const { return childRetries_; }
+        RetryStat<>& solutionRetries() const { return solutionRetries_; }
 
         WorkerStats& operator += (const WorkerStats& other) {
             iterations_ += other.iterations_;
@@ -142,9 +159,22 @@ namespace unc::robotics::mpt::impl::prrt_star {
             validMotion_ += other.validMotion_;
             nearest1_ += other.nearest1_;
             nearestK_ += other.nearestK_;
+            edgeRetries_ += other.edgeRetries_;
+            childRetries_ += other.childRetries_;
+            solutionRetries_ += other.solutionRetries_;
             return *this;
         }
 
+        std::size_t iterations() const { return iterations_; }
+
+        // Calls fn(name, timer) for each timed phase of an iteration.
+        template <typename Fn>
+        void visitTimers(Fn&& fn) const {
+            fn("valid motion", validMotion_);
+            fn("nearest 1", nearest1_);
+            fn("nearest K", nearestK_);
+        }
+
         void print() const {
             MPT_LOG(INFO) << "iterations: " << iterations_;
             MPT_LOG(INFO) << "biased samples: " << biasedSamples_;
@@ -152,11 +182,14 @@ namespace unc::robotics::mpt::impl::prrt_star {
             MPT_LOG(INFO) << "valid motion: " << validMotion_;
             MPT_LOG(INFO) << "nearest 1: " << nearest1_;
             MPT_LOG(INFO) << "nearest K: " << nearestK_;
+            MPT_LOG(INFO) << "edge CAS: " << edgeRetries_;
+            MPT_LOG(INFO) << "child list CAS: " << childRetries_;
+            MPT_LOG(INFO) << "solution CAS: " << solutionRetries_;
         }
     };
 
-    template <typename Scenario, int maxThreads, class Rewire, bool reportStats, typename NNStrategy>
-    class PRRTStar : public PlannerBase<PRRTStar<Scenario, maxThreads, Rewire, reportStats, NNStrategy>> {
+    template <typename Scenario, int maxThreads, class Rewire, bool reportStats, int statsSampleRate, typename NNStrategy>
+    class PRRTStar : public PlannerBase<PRRTStar<Scenario, maxThreads, Rewire, reportStats, statsSampleRate, NNStrategy>> {
         using Planner = PRRTStar;
         using Base = PlannerBase<Planner>;
         using Space = scenario_space_t<Scenario>;
@@ -180,7 +213,8 @@ namespace unc::robotics::mpt::impl::prrt_star {
         std::size_t maxGoals_{1};
 
         using NNConcurrency = std::conditional_t<concurrent, nigh::Concurrent, nigh::NoThreadSafety>;
-        nigh::Nigh<Node*, Space, NodeKey, NNConcurrency, NNStrategy> nn_;
+        using NN = nigh::Nigh<Node*, Space, NodeKey, NNConcurrency, NNStrategy>;
+        NN nn_;
 
         alignas(concurrent ? 64 : 0)
         Atom<Edge*, concurrent> solution_{nullptr};
@@ -189,7 +223,7 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
         std::mutex startNodeMutex_;
         ObjectPool<Node, false> startNodes_;
-        ObjectPool<Edge, false> startEdges_;
+        ObjectPool<Edge, false> startEdges_{AllocationSite::kEdges};
 
         struct Worker;
 
@@ -197,24 +231,30 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
         Clock::time_point solveStartTime_;
 
+        ProgressReporter<Distance> progress_;
+
         auto elapsedSolveTime() const {
             return Clock::now() - solveStartTime_;
         }
 
-        void foundGoal(Edge *edge, Distance) {
+        template <typename Retries>
+        void foundGoal(Edge *edge, Distance, Retries& retries) {
             ++goalCount_;
-            MPT_LOG(DEBUG) << "added goal";
+            MPT_LOG_ASYNC(DEBUG) << "added goal";
+            unsigned casFailures = 0;
             Edge *prevSolution = solution_.load(std::memory_order_acquire);
             while (prevSolution == nullptr || edge->cost() < prevSolution->cost()) {
                 if (solution_.compare_exchange_weak(prevSolution, edge)) {
-                    MPT_LOG(INFO) << (prevSolution
-                                      ? "new solution found with cost "
-                                      : "found initial solution with cost ")
-                                  << edge->cost()
-                                  << ", after " << elapsedSolveTime();
+                    MPT_LOG_ASYNC(INFO) << (prevSolution
+                                            ? "new solution found with cost "
+                                            : "found initial solution with cost ")
+                                        << edge->cost()
+                                        << ", after " << elapsedSolveTime();
                     break;
                 }
+                ++casFailures;
             }
+            retries += casFailures;
         }
 
     public:
@@ -275,9 +315,45 @@ namespace unc::robotics::mpt::impl::prrt_star {
                 node = startNodes_.allocate(false, std::forward<Args>(args)...);
             }
 
+            AllocationScope scope(AllocationSite::kNearest);
             nn_.insert(node);
         }
 
+        // Sets a callback to be called with a Progress snapshot once
+        // every interval while solving.  The callback is called from
+        // the thread that called solve().  If the callback returns
+        // bool, returning true stops the solve.
+        template <typename Fn, typename Rep, typename Period>
+        void setProgressCallback(Fn&& fn, const std::chrono::duration<Rep, Period>& interval) {
+            progress_.set(std::forward<Fn>(fn), interval);
+        }
+
+        void clearProgressCallback() {
+            progress_.clear();
+        }
+
+        // Discards the graph, the solutions, and the statistics, and
+        // reseeds the workers, while keeping the settings and each
+        // worker's copy of the scenario.  Start states must be added
+        // again before the next solve.  This must not be called while
+        // solving.
+        template <typename RNGSeed = RandomDeviceSeed<>>
+        void reset(const RNGSeed& seed = RNGSeed()) {
+            std::lock_guard<std::mutex> lock(startNodeMutex_);
+            solution_.store(nullptr);
+            goalCount_.store(0);
+
+            // nigh does not support removal, so the nearest neighbor
+            // structure is reconstructed in place.
+            nn_.~NN();
+            new (&nn_) NN(workers_[0].space());
+
+            startNodes_.clear();
+            startEdges_.clear();
+            for (Worker& w : workers_)
+                w.reset(seed);
+        }
+
         // required to get convenience methods
         using Base::solveFor;
         using Base::solveUntil;
@@ -297,7 +373,15 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
             solveStartTime_ = Clock::now();
 
-            workers_.solve(*this, doneFn);
+            if (progress_) {
+                workers_.solve(*this, progress_.wrap(doneFn, [&] (Progress<Distance>& progress) {
+                    progress.size = size();
+                    if (Edge *solution = solution_.load(std::memory_order_acquire))
+                        progress.bestCost = solution->cost();
+                }, solveStartTime_));
+            } else {
+                workers_.solve(*this, doneFn);
+            }
 
             if constexpr (reportStats) {
                 MPT_LOG(DEBUG) << "final rewire: " << rewireNeighbors_.stats(nn_.size());
@@ -362,14 +446,34 @@ namespace unc::robotics::mpt::impl::prrt_star {
                 solutionRecur(edge, fn);
         }
 
+        // Returns the estimated memory used by the planner, broken
+        // down by component.  This may be called while solving.
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            usage.nodes = startNodes_.memoryUsage();
+            usage.edges = startEdges_.memoryUsage();
+            for (const Worker& w : workers_)
+                usage += w.memoryUsage();
+            usage.nearest = nearestMemoryUsage<Node*>(nn_);
+            return usage;
+        }
+
+        // Returns the statistics of all workers combined.  This
+        // requires report_stats<true>, and should only be called
+        // when not solving.
+        WorkerStats<true, statsSampleRate> stats() const {
+            static_assert(reportStats, "stats() requires report_stats<true>");
+            WorkerStats<true, statsSampleRate> stats;
+            for (unsigned i=0 ; i<workers_.size() ; ++i)
+                stats += workers_[i];
+            return stats;
+        }
+
         void printStats() const {
             MPT_LOG(INFO) << "nodes in graph: " << nn_.size();
-            if constexpr (reportStats) {
-                WorkerStats<true> stats;
-                for (unsigned i=0 ; i<workers_.size() ; ++i)
-                    stats += workers_[i];
-                stats.print();
-            }
+            MPT_LOG(INFO) << "memory: " << memoryUsage();
+            if constexpr (reportStats)
+                stats().print();
         }
 
     private:
@@ -393,22 +497,25 @@ namespace unc::robotics::mpt::impl::prrt_star {
         }
     };
 
-    template <typename Scenario, int maxThreads, class Rewire, bool reportStats, typename NNStrategy>
-    class PRRTStar<Scenario, maxThreads, Rewire, reportStats, NNStrategy>::Worker
-        : public WorkerStats<reportStats>
+    template <typename Scenario, int maxThreads, class Rewire, bool reportStats, int statsSampleRate, typename NNStrategy>
+    class PRRTStar<Scenario, maxThreads, Rewire, reportStats, statsSampleRate, NNStrategy>::Worker
+        : public WorkerStats<reportStats, statsSampleRate>
     {
-        using Stats = WorkerStats<reportStats>;
+        using Stats = WorkerStats<reportStats, statsSampleRate>;
 
         unsigned no_;
         Scenario scenario_;
         RNG rng_;
 
         ObjectPool<Node> nodes_;
-        ObjectPool<Edge> edges_;
+        ObjectPool<Edge> edges_{AllocationSite::kEdges};
 
         std::vector<std::tuple<Node*, Distance>> nbh_;
         std::vector<std::tuple<Edge*, std::size_t>> edgeIndices_;
 
+        MemoryCounter trajectoryBytes_;
+        MemoryCounter scratchBytes_;
+
     public:
         Worker(Worker&& other)
             : scenario_(other.scenario_)
@@ -437,15 +544,28 @@ namespace unc::robotics::mpt::impl::prrt_star {
             return nodes_;
         }
 
+        template <typename RNGSeed>
+        void reset(const RNGSeed& seed) {
+            static_cast<Stats&>(*this) = Stats();
+            rng_ = RNG(seed);
+            nodes_.clear();
+            edges_.clear();
+            trajectoryBytes_.store(0);
+        }
+
+        MemoryUsage memoryUsage() const {
+            MemoryUsage usage;
+            usage.nodes = nodes_.memoryUsage();
+            usage.edges = edges_.memoryUsage();
+            usage.trajectories = trajectoryBytes_.load();
+            usage.scratch = scratchBytes_.load();
+            return usage;
+        }
+
         template <typename DoneFn>
         void solve(Planner& planner, DoneFn done) {
             MPT_LOG(TRACE) << "worker running";
 
-            // TODO: add "progress_interval<T>" tag, where T is a duration.
-            //
-            // using namespace std::literals;
-            // typename Clock::duration nextProgress = 1s;
-
             Sampler sampler(scenario_);
             if constexpr (scenario_has_goal_sampler_v<Scenario, RNG>) {
                 if (no_ == 0 && planner.goalBias_ > 0) {
@@ -461,10 +581,6 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
                     while (!done()) {
                         Stats::iteration();
-                        // if ((Clock::now() - planner.solveStartTime_) > nextProgress) {
-                        //     MPT_LOG(TRACE) << "size = " << planner.size() << ", biased samples = " << Stats::biasedSamples();
-                        //     nextProgress += 1s;
-                        // }
 
                         if (planner.goalCount_.load(std::memory_order_relaxed) >= 1)
                             goto unbiasedSamplingLoop;
@@ -554,6 +670,9 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
             Stats::rewireTests(nbh_.size());
             edgeIndices_.resize(nbh_.size());
+            scratchBytes_.update(
+                nbh_.capacity() * sizeof(typename decltype(nbh_)::value_type) +
+                edgeIndices_.capacity() * sizeof(typename decltype(edgeIndices_)::value_type));
             for (std::size_t i=0 ; i<nbh_.size() ; ++i)
                 edgeIndices_[i] = { std::get<Node*>(nbh_[i])->edge(std::memory_order_relaxed), i };
 
@@ -600,17 +719,22 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
             if constexpr (concurrent) {
                 newNode = nodes_.allocate(isGoal, newState);
-                newEdge = edges_.allocate(linkTrajectory(traj), newNode, parent, parentCost);
+                newEdge = allocateEdge(linkTrajectory(traj), newNode, parent, parentCost);
+                trajectoryBytes_ += newEdge->payloadBytes();
                 setEdge(planner, newNode, newEdge);
             } else {
                 newNode = nodes_.allocate(linkTrajectory(traj), parent, parentCost, isGoal, newState);
                 newEdge = newNode->edge();
+                trajectoryBytes_ += heapBytes(newEdge->link());
             }
 
-            planner.nn_.insert(newNode);
+            {
+                AllocationScope scope(AllocationSite::kNearest);
+                planner.nn_.insert(newNode);
+            }
 
             if (isGoal)
-                planner.foundGoal(newEdge, goalDist);
+                planner.foundGoal(newEdge, goalDist, Stats::solutionRetries());
 
             // rewire from nearest to farthest (TODO: for PRRT, this
             // should be done in reverse)
@@ -629,8 +753,9 @@ namespace unc::robotics::mpt::impl::prrt_star {
                 
                 if (auto traj = validMotion(newNode->state(), nbrNode->state())) {
                     if constexpr (concurrent) {
-                        setEdge(planner, nbrNode, edges_.allocate(
-                                    linkTrajectory(traj), nbrNode, newEdge, newCost));
+                        Edge *edge = allocateEdge(linkTrajectory(traj), nbrNode, newEdge, newCost);
+                        trajectoryBytes_ += edge->payloadBytes();
+                        setEdge(planner, nbrNode, edge);
                     } else {
                         // we special case the update for
                         // non-concurrent planning (i.e. standard
@@ -638,7 +763,9 @@ namespace unc::robotics::mpt::impl::prrt_star {
                         // existing edges without worry of a
                         // concurrent update.
                         Distance delta = nbrEdge->cost() - newCost;
+                        trajectoryBytes_ -= heapBytes(nbrEdge->link());
                         nbrEdge->setLink(linkTrajectory(traj));
+                        trajectoryBytes_ += heapBytes(nbrEdge->link());
                         nbrEdge->setParent(newEdge);
                         nbrEdge->setCost(newCost);
                         nonConcurrentPushUpdate(planner, nbrEdge, delta);
@@ -649,21 +776,31 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
         decltype(auto) validMotion(const State& a, const State& b) {
             Timer timer(Stats::validMotion());
+            AllocationScope scope(AllocationSite::kTrajectories);
             return scenario_.link(a, b);
         }
 
+        // allocates a (concurrent) edge and adds it to its parent's
+        // child list, recording any contention on the list.
+        template <typename ... Args>
+        Edge* allocateEdge(Args&& ... args) {
+            Edge *edge = edges_.allocate(std::forward<Args>(args)...);
+            Stats::childRetries() += edge->addToParent();
+            return edge;
+        }
+
         void nonConcurrentPushUpdate(Planner& planner, Edge* edge, Distance delta) {
             assert(!concurrent && delta > 0);
             Stats::rewireCount();
             if (edge->node()->goal()) {
                 Edge *prevSolution = planner.solution_;
                 if (edge == prevSolution) {
-                    MPT_LOG(INFO) << "solution improved, new cost "
+                    MPT_LOG_ASYNC(INFO) << "solution improved, new cost "
                         << edge->cost()
                         << ", after " << planner.elapsedSolveTime();
                 } else if (edge->cost() < prevSolution->cost()) {
                     planner.solution_.store(edge);
-                    MPT_LOG(INFO) << "solution changed, new cost "
+                    MPT_LOG_ASYNC(INFO) << "solution changed, new cost "
                         << edge->cost()
                         << ", after " << planner.elapsedSolveTime();
                 }
@@ -679,6 +816,7 @@ namespace unc::robotics::mpt::impl::prrt_star {
         }
 
         void setEdge(Planner& planner, Node* node, Edge* newEdge) {
+            unsigned casFailures = 0;
             Edge *oldEdge = node->edge(std::memory_order_relaxed);
             for (;;) {
                 if (oldEdge && oldEdge->cost() <= newEdge->cost()) {
@@ -691,13 +829,15 @@ namespace unc::robotics::mpt::impl::prrt_star {
                         std::memory_order_release,
                         std::memory_order_relaxed))
                     break;
-                // MPT_LOG(DEBUG, "CAS failed (setEdge)", no_);
+                ++casFailures;
             }
+            Stats::edgeRetries() += casFailures;
 
             if (node->goal()) {
                 // note: prevSolution can be null under concurrency,
                 // the goal node is inserted into the motion graph
                 // before it updates the solution.
+                casFailures = 0;
                 Edge *prevSolution = planner.solution_.load(std::memory_order_acquire);
                 while (prevSolution == nullptr || newEdge->cost() < prevSolution->cost()) {
                     if (planner.solution_.compare_exchange_weak(
@@ -705,18 +845,18 @@ namespace unc::robotics::mpt::impl::prrt_star {
                             std::memory_order_release,
                             std::memory_order_relaxed))
                     {
-                        MPT_LOG(INFO) << (prevSolution == nullptr
-                                          ? "found initial solution with cost "
-                                          : (newEdge->node() == prevSolution->node()
-                                             ? "solution improved, new cost "
-                                             : "solution changed, new cost "))
-                                      << newEdge->cost()
-                                      << ", after " << planner.elapsedSolveTime();
+                        MPT_LOG_ASYNC(INFO) << (prevSolution == nullptr
+                                                ? "found initial solution with cost "
+                                                : (newEdge->node() == prevSolution->node()
+                                                   ? "solution improved, new cost "
+                                                   : "solution changed, new cost "))
+                                            << newEdge->cost()
+                                            << ", after " << planner.elapsedSolveTime();
                         break;
-                    } else {
-                        // MPT_LOG(DEBUG, "[%u]: CAS failed (update solution)", no_);
                     }
+                    ++casFailures;
                 }
+                Stats::solutionRetries() += casFailures;
             }
 
             // at this point, oldEdge is "owned" by this thread,
@@ -730,17 +870,18 @@ namespace unc::robotics::mpt::impl::prrt_star {
 
                 // remove the children from the oldEdge.  Another thread
                 // may still have a reference to it.
+                casFailures = 0;
                 Edge *firstChild = oldEdge->firstChild(std::memory_order_relaxed);
                 while (!oldEdge->casFirstChild(
                            firstChild, nullptr,
                            std::memory_order_release,
-                           std::memory_order_relaxed)) {
-                    // MPT_LOG(DEBUG, "[%u]: CAS failed (firstChild)", no_);
-                }
+                           std::memory_order_relaxed))
+                    ++casFailures;
+                Stats::childRetries() += casFailures;
 
                 for (Edge *oldChild = firstChild ; oldChild ; oldChild = oldChild->nextSibling(std::memory_order_acquire)) {
                     Node *childNode = oldChild->node();
-                    Edge *shorterEdge = edges_.allocate(
+                    Edge *shorterEdge = allocateEdge(
                         *oldChild, childNode, newEdge, oldChild->cost() - costDelta);
                     
                     setEdge(planner, childNode, shorterEdge);
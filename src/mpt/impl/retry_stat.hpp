@@ -0,0 +1,111 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_IMPL_RETRY_STAT_HPP
+#define MPT_IMPL_RETRY_STAT_HPP
+
+#include "../log.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace unc::robotics::mpt::impl {
+    // RetryStat tracks contention on a lock-free update.  Each
+    // completed compare-and-swap loop reports the number of failed
+    // CAS attempts it had to retry before succeeding.  From this we
+    // get the total number of retries, the number of operations they
+    // were spread over, and the longest run of retries a single
+    // operation had to back off through.  A high ratio of retries to
+    // operations indicates that the planner is limited by contention
+    // and not by the nearest neighbor or collision checks.
+    template <bool enable = true>
+    class RetryStat {
+        std::size_t count_{0};
+        std::size_t retries_{0};
+        unsigned maxRetries_{0};
+
+    public:
+        RetryStat& operator += (const RetryStat& other) {
+            count_ += other.count_;
+            retries_ += other.retries_;
+            maxRetries_ = std::max(maxRetries_, other.maxRetries_);
+            return *this;
+        }
+
+        RetryStat& operator += (unsigned retries) {
+            ++count_;
+            retries_ += retries;
+            maxRetries_ = std::max(maxRetries_, retries);
+            return *this;
+        }
+
+        std::size_t count() const {
+            return count_;
+        }
+
+        std::size_t retries() const {
+            return retries_;
+        }
+
+        unsigned maxRetries() const {
+            return maxRetries_;
+        }
+
+        friend decltype(auto) operator << (log::Event& evt, const RetryStat& stat) {
+            return evt << stat.retries() << " retries over "
+                       << stat.count() << " operations (max "
+                       << stat.maxRetries() << ")";
+        }
+    };
+
+    // RetryStat placeholder specialization for when stats are
+    // disabled.  Adding to it is a no-op, and thus the retry counting
+    // in the CAS loops becomes dead code that the compiler removes.
+    template <>
+    class RetryStat<false> {
+    public:
+        static RetryStat<false>& instance() {
+            static RetryStat<false> r;
+            return r;
+        }
+
+        RetryStat& operator += (unsigned) {
+            return *this;
+        }
+    };
+}
+
+#endif
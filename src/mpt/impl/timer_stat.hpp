@@ -38,6 +38,7 @@
 #define MPT_IMPL_TIMER_STAT_HPP
 
 #include "../log.hpp"
+#include <algorithm>
 #include <chrono>
 
 namespace unc::robotics::mpt::impl {
@@ -62,52 +63,129 @@ namespace unc::robotics::mpt::impl {
         return overhead;
     }
     
-    template <typename C = std::chrono::steady_clock>
+    // TimerStat accumulates the time spent in a timed code block.
+    //
+    // With sampleRate = 1 (the default) every call is timed.  Since
+    // each timed call reads the clock twice, this can be significant
+    // for sub-microsecond operations such as nearest neighbor queries.
+    // With sampleRate = N > 1, only 1 in N calls is timed, and the
+    // total is extrapolated from the timed calls.  With sampleRate =
+    // 0, the sampling interval adapts so that the clock overhead
+    // stays near 1% of the time measured.
+    template <typename C = std::chrono::steady_clock, int sampleRate = 1>
     class TimerStat {
+        static_assert(sampleRate >= 0, "sample rate must be non-negative");
+
     public:
         using Clock = C;
         using Duration = typename Clock::duration;
         using TimePoint = typename Clock::time_point;
 
+        static constexpr bool sampled = sampleRate != 1;
+
     private:
+        // upper bound on the adaptive sampling interval, this keeps a
+        // minimum number of samples for the extrapolated total.
+        static constexpr unsigned kMaxAdaptiveInterval = 1024;
+
         Duration elapsed_{};
         unsigned count_{0};
 
+        // only used when sampled.  samples_ is the number of timed
+        // calls (of the count_ calls), countdown_ is the number of
+        // calls to skip before timing the next call.
+        unsigned samples_{0};
+        unsigned countdown_{0};
+        unsigned interval_{sampleRate == 0 ? 1u : unsigned(sampleRate)};
+
+        void adapt() {
+            if constexpr (sampleRate == 0) {
+                // interval = 100 * overhead / average elapsed, which
+                // simplifies to the following, done with the clock's
+                // integer representation to avoid floating point.
+                auto [overhead, calls] = clockOverhead<Clock>();
+                auto num = 100 * overhead.count() * samples_;
+                auto den = elapsed_.count() * calls;
+                interval_ = (den <= 0 || num / den >= kMaxAdaptiveInterval)
+                    ? kMaxAdaptiveInterval
+                    : std::max(unsigned(num / den), 1u);
+            }
+        }
+
     public:
         TimePoint start() const {
             return Clock::now();
         }
 
+        // Called at the start of each timed block, returns true if
+        // the call should be timed.  When it returns false, the call
+        // is counted and should not be added to the stat.
+        bool sample() {
+            if constexpr (!sampled) {
+                return true;
+            } else {
+                if (countdown_) {
+                    --countdown_;
+                    ++count_;
+                    return false;
+                }
+                countdown_ = interval_ - 1;
+                return true;
+            }
+        }
+
         TimerStat& operator += (const TimerStat& other) {
             elapsed_ += other.elapsed_;
             count_ += other.count_;
+            samples_ += other.samples_;
             return *this;
         }
 
         TimerStat& operator += (Duration duration) {
             elapsed_ += duration;
             ++count_;
+            if constexpr (sampled) {
+                ++samples_;
+                adapt();
+            }
             return *this;
         }
 
         TimerStat& operator += (TimePoint& start) {
             TimePoint now = Clock::now();
-            elapsed_ += now - start;
-            ++count_;
+            *this += now - start;
             start = now;
             return *this;
         }
 
+        // Returns the total elapsed time.  When sampling, this is
+        // extrapolated from the sampled calls.  The scale factor is
+        // computed in floating point since elapsed_.count() * count_
+        // can overflow on long runs.
         Duration elapsed() const {
-            return elapsed_;
+            if constexpr (sampled)
+                return samples_
+                    ? Duration(typename Duration::rep(
+                                   elapsed_.count() * (double(count_) / samples_)))
+                    : Duration{};
+            else
+                return elapsed_;
         }
 
         unsigned count() const {
             return count_;
         }
 
+        // Returns the number of calls that were timed.
+        unsigned samples() const {
+            if constexpr (sampled)
+                return samples_;
+            else
+                return count_;
+        }
+
         Duration average() const {
-            return Duration(elapsed_.count() / count_);
+            return Duration(elapsed().count() / count_);
         }
 
         friend decltype(auto) operator << (log::Event& evt, const TimerStat& stat) {
@@ -133,23 +211,33 @@ namespace unc::robotics::mpt::impl {
             //
             // And we argue that the actual time consumed by the
             // measured call is timed duration - 1*overhead.  Whereas
-            // the whole system is slowed down by 2*overhead.
+            // the whole system is slowed down by 2*overhead.  When
+            // sampling, only the timed calls pay the overhead, but
+            // the correction is extrapolated along with the total.
 
-            Duration overhead{stat.count() * clockOverhead<Clock>().first.count()
+            Duration overhead{stat.samples() * clockOverhead<Clock>().first.count()
                 / clockOverhead<Clock>().second};
 
-            Duration elapsed = stat.elapsed() - overhead;
+            if constexpr (sampled) {
+                Duration corrected{overhead.count() * stat.count() / stat.samples()};
+                return evt << (stat.elapsed() - corrected) << " over "
+                           << stat.count() << " calls (sampled "
+                           << stat.samples() << ", overhead "
+                           << (overhead+overhead) << ")";
+            } else {
+                Duration elapsed = stat.elapsed() - overhead;
 
-            return evt << elapsed << " over "
-                       << stat.count() << " calls (overhead "
-                       << (overhead+overhead) << ")";
+                return evt << elapsed << " over "
+                           << stat.count() << " calls (overhead "
+                           << (overhead+overhead) << ")";
+            }
         }
     };
 
     // TimerStat placeholder specialization for when something does
     // not wish to spend time tracking stats.
     template <>
-    class TimerStat<void> {
+    class TimerStat<void, 1> {
     public:
         static TimerStat<void>& instance() {
             static TimerStat<void> t;
@@ -162,21 +250,25 @@ namespace unc::robotics::mpt::impl {
     template <typename Stat>
     class TimerImpl;
 
-    template <typename Clock>
-    class TimerImpl<TimerStat<Clock>> {
-        using Stat = TimerStat<Clock>;
+    template <typename Clock, int sampleRate>
+    class TimerImpl<TimerStat<Clock, sampleRate>> {
+        using Stat = TimerStat<Clock, sampleRate>;
         
         Stat& stat_;
-        typename Clock::time_point start_{Clock::now()};
+        bool timed_;
+        typename Clock::time_point start_;
 
     public:
         TimerImpl(Stat& stat)
             : stat_(stat)
+            , timed_(stat.sample())
+            , start_(timed_ ? Clock::now() : typename Clock::time_point{})
         {
         }
 
         ~TimerImpl() {
-            stat_ += elapsed();
+            if (timed_)
+                stat_ += elapsed();
         }
 
         typename Clock::duration elapsed() const {
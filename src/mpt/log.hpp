@@ -47,6 +47,7 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <string_view>
 #include <thread>
 #include <vector>
 #include <unistd.h>
@@ -190,6 +191,11 @@ namespace unc::robotics::mpt::log::detail {
         //     std::clog.sync_with_stdio(false);
         // }
 
+        inline static LogQueue& instance() {
+            static LogQueue queue;
+            return queue;
+        }
+
         inline bool isTTY() const {
             return isTTY_;
         }
@@ -305,15 +311,24 @@ namespace unc::robotics::mpt::log {
         // impl::NoCopyStringOutputStream<char> msg_;
 
         inline static detail::LogQueue& logQueue() {
-            static detail::LogQueue instance;
-            return instance;
+            return detail::LogQueue::instance();
         }
 
     public:
         template <typename Level>
-        Event(const Level&, const char *file, int line) {
+        Event(const Level& level, const char *file, int line)
+            : Event(level, file, line, std::chrono::system_clock::now(), getThreadName())
+        {
+        }
+
+        // Creates an event with a time and thread name that were
+        // captured earlier, e.g., by an AsyncEvent.
+        template <typename Level>
+        Event(const Level&, const char *file, int line,
+              std::chrono::system_clock::time_point now,
+              std::string_view threadName)
+        {
             using namespace std::chrono;
-            auto now = system_clock::now();
             std::time_t t = system_clock::to_time_t(now);
             auto millis = duration_cast<milliseconds>(
                 now.time_since_epoch()).count() % 1000;
@@ -325,21 +340,21 @@ namespace unc::robotics::mpt::log {
                 // the range [0..15] come from the 4-bit color palette.
                 // Colors in the range [232..255] are grayscale.  We
                 // choose a color in the range [16..231].
-                std::hash<std::string> hasher;
-                std::size_t th = hasher(getThreadName()) % 216 + 16;
+                std::hash<std::string_view> hasher;
+                std::size_t th = hasher(threadName) % 216 + 16;
 
                 msg_ << std::put_time(std::localtime(&t), "%T") << '.'
                      << std::setfill('0') << std::setw(3) << millis << ' '
                      << Level::color()
                      << std::setfill(' ') << std::left << std::setw(5) << Level::name()
-                     << "\33[0m [\33[38;5;" << th << "m" << getThreadName() << "\33[0m] \33[37m("
+                     << "\33[0m [\33[38;5;" << th << "m" << threadName << "\33[0m] \33[37m("
                      << file << ':' << line << ")\33[0m "
                      << Level::color();
             } else {
                 msg_ << std::put_time(std::localtime(&t), "%T") << '.'
                      << std::setfill('0') << std::setw(3) << millis << ' '
                      << std::setfill(' ') << std::left << std::setw(5) << Level::name()
-                     << " [" << getThreadName() << "] ("
+                     << " [" << threadName << "] ("
                      << file << ':' << line << ") ";
             }
         }
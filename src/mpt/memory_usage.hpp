@@ -0,0 +1,180 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_MEMORY_USAGE_HPP
+#define MPT_MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <ostream>
+
+namespace unc::robotics::mpt {
+    // Breakdown of the memory (in bytes) used by a planner, as
+    // returned by the planners' memoryUsage() method.  The values are
+    // estimates based upon object counts and container sizes--they do
+    // not include allocator overhead.
+    //
+    // - nodes: the graph nodes (including the states)
+    // - edges: the graph edges (0 when edges are stored in the nodes)
+    // - components: connected component tracking (PRM-type planners)
+    // - trajectories: heap memory owned by the results of link()
+    // - nearest: the nearest neighbor structure
+    // - scratch: per-worker temporary buffers
+    struct MemoryUsage {
+        std::size_t nodes{0};
+        std::size_t edges{0};
+        std::size_t components{0};
+        std::size_t trajectories{0};
+        std::size_t nearest{0};
+        std::size_t scratch{0};
+
+        std::size_t total() const {
+            return nodes + edges + components + trajectories + nearest + scratch;
+        }
+
+        MemoryUsage& operator += (const MemoryUsage& other) {
+            nodes += other.nodes;
+            edges += other.edges;
+            components += other.components;
+            trajectories += other.trajectories;
+            nearest += other.nearest;
+            scratch += other.scratch;
+            return *this;
+        }
+
+        template <typename Char, typename Traits>
+        friend decltype(auto) operator << (std::basic_ostream<Char, Traits>& out, const MemoryUsage& m) {
+            return out << m.total() << " bytes (nodes " << m.nodes
+                       << ", edges " << m.edges
+                       << ", components " << m.components
+                       << ", trajectories " << m.trajectories
+                       << ", nearest " << m.nearest
+                       << ", scratch " << m.scratch << ")";
+        }
+    };
+
+    // The kinds of heap allocation a planner makes, corresponding to
+    // the fields of MemoryUsage.  MemoryUsage is an estimate; to
+    // measure the actual allocations, compile with
+    // MPT_TRACK_ALLOCATIONS defined.  The planners then set the kind
+    // of the allocations they are about to make in a thread-local
+    // variable, which a replacement operator new can read with
+    // currentAllocationSite() to attribute each allocation (see
+    // demo/memory_benchmark.cpp).  Without MPT_TRACK_ALLOCATIONS, the
+    // tracking compiles to nothing.
+    enum class AllocationSite {
+        kOther, // including per-worker scratch
+        kNodes,
+        kEdges,
+        kComponents,
+        kTrajectories,
+        kNearest,
+    };
+
+    static constexpr int kAllocationSiteCount = 6;
+
+    inline const char* allocationSiteName(AllocationSite site) {
+        switch (site) {
+        case AllocationSite::kNodes: return "nodes";
+        case AllocationSite::kEdges: return "edges";
+        case AllocationSite::kComponents: return "components";
+        case AllocationSite::kTrajectories: return "trajectories";
+        case AllocationSite::kNearest: return "nearest";
+        default: return "other";
+        }
+    }
+
+#ifdef MPT_TRACK_ALLOCATIONS
+    namespace impl {
+        inline thread_local AllocationSite allocationSite = AllocationSite::kOther;
+    }
+
+    inline AllocationSite currentAllocationSite() {
+        return impl::allocationSite;
+    }
+
+    // Sets the current thread's allocation site for the lifetime of
+    // the scope.
+    class AllocationScope {
+        AllocationSite prev_;
+
+    public:
+        explicit AllocationScope(AllocationSite site)
+            : prev_(impl::allocationSite)
+        {
+            impl::allocationSite = site;
+        }
+
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator = (const AllocationScope&) = delete;
+
+        ~AllocationScope() {
+            impl::allocationSite = prev_;
+        }
+    };
+#else
+    inline AllocationSite currentAllocationSite() {
+        return AllocationSite::kOther;
+    }
+
+    class AllocationScope {
+    public:
+        explicit AllocationScope(AllocationSite) {}
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator = (const AllocationScope&) = delete;
+    };
+#endif
+
+    // Returns a done predicate for a planner's solve() method that
+    // stops the solve once the planner's estimated memory usage
+    // reaches the specified number of bytes.  It may be combined with
+    // other conditions, e.g.:
+    //
+    //    auto overBudget = memoryBudget(planner, std::size_t(8) << 30);
+    //    planner.solveFor([&] { return planner.solved() || overBudget(); }, 10s);
+    //
+    // The planners' memoryUsage() method is safe to call while
+    // solving, thus the predicate may be evaluated concurrently with
+    // the other workers.
+    template <typename Planner>
+    auto memoryBudget(const Planner& planner, std::size_t maxBytes) {
+        return [&planner, maxBytes] () -> bool {
+            return planner.memoryUsage().total() >= maxBytes;
+        };
+    }
+}
+
+#endif
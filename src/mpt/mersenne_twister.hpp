@@ -41,6 +41,10 @@
 #include <limits>
 #include <cassert>
 #include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
 
 namespace unc::robotics::mpt {
 
@@ -45,6 +45,15 @@ namespace unc::robotics::mpt {
     template <bool report>
     struct report_stats : std::bool_constant<report> {};
 
+    // when reporting stats, this option times only 1 in N of the
+    // frequently timed calls (e.g., nearest neighbor queries), and
+    // extrapolates the totals.  1 (the default) times every call, and
+    // 0 adapts the rate to keep the clock overhead near 1%.
+    template <int rate>
+    struct stats_sample_rate {
+        static_assert(rate >= 0, "sample rate must be non-negative");
+    };
+
     // For RRT*-type planners, this selects the nearest neighbor
     // strategy to use: k-nearest or radius-based nearest.
     struct rewire_k_nearest {};
@@ -48,7 +48,7 @@ namespace unc::robotics::mpt {
 
     namespace impl {
         // this is the actual strategy type for a PPRM planner
-        template <int maxThreads, bool reportStats, typename NNStrategy>
+        template <int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
         struct PPRMStrategy {};
 
         // Option parser to generate a PPRMStrategy from a
@@ -57,15 +57,17 @@ namespace unc::robotics::mpt {
         struct PPRMOptions {
             static constexpr bool reportStats = pack_bool_tag_v<report_stats, false, Options...>;
             static constexpr int maxThreads = pack_int_tag_v<max_threads, 0, Options...>;
+            static constexpr int statsSampleRate = reportStats
+                ? pack_int_tag_v<stats_sample_rate, 1, Options...> : 1;
 
             using NNStrategy = pack_nearest_t<Options...>;
-            using type = PPRMStrategy<maxThreads, reportStats, NNStrategy>;
+            using type = PPRMStrategy<maxThreads, reportStats, statsSampleRate, NNStrategy>;
         };
 
-        template <typename Scenario, int maxThreads, bool reportStats, typename NNStrategy>
-        struct PlannerResolver<Scenario, impl::PPRMStrategy<maxThreads, reportStats, NNStrategy>> {
+        template <typename Scenario, int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
+        struct PlannerResolver<Scenario, impl::PPRMStrategy<maxThreads, reportStats, statsSampleRate, NNStrategy>> {
             using type = impl::pprm::PPRM<
-                Scenario, maxThreads, reportStats,
+                Scenario, maxThreads, reportStats, statsSampleRate,
                 nearest_strategy_t<Scenario, maxThreads, NNStrategy>>;
         };
     }
@@ -73,6 +75,7 @@ namespace unc::robotics::mpt {
     // Type alias for a PPRM-based planner.  The options supported are:
     // - stats reporting
     //    - tag::report_stats<R>  - Reports stats as it plans, where R is false (default) or true.
+    //    - tag::stats_sample_rate<N> - Times 1 in N calls when reporting stats (default 1, 0 = adaptive)
     // - a nearest neighbor strategy
     //    - nigh::KDTreeBatch<...> - fastest, supports concurrent operation, but does not support arbitrary metrics
     //    - nigh::Linear - slowest, supports concurrent operations, supports arbitrary metrics
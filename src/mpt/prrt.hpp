@@ -48,7 +48,7 @@ namespace unc::robotics::mpt {
 
     namespace impl {
         // this is the actual strategy type for a PRRT planner
-        template <int maxThreads, bool reportStats, typename NNStrategy>
+        template <int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
         struct PRRTStrategy {};
 
         // Option parser to generate a PRRTStrategy from a
@@ -57,16 +57,18 @@ namespace unc::robotics::mpt {
         struct PRRTOptions {
             static constexpr int maxThreads = pack_int_tag_v<max_threads, 0, Options...>;
             static constexpr bool reportStats = pack_bool_tag_v<report_stats, false, Options...>;
+            static constexpr int statsSampleRate = reportStats
+                ? pack_int_tag_v<stats_sample_rate, 1, Options...> : 1;
 
             using NNStrategy = pack_nearest_t<Options...>;
 
-            using type = PRRTStrategy<maxThreads, reportStats, NNStrategy>;
+            using type = PRRTStrategy<maxThreads, reportStats, statsSampleRate, NNStrategy>;
         };
 
-        template <typename Scenario, int maxThreads, bool reportStats, typename NNStrategy>
-        struct PlannerResolver<Scenario, impl::PRRTStrategy<maxThreads, reportStats, NNStrategy>> {
+        template <typename Scenario, int maxThreads, bool reportStats, int statsSampleRate, typename NNStrategy>
+        struct PlannerResolver<Scenario, impl::PRRTStrategy<maxThreads, reportStats, statsSampleRate, NNStrategy>> {
             using type = impl::prrt::PRRT<
-                Scenario, maxThreads, reportStats,
+                Scenario, maxThreads, reportStats, statsSampleRate,
                 nearest_strategy_t<Scenario, maxThreads, NNStrategy>>;
         };
     }
@@ -74,6 +76,7 @@ namespace unc::robotics::mpt {
     // Type alias for a PRRT*-based planner.  The options supported are:
     // - stats reporting
     //    - tag::report_stats<R>  - Reports stats as it plans, where R is false (default) or true.
+    //    - tag::stats_sample_rate<N> - Times 1 in N calls when reporting stats (default 1, 0 = adaptive)
     // - a nearest neighbor strategy
     //    - nigh::KDTreeBatch<...> - fastest, supports concurrent operation, but does not support arbitrary metrics
     //    - nigh::Linear - slowest, supports concurrent operations, supports arbitrary metrics
@@ -48,7 +48,7 @@ namespace unc::robotics::mpt {
 
     namespace impl {
         // this is the actual strategy type for a PRRTStar planner
-        template <int maxThreads, class Rewire, bool reportStats, typename NNStrategy>
+        template <int maxThreads, class Rewire, bool reportStats, int statsSampleRate, typename NNStrategy>
         struct PRRTStarStrategy {};
 
         // Option parser to generate a PRRTStarStrategy from a
@@ -59,6 +59,8 @@ namespace unc::robotics::mpt {
             static constexpr bool kNearest = pack_contains_v<rewire_k_nearest, Options...>;
             static constexpr bool rNearest = pack_contains_v<rewire_r_nearest, Options...>;
             static constexpr bool reportStats = pack_bool_tag_v<report_stats, false, Options...>;
+            static constexpr int statsSampleRate = reportStats
+                ? pack_int_tag_v<stats_sample_rate, 1, Options...> : 1;
 
             static_assert(!(kNearest && rNearest), "RRT* tags cannot include both k_nearest and r_nearest");
 
@@ -68,16 +70,16 @@ namespace unc::robotics::mpt {
 
             using NNStrategy = pack_nearest_t<Options...>;
 
-            using type = PRRTStarStrategy<maxThreads, Rewire, reportStats, NNStrategy>;
+            using type = PRRTStarStrategy<maxThreads, Rewire, reportStats, statsSampleRate, NNStrategy>;
         };
 
-        template <typename Scenario, int maxThreads, class Rewire, bool reportStats, typename NNStrategy>
+        template <typename Scenario, int maxThreads, class Rewire, bool reportStats, int statsSampleRate, typename NNStrategy>
         struct PlannerResolver<
             Scenario,
             impl::PRRTStarStrategy<
-                maxThreads, Rewire, reportStats, NNStrategy>> {
+                maxThreads, Rewire, reportStats, statsSampleRate, NNStrategy>> {
             using type = impl::prrt_star::PRRTStar<
-                Scenario, maxThreads, Rewire, reportStats,
+                Scenario, maxThreads, Rewire, reportStats, statsSampleRate,
                 nearest_strategy_t<Scenario, maxThreads, NNStrategy>>;
         };
     }
@@ -88,6 +90,7 @@ namespace unc::robotics::mpt {
     //    - tag::rewire_r_nearest - Rewiring uses r-nearest variant of RRT*
     // - stats reporting
     //    - tag::report_stats<R>  - Reports stats as it plans, where R is false (default) or true.
+    //    - tag::stats_sample_rate<N> - Times 1 in N calls when reporting stats (default 1, 0 = adaptive)
     // - a nearest neighbor strategy
     //    - nigh::KDTreeBatch<...> - fastest, supports concurrent operation, but does not support arbitrary metrics
     //    - nigh::Linear - slowest, supports concurrent operations, supports arbitrary metrics
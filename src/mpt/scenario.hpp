@@ -106,7 +106,11 @@ namespace unc::robotics::mpt {
         mpt::GoalState<Space> goal_{space_, radius};
 
     public:
-        // Scenario must provide a copy constructor
+        // Scenario must provide a copy constructor.  Planners copy
+        // the scenario once per worker thread.  Heavy scenarios
+        // should keep their data in a ScenarioData member (see
+        // scenario_data.hpp), which shares the immutable part between
+        // the copies and gives each copy its own mutable context.
         const Space& space() const;
 
         template <typename RNG>
@@ -0,0 +1,144 @@
+// Software License Agreement (BSD-3-Clause)
+//
+// Copyright 2018 The University of North Carolina at Chapel Hill
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+// 1. Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above
+//    copyright notice, this list of conditions and the following
+//    disclaimer in the documentation and/or other materials provided
+//    with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+// COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+// INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+// HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+// OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//! @author Jeff Ichnowski
+
+
+#pragma once
+#ifndef MPT_SCENARIO_DATA_HPP
+#define MPT_SCENARIO_DATA_HPP
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace unc::robotics::mpt {
+    // Planners copy the scenario once for each of their workers, so
+    // that each thread has its own scenario to call.  ScenarioData
+    // splits the data of a scenario into two parts to make this copy
+    // cheap:
+    //
+    //   Shared: the immutable part (e.g., meshes, distance fields,
+    //   precomputed bounds) held by a shared pointer, and thus shared
+    //   by every copy of the scenario.
+    //
+    //   Context: the mutable per-thread part (e.g., collision
+    //   objects and requests, forward kinematics buffers).  It is
+    //   never copied.  Instead, each copy of the scenario creates its
+    //   own context from the shared part.  Since the planners copy
+    //   the scenario into their workers in their constructors, each
+    //   worker's context is created once, before any worker thread
+    //   starts.  (A scenario that is not a copy creates its context
+    //   on the first call to context().)  The context is created on
+    //   the heap and is not moved when the scenario is, so it may
+    //   refer to itself and to the shared part.
+    //
+    // A scenario with a ScenarioData member can use the implicit copy
+    // and move constructors.  Context must be constructible from
+    // `const Shared&`, or default constructible.
+    template <typename Shared, typename Context>
+    class ScenarioData {
+        std::shared_ptr<const Shared> shared_;
+        mutable std::unique_ptr<Context> context_;
+
+        std::unique_ptr<Context> createContext() const {
+            if constexpr (std::is_constructible_v<Context, const Shared&>)
+                return std::make_unique<Context>(*shared_);
+            else
+                return std::make_unique<Context>();
+        }
+
+    public:
+        explicit ScenarioData(std::shared_ptr<const Shared> shared)
+            : shared_(std::move(shared))
+        {
+        }
+
+        template <typename ... Args>
+        explicit ScenarioData(std::in_place_t, Args&& ... args)
+            : shared_(std::make_shared<const Shared>(std::forward<Args>(args)...))
+        {
+        }
+
+        ScenarioData(const ScenarioData& other)
+            : shared_(other.shared_)
+            , context_(createContext())
+        {
+        }
+
+        ScenarioData(ScenarioData&&) = default;
+
+        // The assignments destroy the current context before
+        // releasing the shared part it may refer to.
+        ScenarioData& operator = (const ScenarioData& other) {
+            if (this != &other) {
+                context_.reset();
+                shared_ = other.shared_;
+                context_ = createContext();
+            }
+            return *this;
+        }
+
+        ScenarioData& operator = (ScenarioData&& other) {
+            context_ = std::move(other.context_);
+            shared_ = std::move(other.shared_);
+            return *this;
+        }
+
+        const Shared& shared() const {
+            return *shared_;
+        }
+
+        // the shared pointer to the shared part, e.g., to create a
+        // modified copy of it before the scenario is given to a
+        // planner.
+        const std::shared_ptr<const Shared>& sharedPtr() const {
+            return shared_;
+        }
+
+        // The calling copy's context.  Since a copy of the scenario
+        // is only used by one thread at a time, no synchronization is
+        // required.
+        Context& context() const {
+            if (!context_)
+                context_ = createContext();
+            return *context_;
+        }
+
+        bool hasContext() const {
+            return static_cast<bool>(context_);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,115 @@
+#include <mpt/async_log.hpp>
+#include <mpt/impl/thread_pool.hpp>
+#include "test.hpp"
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Redirects std::clog to a string for the lifetime of the object.
+    class CaptureLog {
+        std::ostringstream out_;
+        std::streambuf *prev_;
+    public:
+        CaptureLog() : prev_(std::clog.rdbuf(out_.rdbuf())) {}
+        ~CaptureLog() { std::clog.rdbuf(prev_); }
+        std::string str() const { return out_.str(); }
+    };
+
+    std::size_t countOccurrences(const std::string& str, const std::string& sub) {
+        std::size_t n = 0;
+        for (std::size_t i = 0 ; (i = str.find(sub, i)) != std::string::npos ; i += sub.size())
+            ++n;
+        return n;
+    }
+}
+
+// This must be the first test to log asynchronously, so that the
+// thread pool is constructed before (and thus destroyed after) the
+// logger.  The pool's threads release their buffers as they exit
+// after main returns.
+TEST(async_log_from_thread_pool) {
+    using namespace unc::robotics::mpt;
+    static constexpr int JOBS = 16;
+
+    impl::ThreadPool& pool = impl::ThreadPool::singleton();
+
+    std::string out;
+    {
+        CaptureLog capture;
+        std::atomic_int done{0};
+        for (int i=0 ; i<JOBS ; ++i) {
+            auto job = [i, &done] {
+                MPT_LOG_ASYNC(INFO) << "pool job " << i;
+                ++done;
+            };
+            // a pool of size 1 has no threads of its own
+            if (pool.size() > 1)
+                pool.submit(job);
+            else
+                job();
+        }
+        while (done.load() != JOBS)
+            std::this_thread::yield();
+        log::flushAsync();
+        out = capture.str();
+    }
+
+    EXPECT(countOccurrences(out, "pool job ")) == std::size_t(JOBS);
+}
+
+TEST(async_log_formats_arguments) {
+    using namespace unc::robotics::mpt;
+    using namespace std::literals;
+
+    std::string out;
+    {
+        CaptureLog capture;
+        MPT_LOG_ASYNC(INFO) << "value " << 42 << ' ' << 1.5 << ' ' << std::string("str")
+                            << ' ' << Eigen::Vector3d(1, 2, 3) << ' ' << 250ms;
+        log::flushAsync();
+        out = capture.str();
+    }
+
+    EXPECT(countOccurrences(out, "value 42 1.5 str [1 2 3]^T 0.250 s")) == 1u;
+}
+
+TEST(async_log_truncates_long_messages) {
+    using namespace unc::robotics::mpt;
+
+    std::string out;
+    {
+        CaptureLog capture;
+        MPT_LOG_ASYNC(INFO) << "long " << std::string(1000, 'x') << " tail";
+        log::flushAsync();
+        out = capture.str();
+    }
+
+    EXPECT(countOccurrences(out, "long xxx")) == 1u;
+    EXPECT(countOccurrences(out, "tail")) == 0u;
+    EXPECT(countOccurrences(out, "x...")) == 1u;
+}
+
+TEST(async_log_from_many_threads) {
+    using namespace unc::robotics::mpt;
+    static constexpr int THREADS = 8;
+    static constexpr int MESSAGES = 100;
+
+    std::string out;
+    {
+        CaptureLog capture;
+        std::vector<std::thread> threads;
+        for (int t=0 ; t<THREADS ; ++t)
+            threads.emplace_back([t] {
+                for (int i=0 ; i<MESSAGES ; ++i)
+                    MPT_LOG_ASYNC(INFO) << "thread " << t << " message " << i;
+            });
+        for (auto& t : threads)
+            t.join();
+        log::flushAsync();
+        out = capture.str();
+    }
+
+    EXPECT(countOccurrences(out, " message ")) == std::size_t(THREADS * MESSAGES);
+}
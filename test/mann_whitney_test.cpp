@@ -0,0 +1,94 @@
+#include "../bench/mann_whitney.hpp"
+#include "test.hpp"
+#include <limits>
+
+TEST(mann_whitney_separated) {
+    using namespace mpt_bench;
+
+    std::vector<double> a{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    std::vector<double> b{ 11, 12, 13, 14, 15, 16, 17, 18, 19, 20 };
+
+    MannWhitneyResult r = mannWhitney(a, b);
+    EXPECT(r.u) == 100.0; // every b is greater than every a
+    EXPECT(r.z) > 3.0;
+    EXPECT(r.pGreater) < 0.001;
+    EXPECT(r.pLess) > 0.999;
+
+    // and the reverse
+    r = mannWhitney(b, a);
+    EXPECT(r.u) == 0.0;
+    EXPECT(r.pGreater) > 0.999;
+    EXPECT(r.pLess) < 0.001;
+}
+
+TEST(mann_whitney_identical_samples) {
+    using namespace mpt_bench;
+
+    std::vector<double> a{ 3, 1, 4, 1, 5, 9, 2, 6 };
+
+    MannWhitneyResult r = mannWhitney(a, a);
+    EXPECT(r.u) == 32.0; // n1 * n2 / 2
+    EXPECT(r.z) == 0.0;
+    EXPECT(r.pGreater) > 0.5;
+    EXPECT(r.pLess) > 0.5;
+}
+
+TEST(mann_whitney_ties) {
+    using namespace mpt_bench;
+
+    // sorted: 1a 2a 2a 2b 3a 4b 4b 5b, with the ties getting the
+    // average ranks 3 and 6.5, thus the rank sum of b is 24, and u =
+    // 24 - 4*5/2 = 14.  The tie correction term is (3^3-3) + (2^3-2)
+    // = 30, giving a variance of 16/12 * (9 - 30/56).
+    std::vector<double> a{ 2, 1, 3, 2 };
+    std::vector<double> b{ 4, 2, 5, 4 };
+
+    MannWhitneyResult r = mannWhitney(a, b);
+    EXPECT(r.u) == 14.0;
+    double z = (14.0 - 8.0) / std::sqrt(16.0 / 12.0 * (9.0 - 30.0 / 56.0));
+    EXPECT(std::abs(r.z - z)) < 1e-12;
+    EXPECT(r.pGreater) < r.pLess;
+
+    // when every value is tied there is no evidence either way
+    r = mannWhitney({ 7, 7, 7 }, { 7, 7 });
+    EXPECT(r.u) == 3.0;
+    EXPECT(r.z) == 0.0;
+    EXPECT(r.pGreater) == 1.0;
+    EXPECT(r.pLess) == 1.0;
+}
+
+TEST(mann_whitney_single_values) {
+    using namespace mpt_bench;
+
+    // a single value in each sample is never significant
+    MannWhitneyResult r = mannWhitney({ 1 }, { 2 });
+    EXPECT(r.u) == 1.0;
+    EXPECT(r.pGreater) >= 0.5;
+    EXPECT(r.pLess) >= 0.5;
+
+    r = mannWhitney({ 1 }, { 1 });
+    EXPECT(r.u) == 0.5;
+    EXPECT(r.pGreater) == 1.0;
+    EXPECT(r.pLess) == 1.0;
+
+    r = mannWhitney({}, { 1, 2, 3 });
+    EXPECT(r.u) == 0.0;
+    EXPECT(r.pGreater) == 1.0;
+    EXPECT(r.pLess) == 1.0;
+}
+
+TEST(mann_whitney_infinite) {
+    using namespace mpt_bench;
+
+    // unsolved runs (infinite time) rank above all finite values
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> a{ 1, 2, 3, 4, 5, 6, 7, 8 };
+    std::vector<double> b{ 1, 2, 3, 4, inf, inf, inf, inf };
+
+    MannWhitneyResult r = mannWhitney(a, b);
+    EXPECT(r.u) > 32.0;
+    EXPECT(r.pGreater) < r.pLess;
+
+    EXPECT(median(b)) == inf;
+    EXPECT(median(a)) == 4.5;
+}
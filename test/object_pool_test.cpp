@@ -0,0 +1,33 @@
+#include <mpt/impl/object_pool.hpp>
+#include "test.hpp"
+
+TEST(object_pool_memory_usage) {
+    using namespace unc::robotics::mpt::impl;
+
+    ObjectPool<int> pool;
+    EXPECT(pool.memoryUsage()) == 0u;
+
+    pool.allocate(1);
+    std::size_t oneBlock = pool.memoryUsage();
+    EXPECT(oneBlock > 0) == true;
+
+    pool.clear();
+    EXPECT(pool.memoryUsage()) == 0u;
+
+    ObjectPool<int, false> list;
+    EXPECT(list.memoryUsage()) == 0u;
+    list.allocate(1);
+    EXPECT(list.memoryUsage() > 0) == true;
+}
+
+TEST(memory_counter_update) {
+    using namespace unc::robotics::mpt::impl;
+
+    MemoryCounter counter;
+    counter.update(64);
+    EXPECT(counter.load()) == 64u;
+    counter.update(64);
+    EXPECT(counter.load()) == 64u;
+    counter.update(32);
+    EXPECT(counter.load()) == 32u;
+}
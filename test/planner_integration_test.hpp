@@ -2,10 +2,16 @@
 #include <mpt/lp_space.hpp>
 #include <mpt/box_bounds.hpp>
 #include <mpt/goal_state.hpp>
+#include <mpt/memory_usage.hpp>
+#include <mpt/progress.hpp>
 #include <mpt/planner.hpp>
 #include "test.hpp"
+#include <chrono>
+#include <cstdint>
 #include <fstream> // TODO: <-- remove
 #include <optional>
+#include <random>
+#include <thread>
 
 namespace mpt_test {
     template <typename Pt, typename S0, typename S1>
@@ -252,6 +258,11 @@ namespace mpt_test {
             EXPECT(*sit++ == a) == true;
         });
         EXPECT(sit == solution.end()) == true;
+
+        MemoryUsage usage = planner.memoryUsage();
+        EXPECT(usage.nodes) > 0;
+        EXPECT(usage.nearest) > 0;
+        EXPECT(usage.total()) >= usage.nodes + usage.nearest;
         
         // the following block outputs an svg file with the graph from
         // the plan.
@@ -396,6 +407,141 @@ namespace mpt_test {
         
         EXPECT(prev == Scenario::goalState()) == true;
 
+        // every edge in the graph holds a shared trajectory
+        EXPECT(planner.memoryUsage().trajectories) > 0;
+    }
+
+    template <typename Algorithm>
+    void testSolvingWithMemoryBudget() {
+        using Scalar = double;
+        static constexpr int dim = 3;
+        using namespace unc::robotics;
+        using namespace mpt;
+        using namespace mpt_test;
+        using namespace std::literals;
+        using Scenario = BasicScenario<TEST_GOAL_KIND_CLASS, Scalar, dim>;
+        static constexpr std::size_t MAX_BYTES = 256*1024;
+        static constexpr auto MAX_SOLVE_TIME = 10s;
+
+        Planner<Scenario, Algorithm> planner;
+        planner.addStart(Scenario::startState());
+
+        // run past the solution until the budget is exhausted.
+        auto start = std::chrono::steady_clock::now();
+        planner.solveFor(memoryBudget(planner, MAX_BYTES), MAX_SOLVE_TIME);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        planner.printStats();
+
+        EXPECT(elapsed < MAX_SOLVE_TIME) == true;
+        EXPECT(planner.memoryUsage().total()) >= MAX_BYTES;
+    }
+
+
+    template <typename Algorithm>
+    void testProgressCallback() {
+        using Scalar = double;
+        static constexpr int dim = 3;
+        using namespace unc::robotics;
+        using namespace mpt;
+        using namespace mpt_test;
+        using namespace std::literals;
+        using Scenario = BasicScenario<TEST_GOAL_KIND_CLASS, Scalar, dim>;
+        static constexpr auto MAX_SOLVE_TIME = 10s;
+
+        Planner<Scenario, Algorithm> planner;
+        planner.addStart(Scenario::startState());
+
+        // the progress callback stops the solve once there is a
+        // solution, the done predicate never does.
+        std::size_t reports = 0;
+        Progress<Scalar> last;
+        std::thread::id callerId = std::this_thread::get_id();
+        bool sameThread = true;
+        planner.setProgressCallback([&] (const Progress<Scalar>& progress) {
+            ++reports;
+            last = progress;
+            sameThread &= std::this_thread::get_id() == callerId;
+            return progress.bestCost < std::numeric_limits<Scalar>::infinity();
+        }, 1ms);
+
+        planner.solveFor([] { return false; }, MAX_SOLVE_TIME);
+
+        EXPECT(planner.solved()) == true;
+        EXPECT(reports) > 0u;
+        EXPECT(sameThread) == true;
+        EXPECT(last.size) > 0u;
+        EXPECT(last.iterations) > 0u;
+        EXPECT(last.elapsed < MAX_SOLVE_TIME) == true;
+        EXPECT(last.bestCost < std::numeric_limits<Scalar>::infinity()) == true;
+    }
+
+    template <typename Algorithm>
+    void testWorkerStats() {
+        using namespace unc::robotics;
+        using namespace mpt;
+        using namespace mpt_test;
+        using Scenario = BasicScenario<>;
+
+        Planner<Scenario, Algorithm> planner;
+        planner.addStart(Scenario::startState());
+        planner.solve([&] { return planner.solved(); });
+
+        // every iteration runs at least one nearest neighbor search,
+        // so each phase should have been timed at least once.
+        auto stats = planner.stats();
+        EXPECT(stats.iterations()) > 0u;
+        unsigned phases = 0;
+        stats.visitTimers([&] (const char *, const auto& timer) {
+            ++phases;
+            EXPECT(timer.count()) > 0u;
+        });
+        EXPECT(phases) > 0u;
+    }
+
+    // A deterministic seed sequence, since std::seed_seq cannot be
+    // used through the const reference the planners take.
+    struct FixedSeed {
+        using result_type = std::uint32_t;
+        std::uint32_t seed_;
+
+        template <class RandomIt>
+        void generate(RandomIt begin, RandomIt end) const {
+            std::seed_seq seq{seed_};
+            seq.generate(begin, end);
+        }
+
+        std::size_t size() const {
+            return 1;
+        }
+    };
+
+    template <typename Algorithm>
+    void testReset() {
+        using namespace unc::robotics;
+        using namespace mpt;
+        using namespace mpt_test;
+        using Scenario = BasicScenario<>;
+
+        auto run = [] (auto& planner) {
+            std::size_t iterations = 0;
+            planner.addStart(Scenario::startState());
+            planner.solve([&] { return ++iterations > 2000; });
+            return planner.size();
+        };
+
+        Planner<Scenario, Algorithm> fresh(Scenario(), FixedSeed{1});
+        std::size_t expected = run(fresh);
+
+        // a planner reset with the same seed should repeat the run
+        // of a newly constructed planner.
+        Planner<Scenario, Algorithm> planner(Scenario(), FixedSeed{2});
+        run(planner);
+        planner.reset(FixedSeed{1});
+        EXPECT(planner.size()) == 0u;
+        EXPECT(planner.solved()) == false;
+        EXPECT(planner.solution().size()) == 0u;
+        EXPECT(run(planner)) == expected;
+        EXPECT(planner.solved()) == fresh.solved();
     }
 
 }
@@ -16,6 +16,11 @@ TEST(pprm_until_solved_with_stats) {
     testSolvingBasicScenario<PPRM<report_stats<true>>>();
 }
 
+TEST(pprm_until_solved_with_sampled_stats) {
+    testSolvingBasicScenario<PPRM<report_stats<true>, stats_sample_rate<16>>>();
+    testSolvingBasicScenario<PPRM<report_stats<true>, stats_sample_rate<0>>>();
+}
+
 TEST(pprm_until_solved_single_threaded) {
     testSolvingBasicScenario<PPRM<single_threaded>>();
 }
@@ -45,3 +50,10 @@ TEST(pprm_with_shared_trajectory) {
     testSolvingSharedTrajectoryScenario<PPRM<>>();
 }
 
+TEST(pprm_with_memory_budget) {
+    testSolvingWithMemoryBudget<PPRM<>>();
+}
+
+TEST(pprm_worker_stats) {
+    testWorkerStats<PPRM<report_stats<true>>>();
+}
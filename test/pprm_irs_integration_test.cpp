@@ -45,3 +45,7 @@ TEST(pprm_irs_with_shared_trajectory) {
     testSolvingSharedTrajectoryScenario<PPRMIRS<>>();
 }
 #endif
+
+TEST(pprm_irs_with_memory_budget) {
+    testSolvingWithMemoryBudget<PPRMIRS<>>();
+}
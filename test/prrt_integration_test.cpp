@@ -20,6 +20,11 @@ TEST(prrt_until_solved_with_stats) {
     testSolvingBasicScenario<PRRT<report_stats<true>>>();
 }
 
+TEST(prrt_until_solved_with_sampled_stats) {
+    testSolvingBasicScenario<PRRT<report_stats<true>, stats_sample_rate<16>>>();
+    testSolvingBasicScenario<PRRT<report_stats<true>, stats_sample_rate<0>>>();
+}
+
 TEST(prrt_until_solved_single_threaded) {
     testSolvingBasicScenario<PRRT<single_threaded>>();
 }
@@ -48,3 +53,19 @@ TEST(prrt_with_trajectory) {
 TEST(prrt_with_shared_trajectory) {
     testSolvingSharedTrajectoryScenario<PRRT<>>();
 }
+
+TEST(prrt_with_memory_budget) {
+    testSolvingWithMemoryBudget<PRRT<>>();
+}
+
+TEST(prrt_progress_callback) {
+    testProgressCallback<PRRT<>>();
+}
+
+TEST(prrt_worker_stats) {
+    testWorkerStats<PRRT<report_stats<true>>>();
+}
+
+TEST(prrt_reset) {
+    testReset<PRRT<single_threaded>>();
+}
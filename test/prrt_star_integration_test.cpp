@@ -20,6 +20,11 @@ TEST(prrt_star_until_solved_with_stats) {
     testSolvingBasicScenario<PRRTStar<report_stats<true>>>();
 }
 
+TEST(prrt_star_until_solved_with_sampled_stats) {
+    testSolvingBasicScenario<PRRTStar<report_stats<true>, stats_sample_rate<16>>>();
+    testSolvingBasicScenario<PRRTStar<report_stats<true>, stats_sample_rate<0>>>();
+}
+
 TEST(prrt_star_until_solved_single_threaded) {
     testSolvingBasicScenario<PRRTStar<single_threaded>>();
 }
@@ -63,3 +68,19 @@ TEST(prrt_star_with_trajectory) {
 TEST(prrt_star_with_shared_trajectory) {
     testSolvingSharedTrajectoryScenario<PRRTStar<>>();
 }
+
+TEST(prrt_star_with_memory_budget) {
+    testSolvingWithMemoryBudget<PRRTStar<>>();
+}
+
+TEST(prrt_star_progress_callback) {
+    testProgressCallback<PRRTStar<>>();
+}
+
+TEST(prrt_star_worker_stats) {
+    testWorkerStats<PRRTStar<report_stats<true>>>();
+}
+
+TEST(prrt_star_reset) {
+    testReset<PRRTStar<single_threaded>>();
+}
@@ -0,0 +1,31 @@
+#include <mpt/impl/retry_stat.hpp>
+#include "test.hpp"
+
+TEST(retry_stat_accumulate) {
+    using namespace unc::robotics::mpt::impl;
+
+    RetryStat<> a;
+    a += 0u;
+    a += 3u;
+    a += 1u;
+
+    EXPECT(a.count()) == 3u;
+    EXPECT(a.retries()) == 4u;
+    EXPECT(a.maxRetries()) == 3u;
+
+    RetryStat<> b;
+    b += 5u;
+
+    a += b;
+    EXPECT(a.count()) == 4u;
+    EXPECT(a.retries()) == 9u;
+    EXPECT(a.maxRetries()) == 5u;
+}
+
+TEST(retry_stat_disabled) {
+    using namespace unc::robotics::mpt::impl;
+
+    // the disabled stat carries no state
+    RetryStat<false>::instance() += 10u;
+    EXPECT(std::is_empty_v<RetryStat<false>>) == true;
+}
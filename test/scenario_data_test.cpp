@@ -0,0 +1,92 @@
+#include <mpt/scenario_data.hpp>
+#include "test.hpp"
+#include <vector>
+
+namespace {
+    using unc::robotics::mpt::ScenarioData;
+
+    struct TestShared {
+        std::vector<int> data;
+
+        explicit TestShared(int n) : data(n, 1) {}
+    };
+
+    struct TestContext {
+        static int created;
+
+        const TestShared& shared;
+        int calls{0};
+
+        explicit TestContext(const TestShared& s) : shared(s) { ++created; }
+        TestContext(const TestContext&) = delete;
+    };
+
+    int TestContext::created = 0;
+
+    class TestScenario {
+        ScenarioData<TestShared, TestContext> data_;
+
+    public:
+        explicit TestScenario(int n) : data_(std::in_place, n) {}
+
+        bool valid(int) const {
+            ++data_.context().calls;
+            return true;
+        }
+
+        const auto& data() const {
+            return data_;
+        }
+    };
+}
+
+TEST(scenario_data_copies_share) {
+    TestScenario a(1000);
+    TestScenario b(a);
+    TestScenario c(2);
+    c = b;
+
+    EXPECT(&a.data().shared() == &b.data().shared()) == true;
+    EXPECT(&a.data().shared() == &c.data().shared()) == true;
+    EXPECT(a.data().sharedPtr().use_count()) == 3;
+}
+
+TEST(scenario_data_context_per_copy) {
+    TestContext::created = 0;
+
+    // the original creates its context on first use
+    TestScenario a(10);
+    EXPECT(a.data().hasContext()) == false;
+    a.valid(0);
+    EXPECT(TestContext::created) == 1;
+
+    // copies create their own context, but do not copy it
+    TestScenario b(a);
+    EXPECT(TestContext::created) == 2;
+    b.valid(1);
+    b.valid(2);
+    EXPECT(TestContext::created) == 2;
+    EXPECT(a.data().context().calls) == 1;
+    EXPECT(b.data().context().calls) == 2;
+    EXPECT(&b.data().context() == &a.data().context()) == false;
+    EXPECT(&b.data().context().shared == &a.data().shared()) == true;
+
+    // moves keep the context
+    TestContext *ctx = &b.data().context();
+    TestScenario c(std::move(b));
+    EXPECT(&c.data().context() == ctx) == true;
+    EXPECT(TestContext::created) == 2;
+
+    // assignment replaces the context
+    c = a;
+    EXPECT(TestContext::created) == 3;
+    EXPECT(c.data().context().calls) == 0;
+}
+
+TEST(scenario_data_default_context) {
+    ScenarioData<TestShared, std::vector<double>> data(std::make_shared<const TestShared>(3));
+    data.context().push_back(1.0);
+    ScenarioData<TestShared, std::vector<double>> copy(data);
+    EXPECT(copy.context().size()) == 0u;
+    EXPECT(data.context().size()) == 1u;
+}
@@ -0,0 +1,72 @@
+#include <mpt/impl/timer_stat.hpp>
+#include "test.hpp"
+
+TEST(timer_stat_every_call) {
+    using namespace unc::robotics::mpt::impl;
+    using namespace std::literals;
+
+    TimerStat<> stat;
+    for (int i=0 ; i<10 ; ++i)
+        if (stat.sample())
+            stat += 1ms;
+
+    EXPECT(stat.count()) == 10u;
+    EXPECT(stat.samples()) == 10u;
+    EXPECT(stat.elapsed() == 10ms) == true;
+}
+
+TEST(timer_stat_sampled) {
+    using namespace unc::robotics::mpt::impl;
+    using namespace std::literals;
+
+    TimerStat<std::chrono::steady_clock, 4> stat;
+    for (int i=0 ; i<20 ; ++i)
+        if (stat.sample())
+            stat += 1ms;
+
+    EXPECT(stat.count()) == 20u;
+    EXPECT(stat.samples()) == 5u;
+
+    // the total is extrapolated from the sampled calls
+    EXPECT(stat.elapsed() == 20ms) == true;
+    EXPECT(stat.average() == 1ms) == true;
+}
+
+TEST(timer_stat_adaptive) {
+    using namespace unc::robotics::mpt::impl;
+    using namespace std::literals;
+
+    // calls that are much faster than the clock overhead should
+    // quickly back off to sampling at the maximum interval, whereas
+    // slow calls should be timed every time.
+    TimerStat<std::chrono::steady_clock, 0> fast;
+    TimerStat<std::chrono::steady_clock, 0> slow;
+    for (int i=0 ; i<10000 ; ++i) {
+        if (fast.sample())
+            fast += std::chrono::steady_clock::duration{0};
+        if (slow.sample())
+            slow += 1s;
+    }
+
+    EXPECT(fast.count()) == 10000u;
+    EXPECT(fast.samples()) < 100u;
+    EXPECT(slow.count()) == 10000u;
+    EXPECT(slow.samples()) == 10000u;
+}
+
+TEST(timer_stat_sampled_long_run) {
+    using namespace unc::robotics::mpt::impl;
+    using namespace std::literals;
+
+    // elapsed nanoseconds times the call count does not fit in 64
+    // bits, the extrapolated total still does.
+    TimerStat<std::chrono::steady_clock, 1000> stat;
+    for (int i=0 ; i<4000000 ; ++i)
+        if (stat.sample())
+            stat += 1min;
+
+    EXPECT(stat.count()) == 4000000u;
+    EXPECT(stat.samples()) == 4000u;
+    EXPECT(stat.elapsed() == 4000000min) == true;
+    EXPECT(stat.average() == 1min) == true;
+}